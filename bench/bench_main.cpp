@@ -0,0 +1,270 @@
+//
+// Created on 2025/4/2.
+//
+
+#define TEST_HELPER_QUIET
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "simple_refl.h"
+#include "bench_helper.h"
+#include "example/json_parser.h"
+
+BENCH_HELPER_DEFINE_ALLOCATION_HOOKS()
+
+namespace bench {
+    class Body {
+    public:
+        double mass = 1.0;
+
+        [[nodiscard]] double get_mass() const {
+            return mass;
+        }
+    };
+
+    class Particle : public Body {
+    public:
+        int id = 0;
+        double x = 0;
+        double y = 0;
+        std::string label;
+
+        int add(const int value) {
+            id += value;
+            return id;
+        }
+
+        [[nodiscard]] double norm() const {
+            return x * x + y * y;
+        }
+    };
+
+    static auto& body_refl = simple_reflection::make_reflection<Body>()
+            .register_member<&Body::mass>("mass")
+            .register_method<&Body::get_mass>("get_mass");
+
+    static auto& particle_refl = simple_reflection::make_reflection<Particle>()
+            .derives_from<Body>()
+            .register_member<&Particle::id>("id")
+            .register_member<&Particle::x>("x")
+            .register_member<&Particle::y>("y")
+            .register_member<&Particle::label>("label")
+            .register_method<&Particle::add>("add")
+            .register_method<&Particle::norm>("norm")
+            .register_function<Particle>("ctor", []() { return Particle(); });
+
+    class Record {
+    public:
+        int id = 0;
+        std::string name;
+        double score = 0;
+        bool active = false;
+    };
+
+    static auto& record_refl = simple_reflection::make_reflection<Record>()
+            .register_member<&Record::id>("id")
+            .register_member<&Record::name>("name")
+            .register_member<&Record::score>("score")
+            .register_member<&Record::active>("active")
+            .register_function<Record>("ctor", []() { return Record(); });
+
+    define_json_vector(Record);
+
+    class Payload {
+    public:
+        std::string title;
+        json_mapper::JsonVector<int> checksums;
+        json_mapper::JsonVector<Record> records;
+    };
+
+    static auto& payload_refl = simple_reflection::make_reflection<Payload>()
+            .register_member<&Payload::title>("title")
+            .register_member<&Payload::checksums>("checksums")
+            .register_member<&Payload::records>("records")
+            .register_function<Payload>("ctor", []() { return Payload(); });
+
+    inline Payload make_payload(const size_t record_count) {
+        Payload payload;
+        payload.title = "payload of " + std::to_string(record_count);
+        for (size_t i = 0; i < record_count; ++i) {
+            Record record;
+            record.id = static_cast<int>(i);
+            record.name = "record-" + std::to_string(i);
+            record.score = static_cast<double>(i) * 0.5;
+            record.active = i % 2 == 0;
+            payload.checksums.push_back(static_cast<int>(i * 31));
+            payload.records.push_back(std::move(record));
+        }
+        return payload;
+    }
+
+    inline std::string dump_to_string(Payload& payload) {
+        std::ostringstream os;
+        json_parser::print_object(json_mapper::dump_json_object(payload), os);
+        return os.str();
+    }
+
+    inline void run_invocation_benchmarks(bench_helper::Harness& harness) {
+        Particle particle;
+        harness.run("invoke_method/typed", [&]() {
+            bench_helper::do_not_optimize(particle_refl.invoke_method<int>(&particle, "add", 1));
+        });
+        harness.run("invoke_method/typed_const", [&]() {
+            bench_helper::do_not_optimize(particle_refl.invoke_method<double>(&particle, "norm"));
+        });
+        harness.run("invoke_method/arg_list", [&]() {
+            auto result = particle_refl.invoke_method(&particle, "add", make_args(1));
+            bench_helper::do_not_optimize(result);
+        });
+        harness.run("invoke_function/ctor", [&]() {
+            auto instance = particle_refl.invoke_function("ctor");
+            bench_helper::do_not_optimize(instance);
+        });
+
+        // a command stream of 1024 calls over 64 objects.
+        std::vector<Particle> particles(64);
+        const auto add = particle_refl.resolve_method<int>("add");
+        harness.run("invoke_method/stream=1024", [&]() {
+            for (size_t i = 0; i < 1024; ++i) {
+                auto result = particle_refl.invoke_method(&particles[i % particles.size()], "add", make_args(1));
+                bench_helper::do_not_optimize(result);
+            }
+        });
+        simple_reflection::InvocationBatch batch;
+        for (size_t i = 0; i < 1024; ++i) {
+            batch.add(&particles[i % particles.size()], add, 1);
+        }
+        harness.run("invocation_batch/stream=1024", [&]() {
+            batch.run();
+            bench_helper::do_not_optimize(batch.results());
+        });
+        harness.run("invocation_batch/pool/stream=1024", [&]() {
+            batch.run(simple_reflection::ThreadPool::shared());
+            bench_helper::do_not_optimize(batch.results());
+        });
+    }
+
+    inline void run_member_benchmarks(bench_helper::Harness& harness) {
+        Particle particle;
+        harness.run("get_member_ref", [&]() {
+            bench_helper::do_not_optimize(particle_refl.get_member_ref<double>(&particle, "x"));
+        });
+        harness.run("set_member/wrapped", [&]() {
+            double value = 2.0;
+            bench_helper::do_not_optimize(
+                particle_refl.set_member(&particle, "y", simple_reflection::wrap_object(value)));
+        });
+        harness.run("set_member/string", [&]() {
+            std::string value = "particle";
+            bench_helper::do_not_optimize(
+                particle_refl.set_member(&particle, "label", simple_reflection::wrap_object(value)));
+        });
+    }
+
+    inline void run_base_class_benchmarks(bench_helper::Harness& harness) {
+        Particle particle;
+        harness.run("base/get_member_ref", [&]() {
+            bench_helper::do_not_optimize(particle_refl.get_member_ref<double>(&particle, "mass"));
+        });
+        harness.run("base/invoke_method", [&]() {
+            bench_helper::do_not_optimize(particle_refl.invoke_method<double>(&particle, "get_mass"));
+        });
+        harness.run("registry/by_type_index", [&]() {
+            bench_helper::do_not_optimize(simple_reflection::try_get_reflection(typeid(Particle)));
+        });
+        harness.run("registry/by_name", [&]() {
+            bench_helper::do_not_optimize(
+                simple_reflection::ReflectionRegistryBase::instance().try_get_reflection("bench::Particle"));
+        });
+        harness.run("registry/get_member_list", [&]() {
+            bench_helper::do_not_optimize(particle_refl.get_member_list());
+        });
+        harness.run("registry/get_callable_map", [&]() {
+            bench_helper::do_not_optimize(particle_refl.get_callable_map());
+        });
+    }
+
+    template <typename... ClassTypes>
+    void register_cold(simple_reflection::ReflectionRegistryBase& registry) {
+        (bench_helper::do_not_optimize(registry.register_base<ClassTypes>().get_type_parsed()), ...);
+    }
+
+    // the startup of a process, i.e. the registrations into an empty registry.
+    inline void run_cold_start_benchmarks(bench_helper::Harness& harness) {
+        harness.run("registry/cold_start", [&]() {
+            simple_reflection::ReflectionRegistryBase registry;
+            register_cold<Body, Particle, Record, Payload>(registry);
+        });
+    }
+
+    inline void run_value_benchmarks(bench_helper::Harness& harness) {
+        auto payload = make_payload(16);
+        auto other = make_payload(16);
+        harness.run("value/equals/records=16", [&]() {
+            bench_helper::do_not_optimize(payload_refl.equals(&payload, &other));
+        });
+        harness.run("value/hash/records=16", [&]() {
+            bench_helper::do_not_optimize(payload_refl.hash(&payload));
+        });
+        harness.run("value/clone_into/records=16", [&]() {
+            payload_refl.clone_into(&payload, &other);
+            bench_helper::do_not_optimize(other);
+        });
+        harness.run("value/json_equals/records=16", [&]() {
+            bench_helper::do_not_optimize(dump_to_string(payload) == dump_to_string(other));
+        });
+    }
+
+    inline void run_json_benchmarks(bench_helper::Harness& harness) {
+        for (const size_t record_count: {1, 16, 256}) {
+            auto payload = make_payload(record_count);
+            const auto json = dump_to_string(payload);
+            const auto suffix = "/records=" + std::to_string(record_count);
+
+            harness.run("json/dump_json_object" + suffix, [&]() {
+                auto dumped = json_mapper::dump_json_object(payload);
+                bench_helper::do_not_optimize(dumped);
+            });
+            harness.run("json/to_json" + suffix, [&]() {
+                auto written = json_mapper::to_json(payload);
+                bench_helper::do_not_optimize(written);
+            });
+            harness.run("json/from_json" + suffix, [&]() {
+                auto parsed = json_mapper::from_json<Payload>(json);
+                bench_helper::do_not_optimize(parsed);
+            });
+            harness.run("json/round_trip" + suffix, [&]() {
+                auto parsed = json_mapper::from_json<Payload>(dump_to_string(payload));
+                bench_helper::do_not_optimize(parsed);
+            });
+        }
+
+        // a top-level array, parsed on the calling thread and then on the shared pool.
+        auto records = make_payload(4096).records;
+        std::ostringstream os;
+        json_parser::print_object(json_mapper::dump_json_object(records), os);
+        const auto array_json = os.str();
+        harness.run("json/from_json/array=4096", [&]() {
+            auto parsed = json_mapper::from_json<json_mapper::JsonVector<Record>>(array_json);
+            bench_helper::do_not_optimize(parsed);
+        });
+        harness.run("json/from_json_batch/array=4096", [&]() {
+            auto parsed = json_mapper::from_json_batch<json_mapper::JsonVector<Record>>(array_json);
+            bench_helper::do_not_optimize(parsed);
+        });
+    }
+}
+
+int main(const int argc, char** argv) {
+    bench_helper::Harness harness(bench_helper::parse_options(argc, argv));
+    bench::run_invocation_benchmarks(harness);
+    bench::run_member_benchmarks(harness);
+    bench::run_base_class_benchmarks(harness);
+    bench::run_cold_start_benchmarks(harness);
+    bench::run_value_benchmarks(harness);
+    bench::run_json_benchmarks(harness);
+    harness.report(std::cout);
+    return 0;
+}
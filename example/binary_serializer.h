@@ -0,0 +1,784 @@
+//
+// Created on 2025/3/29.
+//
+
+#ifndef BINARY_SERIALIZER_H
+#define BINARY_SERIALIZER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include <simple_refl.h>
+#include <test_helper.h>
+
+/**
+ * A compact binary format, whose schema is derived from the registered members.
+ * @note A message is the 64-bit fingerprint of the schema, followed by the fields in the order of their offsets.
+ * @note Integers are zigzag varints, floating points are raw bytes, and strings are length-prefixed.
+ * @note Trivially copyable classes whose arithmetic members cover the whole layout are copied as one block.
+ * @note std::string_view fields are decoded without a copy, aliasing the input buffer,
+ * @note which has to outlive the decoded object.
+ * @note The raw encodings assume that both ends share the same endianness and floating point format.
+ */
+namespace binary_serializer {
+    class Writer {
+        std::string m_buffer;
+
+    public:
+        void reserve(const size_t size) {
+            m_buffer.reserve(size);
+        }
+
+        void put_varint(uint64_t value) {
+            while (value >= 0x80) {
+                m_buffer.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            m_buffer.push_back(static_cast<char>(value));
+        }
+
+        void put_signed(const int64_t value) {
+            put_varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        void put_bytes(const void* data, const size_t size) {
+            m_buffer.append(static_cast<const char *>(data), size);
+        }
+
+        template <typename ValueType>
+        void put_fixed(const ValueType& value) {
+            put_bytes(&value, sizeof(ValueType));
+        }
+
+        void put_string(const std::string_view str) {
+            put_varint(str.size());
+            put_bytes(str.data(), str.size());
+        }
+
+        [[nodiscard]] const std::string& buffer() const noexcept {
+            return m_buffer;
+        }
+
+        std::string take() noexcept {
+            return std::move(m_buffer);
+        }
+    };
+
+    class Reader {
+        const char* m_it;
+        const char* m_end;
+
+    public:
+        explicit Reader(const std::string_view input) : m_it(input.data()), m_end(input.data() + input.size()) {
+        }
+
+        uint64_t get_varint() {
+            uint64_t value = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7) {
+                if (m_it == m_end) {
+                    throw std::runtime_error("binary: truncated varint");
+                }
+                const auto byte = static_cast<unsigned char>(*m_it++);
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+            throw std::runtime_error("binary: varint too long");
+        }
+
+        int64_t get_signed() {
+            const uint64_t value = get_varint();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        /**
+         * Read raw bytes, without copying them.
+         * @return The view of the bytes, which aliases the input.
+         */
+        std::string_view get_bytes(const size_t size) {
+            if (static_cast<size_t>(m_end - m_it) < size) {
+                throw std::runtime_error("binary: truncated input");
+            }
+            const std::string_view bytes(m_it, size);
+            m_it += size;
+            return bytes;
+        }
+
+        template <typename ValueType>
+        ValueType get_fixed() {
+            ValueType value;
+            std::memcpy(&value, get_bytes(sizeof(ValueType)).data(), sizeof(ValueType));
+            return value;
+        }
+
+        std::string_view get_string() {
+            return get_bytes(get_varint());
+        }
+
+        [[nodiscard]] bool at_end() const noexcept {
+            return m_it == m_end;
+        }
+
+        [[nodiscard]] size_t remaining() const noexcept {
+            return static_cast<size_t>(m_end - m_it);
+        }
+    };
+
+    /**
+     * The type-erased encoder and decoder of a field type.
+     * @note The decoder assigns to an already constructed value.
+     */
+    struct TypeOps {
+        void (*encode)(Writer&, const void*) = nullptr;
+        void (*decode)(Reader&, void*) = nullptr;
+        // whether the value can be copied as raw bytes as part of a bulk-copied class.
+        bool raw = false;
+    };
+
+    struct Schema;
+
+    namespace _internal {
+        template <typename T>
+        struct is_vector : std::false_type {
+        };
+
+        template <typename T>
+        struct is_vector<std::vector<T>> : std::true_type {
+        };
+
+        inline uint64_t fnv1a(uint64_t hash, const std::string_view bytes) {
+            for (const char c: bytes) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+        inline uint64_t fnv1a(const uint64_t hash, const uint64_t value) {
+            return fnv1a(hash, std::string_view(reinterpret_cast<const char *>(&value), sizeof(value)));
+        }
+
+        /**
+         * The codecs of the field types, and the schemas of the reflected classes.
+         * @note Codecs are expected to be registered during startup, before any encoding happens.
+         */
+        class Registry {
+            std::shared_mutex m_mutex;
+            std::unordered_map<std::type_index, TypeOps> m_codecs;
+            std::unordered_map<const simple_reflection::ReflectionBase*, std::shared_ptr<const Schema>> m_schemas;
+
+        public:
+            static Registry& instance() {
+                static Registry registry;
+                return registry;
+            }
+
+            Registry();
+
+            void add_codec(const std::type_index type, const TypeOps ops) {
+                std::unique_lock lock(m_mutex);
+                m_codecs[type] = ops;
+                m_schemas.clear();
+            }
+
+            std::shared_ptr<const Schema> schema(const simple_reflection::ReflectionBase& reflection);
+
+        private:
+            std::shared_ptr<const Schema> _build(const simple_reflection::ReflectionBase& reflection);
+        };
+    }
+
+    struct FieldPlan {
+        std::string_view name;
+        size_t offset;
+        std::type_index type;
+        // exactly one of these is set.
+        const TypeOps* ops;
+        std::shared_ptr<const Schema> nested;
+        // the bit of the field in a DirtySet.
+        uint32_t table_index;
+    };
+
+    /**
+     * The encoding plan of a reflected class, built once per class (and again after new registrations).
+     */
+    struct Schema {
+        size_t epoch = 0;
+        uint64_t fingerprint = 0;
+        // the size of the class if it's copied as one block, or 0.
+        size_t bulk_size = 0;
+        std::vector<FieldPlan> fields;
+    };
+
+    void encode_object(Writer& writer, const void* object, const simple_reflection::ReflectionBase& reflection);
+
+    void decode_object(Reader& reader, void* object, const simple_reflection::ReflectionBase& reflection);
+
+    /**
+     * Encode a value whose type is known at compile time.
+     */
+    template <typename ValueType>
+    void encode_value(Writer& writer, const ValueType& value) {
+        if constexpr (std::is_same_v<ValueType, bool>) {
+            writer.put_fixed(static_cast<uint8_t>(value));
+        } else if constexpr (std::is_integral_v<ValueType> && std::is_signed_v<ValueType>) {
+            writer.put_signed(value);
+        } else if constexpr (std::is_integral_v<ValueType>) {
+            writer.put_varint(value);
+        } else if constexpr (std::is_floating_point_v<ValueType>) {
+            writer.put_fixed(value);
+        } else if constexpr (std::is_same_v<ValueType, std::string> || std::is_same_v<ValueType, std::string_view>) {
+            writer.put_string(value);
+        } else if constexpr (_internal::is_vector<ValueType>::value) {
+            using ElemType = typename ValueType::value_type;
+            writer.put_varint(value.size());
+            if constexpr (std::is_floating_point_v<ElemType>) {
+                writer.put_bytes(value.data(), value.size() * sizeof(ElemType));
+            } else {
+                for (const auto& elem: value) {
+                    encode_value(writer, elem);
+                }
+            }
+        } else {
+            encode_object(writer, &value, simple_reflection::get_reflection(typeid(ValueType)));
+        }
+    }
+
+    /**
+     * Decode a value whose type is known at compile time, assigning it to the target.
+     */
+    template <typename ValueType>
+    void decode_value(Reader& reader, ValueType& value) {
+        if constexpr (std::is_same_v<ValueType, bool>) {
+            // any other byte than 0 or 1 would be undefined behaviour in a bool.
+            const auto byte = reader.get_fixed<uint8_t>();
+            if (byte > 1) {
+                throw std::runtime_error("binary: invalid bool");
+            }
+            value = byte != 0;
+        } else if constexpr (std::is_integral_v<ValueType> && std::is_signed_v<ValueType>) {
+            value = static_cast<ValueType>(reader.get_signed());
+        } else if constexpr (std::is_integral_v<ValueType>) {
+            value = static_cast<ValueType>(reader.get_varint());
+        } else if constexpr (std::is_floating_point_v<ValueType>) {
+            value = reader.get_fixed<ValueType>();
+        } else if constexpr (std::is_same_v<ValueType, std::string> || std::is_same_v<ValueType, std::string_view>) {
+            value = ValueType(reader.get_string());
+        } else if constexpr (_internal::is_vector<ValueType>::value) {
+            using ElemType = typename ValueType::value_type;
+            // the size is untrusted, and checked against the input before anything gets allocated.
+            const auto size = reader.get_varint();
+            if constexpr (std::is_floating_point_v<ElemType>) {
+                if (size > reader.remaining() / sizeof(ElemType)) {
+                    throw std::runtime_error("binary: truncated input");
+                }
+                const auto bytes = reader.get_bytes(static_cast<size_t>(size) * sizeof(ElemType));
+                value.resize(size);
+                std::memcpy(value.data(), bytes.data(), bytes.size());
+            } else {
+                // every element takes at least one byte.
+                if (size > reader.remaining()) {
+                    throw std::runtime_error("binary: truncated input");
+                }
+                value.clear();
+                value.resize(static_cast<size_t>(size));
+                for (auto& elem: value) {
+                    decode_value(reader, elem);
+                }
+            }
+        } else {
+            decode_object(reader, &value, simple_reflection::get_reflection(typeid(ValueType)));
+        }
+    }
+
+    template <typename ValueType>
+    TypeOps make_type_ops() {
+        return {
+            [](Writer& writer, const void* value) {
+                encode_value(writer, *static_cast<const ValueType *>(value));
+            },
+            [](Reader& reader, void* value) {
+                decode_value(reader, *static_cast<ValueType *>(value));
+            },
+            // bools are checked when decoded, so they are never copied as raw bytes.
+            std::is_arithmetic_v<ValueType> && !std::is_same_v<ValueType, bool>
+        };
+    }
+
+    /**
+     * Make a field type encodable, e.g. std::vector<MyRecord>.
+     * @note The integral, floating point, string and string_view types are registered by default,
+     * @note and reflected classes need no registration.
+     */
+    template <typename ValueType>
+    void register_codec() {
+        _internal::Registry::instance().add_codec(typeid(ValueType), make_type_ops<ValueType>());
+    }
+
+    inline _internal::Registry::Registry() {
+        const auto add = [this](const std::type_index type, const TypeOps ops) {
+            m_codecs.emplace(type, ops);
+        };
+        add(typeid(bool), make_type_ops<bool>());
+        add(typeid(char), make_type_ops<char>());
+        add(typeid(int8_t), make_type_ops<int8_t>());
+        add(typeid(uint8_t), make_type_ops<uint8_t>());
+        add(typeid(int16_t), make_type_ops<int16_t>());
+        add(typeid(uint16_t), make_type_ops<uint16_t>());
+        add(typeid(int32_t), make_type_ops<int32_t>());
+        add(typeid(uint32_t), make_type_ops<uint32_t>());
+        add(typeid(long), make_type_ops<long>());
+        add(typeid(unsigned long), make_type_ops<unsigned long>());
+        add(typeid(long long), make_type_ops<long long>());
+        add(typeid(unsigned long long), make_type_ops<unsigned long long>());
+        add(typeid(float), make_type_ops<float>());
+        add(typeid(double), make_type_ops<double>());
+        add(typeid(std::string), make_type_ops<std::string>());
+        add(typeid(std::string_view), make_type_ops<std::string_view>());
+    }
+
+    inline std::shared_ptr<const Schema> _internal::Registry::schema(
+        const simple_reflection::ReflectionBase& reflection) {
+        const size_t epoch = simple_reflection::registration_epoch().load(std::memory_order_acquire);
+        {
+            std::shared_lock lock(m_mutex);
+            if (const auto find = m_schemas.find(&reflection);
+                find != m_schemas.end() && find->second->epoch == epoch) {
+                return find->second;
+            }
+        }
+        // the nested schemas are built (and locked) one at a time, before this one is.
+        auto schema = _build(reflection);
+        std::unique_lock lock(m_mutex);
+        m_schemas[&reflection] = schema;
+        return schema;
+    }
+
+    inline std::shared_ptr<const Schema> _internal::Registry::_build(
+        const simple_reflection::ReflectionBase& reflection) {
+        // the classes whose schemas are being built by this thread, from the outermost one.
+        thread_local std::vector<const simple_reflection::ReflectionBase*> building;
+        if (std::find(building.begin(), building.end(), &reflection) != building.end()) {
+            throw std::runtime_error("binary: " + reflection.get_type_string() + " contains itself");
+        }
+        building.push_back(&reflection);
+        struct Unwind {
+            ~Unwind() {
+                building.pop_back();
+            }
+        } unwind;
+
+        auto schema = std::make_shared<Schema>();
+        schema->epoch = simple_reflection::registration_epoch().load(std::memory_order_acquire);
+
+        size_t covered = 0;
+        bool raw = reflection.get_layout().trivially_copyable;
+        reflection.for_each_member([&](const std::string& name, const simple_reflection::Member& member) {
+            FieldPlan plan{name, member.offset, member.type_info, nullptr, nullptr, member.table_index};
+            {
+                std::shared_lock lock(m_mutex);
+                if (const auto find = m_codecs.find(member.type_info); find != m_codecs.end()) {
+                    plan.ops = &find->second;
+                }
+            }
+            if (plan.ops == nullptr) {
+                const auto nested = simple_reflection::try_get_reflection(member.type_info);
+                if (nested == nullptr) {
+                    throw std::runtime_error("binary: no codec for member " + name + " of " +
+                                             reflection.get_type_string());
+                }
+                plan.nested = this->schema(*nested);
+                raw = raw && plan.nested->bulk_size != 0;
+            } else {
+                raw = raw && plan.ops->raw;
+            }
+            covered += member.size;
+            schema->fields.push_back(plan);
+        });
+        std::sort(schema->fields.begin(), schema->fields.end(), [](const FieldPlan& lhs, const FieldPlan& rhs) {
+            return lhs.offset < rhs.offset;
+        });
+        // with no padding and no uncovered bytes, the registered members are the whole object.
+        if (raw && covered == reflection.get_layout().size) {
+            schema->bulk_size = covered;
+        }
+
+        uint64_t fingerprint = _internal::fnv1a(0xcbf29ce484222325ull, reflection.get_type_string());
+        fingerprint = _internal::fnv1a(fingerprint, schema->bulk_size);
+        for (const auto& field: schema->fields) {
+            fingerprint = _internal::fnv1a(fingerprint, field.name);
+            fingerprint = _internal::fnv1a(fingerprint, field.type.name());
+            if (schema->bulk_size != 0) {
+                fingerprint = _internal::fnv1a(fingerprint, field.offset);
+            }
+            if (field.nested != nullptr) {
+                fingerprint = _internal::fnv1a(fingerprint, field.nested->fingerprint);
+            }
+        }
+        schema->fingerprint = fingerprint;
+        return schema;
+    }
+
+    void _encode_field(Writer& writer, const void* object, const FieldPlan& field);
+
+    void _decode_field(Reader& reader, void* object, const FieldPlan& field);
+
+    inline void _encode(Writer& writer, const void* object, const Schema& schema) {
+        if (schema.bulk_size != 0) {
+            writer.put_bytes(object, schema.bulk_size);
+            return;
+        }
+        for (const auto& field: schema.fields) {
+            _encode_field(writer, object, field);
+        }
+    }
+
+    inline void _decode(Reader& reader, void* object, const Schema& schema) {
+        if (schema.bulk_size != 0) {
+            std::memcpy(object, reader.get_bytes(schema.bulk_size).data(), schema.bulk_size);
+            return;
+        }
+        for (const auto& field: schema.fields) {
+            _decode_field(reader, object, field);
+        }
+    }
+
+    inline void _encode_field(Writer& writer, const void* object, const FieldPlan& field) {
+        const void* value = static_cast<const char *>(object) + field.offset;
+        if (field.ops != nullptr) {
+            field.ops->encode(writer, value);
+        } else {
+            _encode(writer, value, *field.nested);
+        }
+    }
+
+    inline void _decode_field(Reader& reader, void* object, const FieldPlan& field) {
+        void* value = static_cast<char *>(object) + field.offset;
+        if (field.ops != nullptr) {
+            field.ops->decode(reader, value);
+        } else {
+            _decode(reader, value, *field.nested);
+        }
+    }
+
+    inline void encode_object(Writer& writer, const void* object, const simple_reflection::ReflectionBase& reflection) {
+        _encode(writer, object, *_internal::Registry::instance().schema(reflection));
+    }
+
+    inline void decode_object(Reader& reader, void* object, const simple_reflection::ReflectionBase& reflection) {
+        _decode(reader, object, *_internal::Registry::instance().schema(reflection));
+    }
+
+    /**
+     * Get the fingerprint of the schema of a reflected class.
+     * @note Two ends can exchange messages only if the fingerprints match.
+     */
+    inline uint64_t fingerprint(const simple_reflection::ReflectionBase& reflection) {
+        return _internal::Registry::instance().schema(reflection)->fingerprint;
+    }
+
+    /**
+     * Serialize an object.
+     * @exception reflection_registry_not_found_exception If the type is not registered.
+     * @exception std::runtime_error If a member has neither a codec nor a reflection.
+     */
+    template <typename Serializable>
+    std::string encode(const Serializable& object) {
+        const auto& reflection = simple_reflection::get_reflection(typeid(Serializable));
+        const auto schema = _internal::Registry::instance().schema(reflection);
+        Writer writer;
+        writer.reserve(sizeof(uint64_t) + (schema->bulk_size != 0 ? schema->bulk_size : sizeof(Serializable)));
+        writer.put_fixed(schema->fingerprint);
+        _encode(writer, &object, *schema);
+        return writer.take();
+    }
+
+    /**
+     * Deserialize into an existing object.
+     * @note std::string_view members alias the input, which has to outlive the object.
+     * @exception std::runtime_error If the input is truncated, or was encoded with another schema.
+     */
+    template <typename Serializable>
+    void decode(const std::string_view input, Serializable& object) {
+        const auto& reflection = simple_reflection::get_reflection(typeid(Serializable));
+        const auto schema = _internal::Registry::instance().schema(reflection);
+        Reader reader(input);
+        if (reader.get_fixed<uint64_t>() != schema->fingerprint) {
+            throw std::runtime_error("binary: schema fingerprint mismatch");
+        }
+        _decode(reader, &object, *schema);
+        if (!reader.at_end()) {
+            throw std::runtime_error("binary: trailing bytes");
+        }
+    }
+
+    /**
+     * Serialize only the members written since the changes of the object were last cleared.
+     * @note A delta is the fingerprint, the number of fields, then the position and the value of each field.
+     * @note Changed nested objects are encoded as a whole. The changes are cleared unless told otherwise.
+     * @exception std::runtime_error If the type doesn't track its changes, see ReflectionBase::track_changes.
+     */
+    template <typename Serializable>
+    std::string encode_delta(Serializable& object, const bool clear_changes = true) {
+        const auto& reflection = simple_reflection::get_reflection(typeid(Serializable));
+        const auto dirty = reflection.get_dirty_set(&object);
+        if (dirty == nullptr) {
+            throw std::runtime_error("binary: " + reflection.get_type_string() + " doesn't track changes");
+        }
+        const auto schema = _internal::Registry::instance().schema(reflection);
+        std::vector<size_t> positions;
+        for (size_t i = 0; i < schema->fields.size(); ++i) {
+            if (dirty->contains(schema->fields[i].table_index)) {
+                positions.push_back(i);
+            }
+        }
+        Writer writer;
+        writer.put_fixed(schema->fingerprint);
+        writer.put_varint(positions.size());
+        for (const auto position: positions) {
+            writer.put_varint(position);
+            _encode_field(writer, &object, schema->fields[position]);
+        }
+        if (clear_changes) {
+            dirty->clear();
+        }
+        return writer.take();
+    }
+
+    /**
+     * Merge a delta made by encode_delta into an object, keeping the fields which are not in it.
+     * @note The writes are not recorded in the DirtySet of the object.
+     * @exception std::runtime_error If the input is truncated or malformed, or was encoded with another schema.
+     */
+    template <typename Serializable>
+    void apply_delta(const std::string_view input, Serializable& object) {
+        const auto& reflection = simple_reflection::get_reflection(typeid(Serializable));
+        const auto schema = _internal::Registry::instance().schema(reflection);
+        Reader reader(input);
+        if (reader.get_fixed<uint64_t>() != schema->fingerprint) {
+            throw std::runtime_error("binary: schema fingerprint mismatch");
+        }
+        const auto count = reader.get_varint();
+        for (uint64_t i = 0; i < count; ++i) {
+            const auto position = reader.get_varint();
+            if (position >= schema->fields.size()) {
+                throw std::runtime_error("binary: invalid field in delta");
+            }
+            _decode_field(reader, &object, schema->fields[position]);
+        }
+        if (!reader.at_end()) {
+            throw std::runtime_error("binary: trailing bytes");
+        }
+    }
+}
+
+namespace binary_serializer_test {
+    struct Point {
+        float x = 0;
+        float y = 0;
+    };
+
+    class Record {
+    public:
+        int id = 0;
+        int64_t delta = 0;
+        double score = 0;
+        bool active = false;
+        std::string name;
+        std::string_view tag;
+        Point origin;
+        std::vector<double> samples;
+        std::vector<Point> path;
+    };
+
+    static auto& point_refl = simple_reflection::make_reflection<Point>()
+            .register_member<&Point::x>("x")
+            .register_member<&Point::y>("y");
+
+    static auto& record_refl = simple_reflection::make_reflection<Record>()
+            .register_member<&Record::id>("id")
+            .register_member<&Record::delta>("delta")
+            .register_member<&Record::score>("score")
+            .register_member<&Record::active>("active")
+            .register_member<&Record::name>("name")
+            .register_member<&Record::tag>("tag")
+            .register_member<&Record::origin>("origin")
+            .register_member<&Record::samples>("samples")
+            .register_member<&Record::path>("path");
+
+    inline void test_binary_round_trip() {
+        binary_serializer::register_codec<std::vector<double>>();
+        binary_serializer::register_codec<std::vector<Point>>();
+
+        Record record;
+        record.id = 42;
+        record.delta = -7;
+        record.score = 0.5;
+        record.active = true;
+        record.name = "binary";
+        record.tag = "zero-copy";
+        record.origin = {1.5f, -2.5f};
+        record.samples = {1.0, 2.0, 3.0};
+        record.path = {{1, 2}, {3, 4}};
+
+        const auto bytes = binary_serializer::encode(record);
+        test_helper::dbg_print("binary record size: ", bytes.size(), " bytes");
+
+        Record decoded;
+        binary_serializer::decode(bytes, decoded);
+        assert(decoded.id == 42 && decoded.delta == -7 && decoded.score == 0.5 && decoded.active);
+        assert(decoded.name == "binary" && decoded.tag == "zero-copy");
+        assert(decoded.origin.x == 1.5f && decoded.origin.y == -2.5f);
+        assert(decoded.samples == record.samples && decoded.path.size() == 2 && decoded.path[1].y == 4);
+
+        // the string_view aliases the encoded bytes.
+        assert(decoded.tag.data() >= bytes.data() && decoded.tag.data() < bytes.data() + bytes.size());
+
+        // Point is trivially copyable and fully covered by its members, so it is copied as one block.
+        const auto point_bytes = binary_serializer::encode(record.origin);
+        assert(point_bytes.size() == sizeof(uint64_t) + sizeof(Point));
+
+        bool thrown = false;
+        try {
+            Point point;
+            binary_serializer::decode(bytes, point);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        thrown = false;
+        try {
+            binary_serializer::decode(std::string_view(bytes.data(), bytes.size() - 1), decoded);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        // the sizes of vectors are checked against the input before allocating.
+        for (const uint64_t size: {uint64_t(1) << 40, ~uint64_t(0) / sizeof(double) + 2}) {
+            binary_serializer::Writer writer;
+            writer.put_varint(size);
+            writer.put_fixed(1.0);
+            thrown = false;
+            try {
+                binary_serializer::Reader reader(writer.buffer());
+                std::vector<double> samples;
+                binary_serializer::decode_value(reader, samples);
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            assert(thrown);
+            thrown = false;
+            try {
+                binary_serializer::Reader reader(writer.buffer());
+                std::vector<Point> path;
+                binary_serializer::decode_value(reader, path);
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+    }
+
+    struct Switch {
+        bool on = false;
+        bool ready = false;
+    };
+
+    static auto& switch_refl = simple_reflection::make_reflection<Switch>()
+            .register_member<&Switch::on>("on")
+            .register_member<&Switch::ready>("ready");
+
+    inline void test_binary_bool() {
+        Switch decoded;
+        auto bytes = binary_serializer::encode(Switch{true, false});
+        binary_serializer::decode(bytes, decoded);
+        assert(decoded.on && !decoded.ready);
+
+        // a byte other than 0 or 1 is rejected, even in a class which could be copied as a whole.
+        bytes.back() = 2;
+        bool thrown = false;
+        try {
+            binary_serializer::decode(bytes, decoded);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    struct Node {
+        int value = 0;
+    };
+
+    struct Holder {
+        Node node;
+    };
+
+    // a member registered on the wrong class makes the schema of Node contain itself.
+    static auto& node_refl = simple_reflection::make_reflection<Node>()
+            .register_member<&Node::value>("value")
+            .register_member<&Holder::node>("self");
+
+    inline void test_binary_cycle() {
+        bool thrown = false;
+        try {
+            std::ignore = binary_serializer::encode(Node());
+        } catch (const std::runtime_error& e) {
+            thrown = std::string(e.what()).find("contains itself") != std::string::npos;
+        }
+        assert(thrown);
+    }
+
+    class Tracked {
+    public:
+        int id = 0;
+        std::string name;
+        Point origin;
+        simple_reflection::DirtySet changes;
+    };
+
+    static auto& tracked_refl = simple_reflection::make_reflection<Tracked>()
+            .register_member<&Tracked::id>("id")
+            .register_member<&Tracked::name>("name")
+            .register_member<&Tracked::origin>("origin")
+            .track_changes<&Tracked::changes>();
+
+    inline void test_binary_delta() {
+        Tracked tracked;
+        tracked.name = std::string(256, 'x');
+        Tracked replica = tracked;
+
+        const auto origin = tracked_refl.resolve_member<Point>("origin");
+        origin.set(&tracked, Point{1, 2});
+        const auto delta = binary_serializer::encode_delta(tracked);
+        assert(!tracked.changes.any());
+        // the fingerprint, the count, the position and the point.
+        assert(delta.size() == sizeof(uint64_t) + 2 + sizeof(Point));
+
+        binary_serializer::apply_delta(delta, replica);
+        assert(replica.origin.x == 1 && replica.origin.y == 2 && replica.name == tracked.name);
+
+        bool thrown = false;
+        try {
+            Record record;
+            binary_serializer::encode_delta(record);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
+#endif //BINARY_SERIALIZER_H
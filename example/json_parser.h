@@ -5,12 +5,32 @@
 #ifndef JSON_PARSER_H
 #define JSON_PARSER_H
 
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
 #include <variant>
 #include <vector>
 #include <unordered_map>
 #include <iostream>
 #include <stack>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(JSON_PARSER_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#elif !defined(JSON_PARSER_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#elif !defined(JSON_PARSER_NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
 
 #include <simple_refl.h>
 #include <test_helper.h>
@@ -19,8 +39,77 @@ namespace json_parser {
     struct JsonObject;
 
     using JsonArray = std::vector<JsonObject>;
+
+    /**
+     * The fields of a JSON object, in hash order.
+     * @note This is what the parser and dump_json_object produce, see JsonOrderedMap for a deterministic order.
+     */
     using JsonMap = std::unordered_map<std::string, JsonObject>;
 
+    /**
+     * The fields of a JSON object, in the order they were inserted, e.g. by dump_json_ordered.
+     * @note Lookups are linear, which beats hashing for the few fields objects usually have.
+     * @note Two maps are equal if they have the same fields, whatever their order.
+     */
+    class JsonOrderedMap {
+    public:
+        using value_type = std::pair<std::string, JsonObject>;
+        using iterator = std::vector<value_type>::iterator;
+        using const_iterator = std::vector<value_type>::const_iterator;
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_entries.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return m_entries.empty();
+        }
+
+        iterator begin() noexcept {
+            return m_entries.begin();
+        }
+
+        iterator end() noexcept {
+            return m_entries.end();
+        }
+
+        [[nodiscard]] const_iterator begin() const noexcept {
+            return m_entries.begin();
+        }
+
+        [[nodiscard]] const_iterator end() const noexcept {
+            return m_entries.end();
+        }
+
+        iterator find(std::string_view key);
+        [[nodiscard]] const_iterator find(std::string_view key) const;
+
+        /**
+         * Get the field of the key, throws std::out_of_range if there's none.
+         */
+        [[nodiscard]] const JsonObject& at(std::string_view key) const;
+
+        /**
+         * Get the field of the key, appending an empty one if there's none.
+         * @note A key assigned twice keeps the position of its first assignment.
+         */
+        JsonObject& operator[](std::string key);
+
+        /**
+         * Append the field if the key isn't there yet.
+         */
+        std::pair<iterator, bool> emplace(std::string key, JsonObject value);
+
+        bool operator==(const JsonOrderedMap& rhs) const;
+
+        bool operator!=(const JsonOrderedMap& rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        std::vector<value_type> m_entries;
+    };
+
     struct JsonObject {
         std::variant<
             std::monostate,
@@ -29,7 +118,8 @@ namespace json_parser {
             double,
             bool,
             JsonArray,
-            JsonMap
+            JsonMap,
+            JsonOrderedMap
         > value;
 
         bool operator==(const JsonObject& rhs) const {
@@ -41,6 +131,51 @@ namespace json_parser {
         }
     };
 
+    inline JsonOrderedMap::iterator JsonOrderedMap::find(const std::string_view key) {
+        return std::find_if(m_entries.begin(), m_entries.end(), [key](const value_type& entry) {
+            return entry.first == key;
+        });
+    }
+
+    inline JsonOrderedMap::const_iterator JsonOrderedMap::find(const std::string_view key) const {
+        return std::find_if(m_entries.begin(), m_entries.end(), [key](const value_type& entry) {
+            return entry.first == key;
+        });
+    }
+
+    inline const JsonObject& JsonOrderedMap::at(const std::string_view key) const {
+        const auto found = find(key);
+        if (found == m_entries.end()) {
+            throw std::out_of_range("no json field " + std::string(key));
+        }
+        return found->second;
+    }
+
+    inline JsonObject& JsonOrderedMap::operator[](std::string key) {
+        if (const auto found = find(key); found != m_entries.end()) {
+            return found->second;
+        }
+        return m_entries.emplace_back(std::move(key), JsonObject()).second;
+    }
+
+    inline std::pair<JsonOrderedMap::iterator, bool> JsonOrderedMap::emplace(std::string key, JsonObject value) {
+        if (const auto found = find(key); found != m_entries.end()) {
+            return {found, false};
+        }
+        m_entries.emplace_back(std::move(key), std::move(value));
+        return {std::prev(m_entries.end()), true};
+    }
+
+    inline bool JsonOrderedMap::operator==(const JsonOrderedMap& rhs) const {
+        if (size() != rhs.size()) {
+            return false;
+        }
+        return std::all_of(m_entries.begin(), m_entries.end(), [&rhs](const value_type& entry) {
+            const auto found = rhs.find(entry.first);
+            return found != rhs.end() && found->second == entry.second;
+        });
+    }
+
     namespace _internal {
         inline bool is_escape_char(char c) {
             return c == '\\' || c == '\"' || c == '\'' || c == '\b' || c == '\f' || c == '\n' || c == '\r' || c == '\t';
@@ -109,55 +244,367 @@ namespace json_parser {
             return result;
         }
 
-        inline void skip_empty(std::string::const_iterator& it) {
-            while (is_empty_char(*it)) {
-                ++it;
-            }
+        inline bool bracket_match(char left, char right) {
+            return (left == '[' && right == ']') || (left == '{' && right == '}');
         }
 
-        inline void to_nearest_colon(std::string::const_iterator& it) {
-            while (*it != ':') {
-                ++it;
+        /**
+         * Decode a \\uXXXX escape sequence into UTF-8.
+         * @param it Points at the 'u', and is moved past the sequence.
+         * @return False if the sequence is malformed.
+         */
+        inline bool append_unicode_escape(const char*& it, const char* end, std::string& target) {
+            unsigned code = 0;
+            if (end - it < 5 || std::from_chars(it + 1, it + 5, code, 16).ptr != it + 5) {
+                return false;
             }
-            ++it;
+            it += 5;
+            if (code < 0x80) {
+                target.push_back(static_cast<char>(code));
+            } else if (code < 0x800) {
+                target.push_back(static_cast<char>(0xc0 | code >> 6));
+                target.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+            } else {
+                target.push_back(static_cast<char>(0xe0 | code >> 12));
+                target.push_back(static_cast<char>(0x80 | (code >> 6 & 0x3f)));
+                target.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+            }
+            return true;
         }
 
-        inline bool is_left_bracket(char c) {
-            return c == '[' || c == '{' || c == '(';
+        /**
+         * The scanning kernels of the tokenizer, which classify 64 bytes at a time.
+         * @note The instruction set is picked at compile time: AVX2, SSE2, NEON (AArch64), or a scalar fallback.
+         * @note Define JSON_PARSER_NO_SIMD to force the scalar fallback.
+         */
+        namespace simd {
+            constexpr size_t block_size = 64;
+
+#if !defined(JSON_PARSER_NO_SIMD) && defined(__AVX2__)
+            constexpr const char* kernel_name = "avx2";
+
+            class Block {
+                __m256i m_lo;
+                __m256i m_hi;
+
+            public:
+                explicit Block(const char* data)
+                    : m_lo(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data))),
+                      m_hi(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + 32))) {
+                }
+
+                [[nodiscard]] uint64_t eq(const char c) const {
+                    const __m256i value = _mm256_set1_epi8(c);
+                    const auto lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(m_lo, value)));
+                    const auto hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(m_hi, value)));
+                    return lo | static_cast<uint64_t>(hi) << 32;
+                }
+            };
+#elif !defined(JSON_PARSER_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+            constexpr const char* kernel_name = "sse2";
+
+            class Block {
+                __m128i m_chunks[4];
+
+            public:
+                explicit Block(const char* data) : m_chunks{
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32)),
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 48))
+                } {
+                }
+
+                [[nodiscard]] uint64_t eq(const char c) const {
+                    const __m128i value = _mm_set1_epi8(c);
+                    uint64_t mask = 0;
+                    for (size_t i = 0; i < 4; ++i) {
+                        const auto bits = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(m_chunks[i], value)));
+                        mask |= static_cast<uint64_t>(bits) << (16 * i);
+                    }
+                    return mask;
+                }
+            };
+#elif !defined(JSON_PARSER_NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+            constexpr const char* kernel_name = "neon";
+
+            class Block {
+                uint8x16_t m_chunks[4];
+
+            public:
+                explicit Block(const char* data) : m_chunks{
+                    vld1q_u8(reinterpret_cast<const uint8_t *>(data)),
+                    vld1q_u8(reinterpret_cast<const uint8_t *>(data + 16)),
+                    vld1q_u8(reinterpret_cast<const uint8_t *>(data + 32)),
+                    vld1q_u8(reinterpret_cast<const uint8_t *>(data + 48))
+                } {
+                }
+
+                [[nodiscard]] uint64_t eq(const char c) const {
+                    static constexpr uint8_t weights[16] = {
+                        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+                        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80
+                    };
+                    const uint8x16_t weight = vld1q_u8(weights);
+                    const uint8x16_t value = vdupq_n_u8(static_cast<uint8_t>(c));
+                    uint8x16_t t0 = vandq_u8(vceqq_u8(m_chunks[0], value), weight);
+                    uint8x16_t t1 = vandq_u8(vceqq_u8(m_chunks[1], value), weight);
+                    uint8x16_t t2 = vandq_u8(vceqq_u8(m_chunks[2], value), weight);
+                    uint8x16_t t3 = vandq_u8(vceqq_u8(m_chunks[3], value), weight);
+                    uint8x16_t sum = vpaddq_u8(vpaddq_u8(t0, t1), vpaddq_u8(t2, t3));
+                    sum = vpaddq_u8(sum, sum);
+                    return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+                }
+            };
+#else
+            constexpr const char* kernel_name = "scalar";
+
+            class Block {
+                const char* m_data;
+
+            public:
+                explicit Block(const char* data) : m_data(data) {
+                }
+
+                [[nodiscard]] uint64_t eq(const char c) const {
+                    uint64_t mask = 0;
+                    for (size_t i = 0; i < block_size; ++i) {
+                        mask |= static_cast<uint64_t>(m_data[i] == c) << i;
+                    }
+                    return mask;
+                }
+            };
+#endif
+
+            inline unsigned trailing_zeros(const uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+                unsigned long index;
+                _BitScanForward64(&index, mask);
+                return static_cast<unsigned>(index);
+#else
+                return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+            }
+
+            /**
+             * Set every bit between an opening quote (inclusive) and its closing quote (exclusive).
+             */
+            inline uint64_t prefix_xor(uint64_t mask) {
+                mask ^= mask << 1;
+                mask ^= mask << 2;
+                mask ^= mask << 4;
+                mask ^= mask << 8;
+                mask ^= mask << 16;
+                mask ^= mask << 32;
+                return mask;
+            }
+
+            /**
+             * Find the characters escaped by a backslash.
+             * @param backslash The mask of backslashes.
+             * @param carry Whether the first character is escaped by the previous block, updated for the next one.
+             */
+            inline uint64_t escaped_mask(uint64_t backslash, uint64_t& carry) {
+                uint64_t escaped = carry;
+                carry = 0;
+                while (backslash != 0) {
+                    const unsigned i = trailing_zeros(backslash);
+                    backslash &= backslash - 1;
+                    if (escaped >> i & 1) {
+                        continue;
+                    }
+                    if (i == block_size - 1) {
+                        carry = 1;
+                    } else {
+                        escaped |= uint64_t{1} << (i + 1);
+                    }
+                }
+                return escaped;
+            }
+
+            inline uint64_t whitespace_mask(const Block& block) {
+                return block.eq(' ') | block.eq('\n') | block.eq('\r') | block.eq('\t');
+            }
+
+            /**
+             * Skip the whitespaces.
+             * @return The pointer to the first non-whitespace character, or end.
+             */
+            inline const char* skip_whitespace(const char* it, const char* end) {
+                // most runs are a single space or none at all, which are not worth a block.
+                for (int i = 0; i < 4; ++i, ++it) {
+                    if (it == end || !is_empty_char(*it)) {
+                        return it;
+                    }
+                }
+                for (; end - it >= static_cast<ptrdiff_t>(block_size); it += block_size) {
+                    if (const uint64_t others = ~whitespace_mask(Block(it))) {
+                        return it + trailing_zeros(others);
+                    }
+                }
+                while (it != end && is_empty_char(*it)) {
+                    ++it;
+                }
+                return it;
+            }
+
+            /**
+             * Find the end of the plain run of a string.
+             * @return The pointer to the first quote or backslash, or end.
+             */
+            inline const char* find_quote_or_escape(const char* it, const char* end) {
+                for (; end - it >= static_cast<ptrdiff_t>(block_size); it += block_size) {
+                    const Block block(it);
+                    if (const uint64_t stops = block.eq('"') | block.eq('\\')) {
+                        return it + trailing_zeros(stops);
+                    }
+                }
+                while (it != end && *it != '"' && *it != '\\') {
+                    ++it;
+                }
+                return it;
+            }
         }
 
-        inline bool is_right_bracket(char c) {
-            return c == ']' || c == '}' || c == ')';
+        inline void skip_empty(const char*& it, const char* end) {
+            it = simd::skip_whitespace(it, end);
         }
 
-        inline bool bracket_match(char left, char right) {
-            return (left == '[' && right == ']') || (left == '{' && right == '}') || (left == '(' && right == ')');
+        /**
+         * Check that the brackets are balanced and the strings are terminated, in a single pass.
+         * @note Brackets inside strings, and escaped quotes, are taken into account.
+         */
+        inline bool check_brackets(const char* begin, const char* end) {
+            std::string brackets;
+            uint64_t escape_carry = 0;
+            uint64_t in_string_carry = 0;
+            char tail[simd::block_size];
+            for (const char* it = begin; it < end; it += simd::block_size) {
+                const char* data = it;
+                if (const auto remaining = static_cast<size_t>(end - it); remaining < simd::block_size) {
+                    std::memset(tail, ' ', simd::block_size);
+                    std::memcpy(tail, it, remaining);
+                    data = tail;
+                }
+                const simd::Block block(data);
+                const uint64_t escaped = simd::escaped_mask(block.eq('\\'), escape_carry);
+                const uint64_t in_string = simd::prefix_xor(block.eq('"') & ~escaped) ^ in_string_carry;
+                in_string_carry = uint64_t{0} - (in_string >> 63);
+
+                uint64_t structural = (block.eq('{') | block.eq('}') | block.eq('[') | block.eq(']')) & ~in_string;
+                while (structural != 0) {
+                    const char c = data[simd::trailing_zeros(structural)];
+                    structural &= structural - 1;
+                    if (c == '{' || c == '[') {
+                        brackets.push_back(c);
+                    } else if (brackets.empty() || !bracket_match(brackets.back(), c)) {
+                        return false;
+                    } else {
+                        brackets.pop_back();
+                    }
+                }
+            }
+            return brackets.empty() && in_string_carry == 0;
         }
 
         inline bool check_brackets(const std::string& str) {
-            std::stack<char> brackets;
-            for (const char& it: str) {
-                if (is_left_bracket(it)) {
-                    brackets.push(it);
-                } else if (is_right_bracket(it)) {
-                    if (brackets.empty()) {
-                        throw std::runtime_error("brackets error");
+            return check_brackets(str.data(), str.data() + str.size());
+        }
+
+        /**
+         * Split a top-level array into its elements, with the same structural scan as check_brackets.
+         * @note Only commas at the depth of the array delimit elements, the elements themselves are not validated.
+         * @param elements The ranges of the elements, which may include surrounding whitespaces.
+         * @return False if the input isn't a single array with balanced brackets and terminated strings.
+         */
+        inline bool split_array(const char* begin, const char* end, std::vector<std::string_view>& elements) {
+            begin = simd::skip_whitespace(begin, end);
+            if (begin == end || *begin != '[') {
+                return false;
+            }
+            std::string brackets;
+            const char* element = nullptr;
+            const char* close = nullptr;
+            uint64_t escape_carry = 0;
+            uint64_t in_string_carry = 0;
+            char tail[simd::block_size];
+            for (const char* it = begin; it < end; it += simd::block_size) {
+                const char* data = it;
+                if (const auto remaining = static_cast<size_t>(end - it); remaining < simd::block_size) {
+                    std::memset(tail, ' ', simd::block_size);
+                    std::memcpy(tail, it, remaining);
+                    data = tail;
+                }
+                const simd::Block block(data);
+                const uint64_t escaped = simd::escaped_mask(block.eq('\\'), escape_carry);
+                const uint64_t in_string = simd::prefix_xor(block.eq('"') & ~escaped) ^ in_string_carry;
+                in_string_carry = uint64_t{0} - (in_string >> 63);
+
+                uint64_t structural = (block.eq('{') | block.eq('}') | block.eq('[') | block.eq(']') |
+                                       block.eq(',')) & ~in_string;
+                while (structural != 0) {
+                    const char* position = it + simd::trailing_zeros(structural);
+                    const char c = data[position - it];
+                    structural &= structural - 1;
+                    if (close != nullptr) {
+                        return false;
                     }
-                    if (bracket_match(brackets.top(), it)) {
-                        brackets.pop();
-                    } else {
+                    if (c == ',') {
+                        if (brackets.size() == 1) {
+                            elements.emplace_back(element, position - element);
+                            element = position + 1;
+                        }
+                    } else if (c == '{' || c == '[') {
+                        if (brackets.empty()) {
+                            element = position + 1;
+                        }
+                        brackets.push_back(c);
+                    } else if (brackets.empty() || !bracket_match(brackets.back(), c)) {
                         return false;
+                    } else {
+                        brackets.pop_back();
+                        if (brackets.empty()) {
+                            close = position;
+                        }
                     }
                 }
             }
-            while (!brackets.empty()) {
+            if (close == nullptr || in_string_carry != 0 || simd::skip_whitespace(close + 1, end) != end) {
                 return false;
             }
+            // "[]" has no element, while "[,]" has two empty ones.
+            if (!elements.empty() || simd::skip_whitespace(element, close) != close) {
+                elements.emplace_back(element, close - element);
+            }
             return true;
         }
     }
 
     inline void print_object(JsonObject object, std::ostream& os = std::cout, bool pretty_print = false, size_t indent = 4) {
+        const auto print_fields = [&](const auto& fields) {
+            size_t i = 0;
+            os << "{";
+            if (pretty_print) {
+                os << std::endl;
+            }
+            for (const auto& [key, value]: fields) {
+                if (pretty_print) {
+                    os << std::string(indent, ' ');
+                }
+                os << "\"" << key << "\"" << ": ";
+                print_object(value, os, pretty_print, indent + 4);
+                if (++i != fields.size()) {
+                    os << ", ";
+                }
+                if (pretty_print) {
+                    os << std::endl;
+                }
+            }
+            if (pretty_print) {
+                os << std::string(indent - 4, ' ');
+            }
+            os << "}";
+        };
         switch (object.value.index()) {
             case 0:
                 os << "null";
@@ -203,136 +650,177 @@ namespace json_parser {
                 } while (false);
                 break;
             case 6:
-                do {
-                    size_t i = 0;
-                    size_t size = std::get<JsonMap>(object.value).size();
-                    os << "{";
-                    if (pretty_print) {
-                        os << std::endl;
-                    }
-                    for (const auto& [key, value]: std::get<JsonMap>(object.value)) {
-                        if (pretty_print) {
-                            os << std::string(indent, ' ');
-                        }
-                        os << "\"" << key << "\"" << ": ";
-                        print_object(value, os, pretty_print, indent + 4);
-                        if (++i != size) {
-                            os << ", ";
-                        }
-                        if (pretty_print) {
-                            os << std::endl;
-                        }
-                    }
-                    if (pretty_print) {
-                        os << std::string(indent - 4, ' ');
-                    }
-                    os << "}";
-                } while (false);
+                print_fields(std::get<JsonMap>(object.value));
+                break;
+            case 7:
+                print_fields(std::get<JsonOrderedMap>(object.value));
                 break;
             default:
                 os << "unknown";
         }
     }
 
-    JsonArray parse_json_array(std::string::const_iterator& it);
+    JsonArray parse_json_array(const char*& it, const char* end);
+
+    JsonMap parse_json_map(const char*& it, const char* end);
 
-    JsonMap parse_json_map(std::string::const_iterator& it);
+    std::string parse_json_string(const char*& it, const char* end);
 
-    std::string parse_json_string(std::string::const_iterator& it);
+    /**
+     * Parse a number, as an int if it has neither a fraction nor an exponent (and fits), or as a double.
+     */
+    inline JsonObject parse_json_number(const char*& it, const char* end) {
+        const char* start = it;
+        bool is_integer = true;
+        while (it != end && ((*it >= '0' && *it <= '9') || *it == '-' || *it == '+' || *it == '.' ||
+                             *it == 'e' || *it == 'E')) {
+            is_integer = is_integer && (*it == '-' || (*it >= '0' && *it <= '9'));
+            ++it;
+        }
+        if (is_integer) {
+            int value = 0;
+            if (const auto [ptr, ec] = std::from_chars(start, it, value); ec == std::errc() && ptr == it) {
+                return {value};
+            }
+        }
+        double value = 0;
+        if (const auto [ptr, ec] = std::from_chars(start, it, value); ec != std::errc() || ptr != it) {
+            throw std::runtime_error("invalid number");
+        }
+        return {value};
+    }
+
+    inline bool _consume_literal(const char*& it, const char* end, const std::string_view literal) {
+        if (static_cast<size_t>(end - it) < literal.size() || std::string_view(it, literal.size()) != literal) {
+            return false;
+        }
+        it += literal.size();
+        return true;
+    }
 
-    inline JsonObject parse_json_object(std::string::const_iterator& it) {
-        _internal::skip_empty(it);
+    /**
+     * Parse a JSON value.
+     * @param it Points at the value (or the whitespaces before it), and is moved past the value.
+     * @param end The end of the input.
+     */
+    inline JsonObject parse_json_object(const char*& it, const char* end) {
+        _internal::skip_empty(it, end);
+        if (it == end) {
+            throw std::runtime_error("unexpected end of json");
+        }
         if (*it == '[') {
-            return {parse_json_array(it)};
+            return {parse_json_array(it, end)};
         }
         if (*it == '{') {
-            return {parse_json_map(it)};
+            return {parse_json_map(it, end)};
         }
         if (*it == '"') {
-            return {parse_json_string(it)};
+            return {parse_json_string(it, end)};
         }
-        if (*it == 't') {
-            it += 3;
+        if (_consume_literal(it, end, "true")) {
             return {true};
         }
-        if (*it == 'f') {
-            it += 3;
+        if (_consume_literal(it, end, "false")) {
             return {false};
         }
-        if (*it == 'n') {
-            it += 3;
+        if (_consume_literal(it, end, "null")) {
             return {std::monostate()};
         }
         if (*it == '-' || (*it >= '0' && *it <= '9')) {
-            std::string number;
-            int sgn = *it == '-' ? -1 : 1;
-            if (*it == '-') {
-                ++it;
-            }
-            while ((*it >= '0' && *it <= '9') || *it == '.') {
-                number += *it;
-                ++it;
-            }
-            --it;
-            if (number.find('.') != std::string::npos) {
-                return {sgn * std::stod(number)};
-            }
-            return {sgn * std::stoi(number)};
+            return parse_json_number(it, end);
         }
         throw std::runtime_error("unknown json object");
     }
 
-    inline JsonArray parse_json_array(std::string::const_iterator& it) {
+    inline JsonArray parse_json_array(const char*& it, const char* end) {
         JsonArray result;
-        while (*++it != ']') {
-            _internal::skip_empty(it);
-            if (*it == ',') {
-                ++it;
+        ++it;
+        while (true) {
+            _internal::skip_empty(it, end);
+            if (it == end) {
+                throw std::runtime_error("unterminated json array");
             }
-            _internal::skip_empty(it);
             if (*it == ']') {
+                ++it;
                 return result;
             }
-            JsonObject object = {parse_json_object(it)};
-            result.push_back(object);
+            result.push_back(parse_json_object(it, end));
+            _internal::skip_empty(it, end);
+            if (it != end && *it == ',') {
+                ++it;
+            } else if (it == end || *it != ']') {
+                throw std::runtime_error("expected ',' or ']' in json array");
+            }
         }
-        return result;
     }
 
-    inline std::string parse_json_string(std::string::const_iterator& it) {
+    /**
+     * Parse a string.
+     * @note The plain runs between the escape sequences are located by the SIMD kernels, and appended in one go.
+     */
+    inline std::string parse_json_string(const char*& it, const char* end) {
         std::string result;
-        result.reserve(64);
-        while (*++it != '"') {
-            if (*it == '\\') {
+        ++it;
+        while (true) {
+            const char* stop = _internal::simd::find_quote_or_escape(it, end);
+            result.append(it, stop);
+            it = stop;
+            if (it == end) {
+                throw std::runtime_error("unterminated json string");
+            }
+            if (*it == '"') {
                 ++it;
-                result.push_back(_internal::convert_escape_char(*it));
+                return result;
+            }
+            if (++it == end) {
+                throw std::runtime_error("unterminated json string");
+            }
+            if (*it == 'u') {
+                if (!_internal::append_unicode_escape(it, end, result)) {
+                    throw std::runtime_error("invalid unicode escape");
+                }
                 continue;
             }
-            result.push_back(*it);
+            result.push_back(_internal::convert_escape_char(*it));
+            ++it;
         }
-        return result;
     }
 
-    inline JsonMap parse_json_map(std::string::const_iterator& it) {
+    inline JsonMap parse_json_map(const char*& it, const char* end) {
         JsonMap result;
-        while (*++it != '}') {
-            _internal::skip_empty(it);
-            if (*it == ',') {
-                ++it;
+        ++it;
+        while (true) {
+            _internal::skip_empty(it, end);
+            if (it == end) {
+                throw std::runtime_error("unterminated json object");
             }
             if (*it == '}') {
+                ++it;
                 return result;
             }
-            if (*it == '"') {
-                std::string key = parse_json_string(it);
-                _internal::skip_empty(it);
-                _internal::to_nearest_colon(it);
-                result[key] = {parse_json_object(it)};
+            if (*it != '"') {
+                throw std::runtime_error("expected a key in json object");
+            }
+            std::string key = parse_json_string(it, end);
+            _internal::skip_empty(it, end);
+            if (it == end || *it != ':') {
+                throw std::runtime_error("expected ':' in json object");
+            }
+            ++it;
+            result[std::move(key)] = parse_json_object(it, end);
+            _internal::skip_empty(it, end);
+            if (it != end && *it == ',') {
+                ++it;
+            } else if (it == end || *it != '}') {
+                throw std::runtime_error("expected ',' or '}' in json object");
             }
         }
-        return result;
     }
 
+    /**
+     * Parse a JSON document into a JsonObject tree.
+     * @note The brackets are validated while parsing, so no separate pass over the input is made.
+     */
     inline JsonObject parse_json_object(const std::string& json_str) {
         JsonObject result;
         if (json_str.empty()) {
@@ -340,18 +828,34 @@ namespace json_parser {
             return result;
         }
 
-        if (!_internal::check_brackets(json_str)) {
+        const char* it = json_str.data();
+        const char* end = it + json_str.size();
+        result = parse_json_object(it, end);
+        _internal::skip_empty(it, end);
+        if (it != end) {
             throw std::runtime_error("brackets are not balanced");
         }
-
-        auto it = json_str.begin();
-        _internal::skip_empty(it);
-        result = parse_json_object(it);
         return result;
     }
 }
 
 namespace json_mapper {
+    /**
+     * A read-only view of the elements of an array_like container.
+     * @note The element at index i lives at `data + i * stride`, and its type is the `type_index` member.
+     * @note The data is nullptr if the elements are not addressable (as in std::vector<bool>),
+     * @note in which case they have to be read one by one through the "element" method.
+     */
+    struct JsonArrayView {
+        const void* data = nullptr;
+        size_t size = 0;
+        size_t stride = 0;
+
+        [[nodiscard]] const void* at(const size_t i) const noexcept {
+            return static_cast<const char *>(data) + i * stride;
+        }
+    };
+
     template <typename T>
     class JsonVector : public std::vector<T> {
     public:
@@ -359,6 +863,18 @@ namespace json_mapper {
 
         JsonVector() = default;
 
+        [[nodiscard]] JsonArrayView view() const {
+            if constexpr (std::is_same_v<T, bool>) {
+                return {nullptr, std::vector<T>::size(), 0};
+            } else {
+                return {std::vector<T>::data(), std::vector<T>::size(), sizeof(T)};
+            }
+        }
+
+        [[nodiscard]] T element(size_t i) const {
+            return std::vector<T>::operator[](i);
+        }
+
         void push_back(T&& value) {
             std::vector<T>::push_back(std::move(value));
         }
@@ -382,51 +898,261 @@ namespace json_mapper {
                type_index == typeid(std::monostate);
     }
 
+    inline bool _is_array_like(const simple_reflection::ReflectionBase& reflection) {
+        const auto type = reflection.try_get_metadata_as<std::string>("json_object_type");
+        return type != nullptr && *type == "array_like";
+    }
+
+    /**
+     * How the mapper encodes a type.
+     */
+    enum class CodecKind : uint8_t {
+        string,
+        integer,
+        number,
+        boolean,
+        null,
+        object,
+        array,
+        unsupported
+    };
+
+    /**
+     * Classify a type, finding its reflection unless it's a primitive.
+     */
+    inline CodecKind codec_kind_of(const std::type_index type, simple_reflection::ReflectionBase*& reflection) {
+        reflection = nullptr;
+        if (type == typeid(std::string)) {
+            return CodecKind::string;
+        }
+        if (type == typeid(int)) {
+            return CodecKind::integer;
+        }
+        if (type == typeid(double)) {
+            return CodecKind::number;
+        }
+        if (type == typeid(bool)) {
+            return CodecKind::boolean;
+        }
+        if (type == typeid(std::monostate)) {
+            return CodecKind::null;
+        }
+        reflection = simple_reflection::try_get_reflection(type);
+        if (reflection == nullptr) {
+            return CodecKind::unsupported;
+        }
+        return _is_array_like(*reflection) ? CodecKind::array : CodecKind::object;
+    }
+
+    /**
+     * Append a string as a JSON string, copying the runs which need no escaping as a block.
+     */
+    inline void _append_json_string(std::string& out, const std::string_view str) {
+        out.push_back('"');
+        const char* it = str.data();
+        const char* end = it + str.size();
+        while (it != end) {
+            const char* run = it;
+            while (it != end && *it != '"' && *it != '\\' && static_cast<unsigned char>(*it) >= 0x20) {
+                ++it;
+            }
+            out.append(run, it);
+            if (it == end) {
+                break;
+            }
+            switch (const char c = *it++) {
+                case '"':
+                    out.append("\\\"");
+                    break;
+                case '\\':
+                    out.append("\\\\");
+                    break;
+                case '\b':
+                    out.append("\\b");
+                    break;
+                case '\f':
+                    out.append("\\f");
+                    break;
+                case '\n':
+                    out.append("\\n");
+                    break;
+                case '\r':
+                    out.append("\\r");
+                    break;
+                case '\t':
+                    out.append("\\t");
+                    break;
+                default: {
+                    static constexpr char digits[] = "0123456789abcdef";
+                    const auto code = static_cast<unsigned char>(c);
+                    const char escaped[] = {'\\', 'u', '0', '0', digits[code >> 4], digits[code & 0xf]};
+                    out.append(escaped, sizeof(escaped));
+                }
+            }
+        }
+        out.push_back('"');
+    }
+
+    /**
+     * A registered member, as encoded by the mapper.
+     */
+    struct CodecStep {
+        std::string name;
+        // the name as a JSON string followed by a colon, written as is.
+        std::string key;
+        size_t offset = 0;
+        CodecKind kind = CodecKind::unsupported;
+        bool is_const = false;
+        // the bit of the field in a DirtySet.
+        uint32_t table_index = 0;
+        // the reflection of objects and arrays, whose plan is looked up through it.
+        simple_reflection::ReflectionBase* nested = nullptr;
+        simple_reflection::MemberSetter move_setter = nullptr;
+    };
+
+    /**
+     * The encoding of a reflected type, worked out once, see codec_plan.
+     * @note The types of the fields are classified when the plan is built,
+     * @note so (de)serializing an object is a loop over the steps with no type_index comparisons.
+     */
+    struct CodecPlan {
+        // in the order of ReflectionBase::for_each_member.
+        std::vector<CodecStep> fields;
+        simple_reflection::SymbolMap<size_t> index;
+
+        bool array_like = false;
+        // the rest is only set for array_like types.
+        CodecKind elem_kind = CodecKind::unsupported;
+        std::type_index elem_type = typeid(void);
+        simple_reflection::ReflectionBase* elem_reflection = nullptr;
+        simple_reflection::MethodHandle push_back;
+        simple_reflection::MethodHandle view;
+        simple_reflection::MethodHandle element;
+
+        /**
+         * Find the field of a key.
+         * @note The field after the one found last is tried first, since keys tend to come in the written order.
+         * @param hint The index of the field to try first, updated to the one after the found field.
+         */
+        [[nodiscard]] const CodecStep* find(const std::string_view key, size_t& hint) const {
+            if (hint < fields.size() && fields[hint].name == key) {
+                return &fields[hint++];
+            }
+            const auto found = index.find(key);
+            if (found == nullptr) {
+                return nullptr;
+            }
+            hint = *found + 1;
+            return &fields[*found];
+        }
+    };
+
+    inline simple_reflection::MethodHandle _method_handle(const simple_reflection::OverloadRef overload) {
+        return overload ? simple_reflection::MethodHandle(overload) : simple_reflection::MethodHandle();
+    }
+
+    inline CodecPlan _build_codec_plan(const simple_reflection::ReflectionBase& reflection) {
+        CodecPlan plan;
+        plan.array_like = _is_array_like(reflection);
+        if (plan.array_like) {
+            // the element type is the parameter of "push_back".
+            reflection.for_each_overload([&plan](const std::string& name,
+                                                 const simple_reflection::CallableWrapper& overload) {
+                if (name == "push_back" && overload.arg_types.size() == 1 && plan.elem_type == typeid(void)) {
+                    plan.elem_type = overload.arg_types[0];
+                }
+            });
+            plan.elem_kind = codec_kind_of(plan.elem_type, plan.elem_reflection);
+            plan.push_back = _method_handle(reflection.find_overload(
+                "push_back", simple_reflection::TypeIndexSpan(&plan.elem_type, 1)));
+            plan.view = _method_handle(
+                reflection.find_overload("view", simple_reflection::StaticSignature<>::span()));
+            plan.element = _method_handle(
+                reflection.find_overload("element", simple_reflection::StaticSignature<size_t>::span()));
+            return plan;
+        }
+
+        reflection.for_each_member([&plan](const std::string& name, const simple_reflection::Member& member) {
+            CodecStep step;
+            step.name = name;
+            _append_json_string(step.key, name);
+            step.key.push_back(':');
+            step.offset = member.offset;
+            step.kind = codec_kind_of(member.type_info, step.nested);
+            step.is_const = member.is_const;
+            step.table_index = member.table_index;
+            step.move_setter = member.move_setter;
+            plan.index.try_emplace(simple_reflection::Symbol(name), plan.fields.size());
+            plan.fields.push_back(std::move(step));
+        });
+        return plan;
+    }
+
+    /**
+     * Get the codec plan of a reflected type, which is built on first use and cached on the reflection.
+     * @note Hold the pointer as long as the plan is used, since a registration may replace the cached one meanwhile.
+     */
+    inline std::shared_ptr<const CodecPlan> codec_plan(const simple_reflection::ReflectionBase& reflection) {
+        return reflection.cached_plan<CodecPlan>(&_build_codec_plan);
+    }
+
     simple_reflection::ReturnValueProxy map_fields(simple_reflection::ReflectionBase& reflection,
                                                    const json_parser::JsonMap& map,
-                                                   simple_reflection::PhantomDataHelper& phantom);
+                                                   simple_reflection::PhantomDataHelper& phantom,
+                                                   simple_reflection::ReflectionArena* arena = nullptr);
+
+    /**
+     * Construct an instance through "ctor", in the arena if there's one.
+     */
+    inline simple_reflection::ReturnValueProxy _construct(simple_reflection::ReflectionBase& reflection,
+                                                          simple_reflection::ReflectionArena* arena) {
+        if (arena != nullptr) {
+            return reflection.invoke_function("ctor", *arena);
+        }
+        return reflection.invoke_function("ctor");
+    }
 
     inline simple_reflection::ReturnValueProxy map_array(simple_reflection::ReflectionBase& reflection,
                                                          const json_parser::JsonArray& array,
-                                                         simple_reflection::PhantomDataHelper& phantom) {
+                                                         simple_reflection::PhantomDataHelper& phantom,
+                                                         simple_reflection::ReflectionArena* arena = nullptr) {
         test_helper::dbg_print("mapping array with type: ", reflection.get_type_string());
-        auto instance = reflection.invoke_function("ctor");
+        auto instance = _construct(reflection, arena);
         instance >> phantom;
         auto array_ptr = instance.get_raw();
 
-        auto elem_type = *reflection.get_member_ref<std::type_index>(array_ptr, "type_index");
+        const auto plan_owner = codec_plan(reflection);
+
+        const auto& plan = *plan_owner;
+        const auto& push_back = plan.push_back;
         for (const auto& item: array) {
-            if (is_json_primitives(elem_type)) {
-                if (elem_type == typeid(std::string)) {
-                    reflection.invoke_method(array_ptr, "push_back",
-                                             make_args(const_cast<std::string&&>(std::get<std::string>(item.value))));
+            switch (plan.elem_kind) {
+                case CodecKind::string:
+                    push_back.invoke(array_ptr,
+                                     make_args(const_cast<std::string&&>(std::get<std::string>(item.value))));
                     continue;
-                }
-                if (elem_type == typeid(int)) {
-                    reflection.invoke_method(array_ptr, "push_back",
-                                             make_args(const_cast<int&&>(std::get<int>(item.value))));
+                case CodecKind::integer:
+                    push_back.invoke(array_ptr, make_args(const_cast<int&&>(std::get<int>(item.value))));
                     continue;
-                }
-                if (elem_type == typeid(double)) {
-                    reflection.invoke_method(array_ptr, "push_back",
-                                             make_args(const_cast<double&&>(std::get<double>(item.value))));
+                case CodecKind::number:
+                    push_back.invoke(array_ptr, make_args(const_cast<double&&>(std::get<double>(item.value))));
                     continue;
-                }
-                if (elem_type == typeid(bool)) {
-                    reflection.invoke_method(array_ptr, "push_back",
-                                             make_args(const_cast<bool&&>(std::get<bool>(item.value))));
+                case CodecKind::boolean:
+                    push_back.invoke(array_ptr, make_args(const_cast<bool&&>(std::get<bool>(item.value))));
                     continue;
-                }
-                if (elem_type == typeid(std::monostate)) {
+                case CodecKind::null:
                     throw std::runtime_error("nullable type is not supported");
-                }
+                case CodecKind::object:
+                case CodecKind::array:
+                    break;
+                case CodecKind::unsupported:
+                    throw std::runtime_error("unsupported array type " + reflection.get_type_string());
             }
 
-            auto item_refl = simple_reflection::ReflectionRegistryBase::instance().get_reflection(elem_type);
-            auto proxy = map_fields(item_refl, std::get<json_parser::JsonMap>(item.value), phantom);
+            auto proxy = map_fields(*plan.elem_reflection, std::get<json_parser::JsonMap>(item.value), phantom,
+                                    arena);
             proxy >> phantom;
-            reflection.invoke_method(array_ptr, "push_back",
-                                     simple_reflection::empty_arg_list() | proxy.to_wrapped());
+            push_back.invoke(array_ptr, simple_reflection::empty_arg_list() | proxy.to_moved());
         }
 
         return instance;
@@ -434,222 +1160,910 @@ namespace json_mapper {
 
     inline simple_reflection::ReturnValueProxy map_fields(simple_reflection::ReflectionBase& reflection,
                                                           const json_parser::JsonMap& map,
-                                                          simple_reflection::PhantomDataHelper& phantom) {
+                                                          simple_reflection::PhantomDataHelper& phantom,
+                                                          simple_reflection::ReflectionArena* arena) {
         test_helper::dbg_print("mapping field with type: ", reflection.get_type_string());
-        auto instance = reflection.invoke_function("ctor");
+        auto instance = _construct(reflection, arena);
         instance >> phantom;
-        auto instance_ptr = instance.get_raw();
+        const auto instance_ptr = static_cast<char *>(instance.get_raw());
 
-        auto fields = reflection.get_member_map();
+        const auto plan_owner = codec_plan(reflection);
 
+        const auto& plan = *plan_owner;
+        size_t hint = 0;
         for (const auto& [key, value]: map) {
-            if (fields.find(key) == fields.end()) {
+            const auto step = plan.find(key, hint);
+            if (step == nullptr || step->is_const) {
                 continue;
             }
-            auto& [field_name, field_type] = fields.at(key);
-            if (is_json_primitives(field_type)) {
-                if (field_type == typeid(std::string)) {
-                    const auto field_ptr = reflection.get_member_ref<std::string>(instance_ptr, field_name);
-                    *field_ptr = std::get<std::string>(value.value);
+            const auto field = instance_ptr + step->offset;
+            switch (step->kind) {
+                case CodecKind::string:
+                    *reinterpret_cast<std::string *>(field) = std::get<std::string>(value.value);
                     continue;
-                }
-                if (field_type == typeid(int)) {
-                    const auto field_ptr = reflection.get_member_ref<int>(instance_ptr, field_name);
-                    *field_ptr = std::get<int>(value.value);
+                case CodecKind::integer:
+                    *reinterpret_cast<int *>(field) = std::get<int>(value.value);
                     continue;
-                }
-                if (field_type == typeid(double)) {
-                    const auto field_ptr = reflection.get_member_ref<double>(instance_ptr, field_name);
-                    *field_ptr = std::get<double>(value.value);
+                case CodecKind::number:
+                    *reinterpret_cast<double *>(field) = std::get<double>(value.value);
                     continue;
-                }
-                if (field_type == typeid(bool)) {
-                    const auto field_ptr = reflection.get_member_ref<bool>(instance_ptr, field_name);
-                    *field_ptr = std::get<bool>(value.value);
+                case CodecKind::boolean:
+                    *reinterpret_cast<bool *>(field) = std::get<bool>(value.value);
                     continue;
-                }
-                if (field_type == typeid(std::monostate)) {
+                case CodecKind::null:
                     throw std::runtime_error("nullable field is not supported");
-                }
+                case CodecKind::unsupported:
+                    throw simple_reflection::reflection_registry_not_found_exception(step->name);
+                case CodecKind::object:
+                case CodecKind::array:
+                    break;
             }
 
             simple_reflection::PhantomDataHelper field_phantom;
+            auto proxy = value.value.index() == 5
+                             ? map_array(*step->nested, std::get<json_parser::JsonArray>(value.value), field_phantom,
+                                         arena)
+                             : map_fields(*step->nested, std::get<json_parser::JsonMap>(value.value), field_phantom,
+                                          arena);
+            step->move_setter(field, proxy.get_raw());
+        }
+        return instance;
+    }
 
-            if (value.value.index() == 5) {
-                auto array_refl = simple_reflection::ReflectionRegistryBase::instance().get_reflection(field_type);
-                auto proxy = map_array(array_refl, std::get<json_parser::JsonArray>(value.value), field_phantom);
-                reflection.set_member(instance_ptr, field_name, proxy.to_wrapped());
-                continue;
-            }
+    /**
+     * A pull parser which writes the values straight into the reflected fields, as the tokens arrive.
+     * @note Unlike parse_json_object followed by map_fields, no intermediate JsonObject tree is built:
+     * @note nested objects and arrays are parsed in place into the memory of the enclosing field,
+     * @note keys are looked up without being copied into a map, and numbers are parsed with std::from_chars.
+     * @note Keys which are not registered members, and null values, are skipped.
+     */
+    class JsonReader {
+        const char* m_begin;
+        const char* m_it;
+        const char* m_end;
+        simple_reflection::ReflectionArena* m_arena;
+        std::string m_key;
 
-            simple_reflection::ReflectionBase field_reflection =
-                    simple_reflection::ReflectionRegistryBase::instance().get_reflection(field_type);
+    public:
+        explicit JsonReader(const std::string_view json, simple_reflection::ReflectionArena* arena = nullptr)
+            : m_begin(json.data()), m_it(json.data()), m_end(json.data() + json.size()), m_arena(arena) {
+        }
 
-            auto proxy = map_fields(field_reflection, std::get<json_parser::JsonMap>(value.value), field_phantom);
-            reflection.set_member(instance_ptr, field_name, proxy.to_wrapped());
+        /**
+         * Parse a JSON value into an object.
+         * @param object The pointer to the object, which must have been constructed.
+         * @param reflection The reflection of the object.
+         */
+        void read(void* object, simple_reflection::ReflectionBase& reflection) {
+            _read_reflected(object, reflection);
+            _skip_empty();
+            if (m_it != m_end) {
+                _fail("trailing characters");
+            }
         }
-        return instance;
-    }
 
-    template <typename Serializable>
-    simple_reflection::ReturnValueProxy from_json(const std::string& json_str) {
-        simple_reflection::PhantomDataHelper phantom;
-        auto json_object = json_parser::parse_json_object(json_str);
-        auto base = simple_reflection::ReflectionRegistryBase::instance().get_reflection(typeid(Serializable));
-        if (json_object.value.index() == 5) {
-            return map_array(base, std::get<json_parser::JsonArray>(json_object.value), phantom);
+    private:
+        [[noreturn]] void _fail(const char* what) const {
+            throw std::runtime_error(std::string("json: ") + what + " at offset " +
+                                     std::to_string(m_it - m_begin));
         }
-        return map_fields(base, std::get<json_parser::JsonMap>(json_object.value), phantom);
-    }
 
-    json_parser::JsonObject _dump_json_object(void* object, simple_reflection::ReflectionBase& reflection);
+        void _skip_empty() {
+            json_parser::_internal::skip_empty(m_it, m_end);
+        }
 
-    inline json_parser::JsonObject _dump_json_array(void* object, simple_reflection::ReflectionBase& reflection) {
-        test_helper::dbg_print("dumping json array with type: ", reflection.get_type_string());
+        char _peek() {
+            _skip_empty();
+            if (m_it == m_end) {
+                _fail("unexpected end of input");
+            }
+            return *m_it;
+        }
 
-        simple_reflection::PhantomDataHelper phantom;
-        auto member_type = *reflection.get_member_ref<std::type_index>(object, "type_index");
+        void _expect(const char c) {
+            if (_peek() != c) {
+                _fail("unexpected character");
+            }
+            ++m_it;
+        }
 
-        auto proxy = reflection.invoke_method(object, "size");
-        auto size = proxy.to_wrapped().deref_into<size_t>();
+        bool _consume(const char c) {
+            if (_peek() == c) {
+                ++m_it;
+                return true;
+            }
+            return false;
+        }
 
-        json_parser::JsonArray array;
+        bool _consume_literal(const std::string_view literal) {
+            return json_parser::_consume_literal(m_it, m_end, literal);
+        }
 
-        proxy >> phantom;
-        if (is_json_primitives(member_type)) {
-            if (member_type == typeid(std::string)) {
-                for (size_t i = 0; i < size; ++i) {
-                    proxy = reflection.invoke_method(object, "pop_back");
-                    proxy >> phantom;
-                    array.push_back(json_parser::JsonObject{
-                        std::move(proxy.to_wrapped().deref_into<std::string>())
-                    });
+        /**
+         * Parse a string, assigning it to the target.
+         * @note The plain runs between the escape sequences are located by the SIMD kernels, and assigned in one go.
+         */
+        void _read_string(std::string& target) {
+            _expect('"');
+            target.clear();
+            while (true) {
+                const char* stop = json_parser::_internal::simd::find_quote_or_escape(m_it, m_end);
+                target.append(m_it, stop);
+                m_it = stop;
+                if (m_it == m_end) {
+                    _fail("unterminated string");
                 }
-                return json_parser::JsonObject{std::move(array)};
+                if (*m_it++ == '"') {
+                    return;
+                }
+                if (m_it == m_end) {
+                    _fail("unterminated string");
+                }
+                if (*m_it == 'u') {
+                    if (!json_parser::_internal::append_unicode_escape(m_it, m_end, target)) {
+                        _fail("invalid unicode escape");
+                    }
+                    continue;
+                }
+                target.push_back(json_parser::_internal::convert_escape_char(*m_it));
+                ++m_it;
+            }
+        }
+
+        template <typename NumberType>
+        void _read_number(NumberType& target) {
+            _skip_empty();
+            const auto [ptr, ec] = std::from_chars(m_it, m_end, target);
+            if (ec != std::errc()) {
+                _fail("invalid number");
+            }
+            m_it = ptr;
+        }
+
+        void _read_bool(bool& target) {
+            _skip_empty();
+            if (_consume_literal("true")) {
+                target = true;
+            } else if (_consume_literal("false")) {
+                target = false;
+            } else {
+                _fail("invalid boolean");
+            }
+        }
+
+        /**
+         * Skip a value of any kind, e.g. the value of an unknown key.
+         */
+        void _skip_value() {
+            const char c = _peek();
+            if (c == '"') {
+                _read_string(m_key);
+                return;
             }
-            if (member_type == typeid(int)) {
-                for (size_t i = 0; i < size; ++i) {
-                    proxy = reflection.invoke_method(object, "pop_back");
-                    proxy >> phantom;
-                    array.push_back(json_parser::JsonObject{
-                        proxy.to_wrapped().deref_into<int>()
-                    });
+            if (c == '{' || c == '[') {
+                const char close = c == '{' ? '}' : ']';
+                ++m_it;
+                if (_consume(close)) {
+                    return;
                 }
+                do {
+                    if (close == '}') {
+                        _read_string(m_key);
+                        _expect(':');
+                    }
+                    _skip_value();
+                } while (_consume(','));
+                _expect(close);
+                return;
+            }
+            if (_consume_literal("true") || _consume_literal("false") || _consume_literal("null")) {
+                return;
+            }
+            double ignored;
+            _read_number(ignored);
+        }
+
+        /**
+         * Parse a value into a field of the given kind.
+         * @param nested The reflection of the field, for objects and arrays.
+         * @return False if the value is null, in which case the field is left untouched.
+         */
+        bool _read_field(void* field, const CodecKind kind, simple_reflection::ReflectionBase* nested) {
+            _skip_empty();
+            if (_consume_literal("null")) {
+                return false;
+            }
+            switch (kind) {
+                case CodecKind::string:
+                    _read_string(*static_cast<std::string *>(field));
+                    break;
+                case CodecKind::integer:
+                    _read_number(*static_cast<int *>(field));
+                    break;
+                case CodecKind::number:
+                    _read_number(*static_cast<double *>(field));
+                    break;
+                case CodecKind::boolean:
+                    _read_bool(*static_cast<bool *>(field));
+                    break;
+                case CodecKind::object:
+                    _read_object(field, *codec_plan(*nested));
+                    break;
+                case CodecKind::array:
+                    _read_array(field, *codec_plan(*nested));
+                    break;
+                case CodecKind::null:
+                case CodecKind::unsupported:
+                    _fail("unsupported field type");
             }
-            if (member_type == typeid(double)) {
-                for (size_t i = 0; i < size; ++i) {
-                    proxy = reflection.invoke_method(object, "pop_back");
-                    proxy >> phantom;
-                    array.push_back(json_parser::JsonObject{
-                        proxy.to_wrapped().deref_into<double>()
-                    });
+            return true;
+        }
+
+        void _read_reflected(void* object, simple_reflection::ReflectionBase& reflection) {
+            const auto plan_owner = codec_plan(reflection);
+            const auto& plan = *plan_owner;
+            if (plan.array_like) {
+                _read_array(object, plan);
+            } else {
+                _read_object(object, plan);
+            }
+        }
+
+        void _read_object(void* object, const CodecPlan& plan) {
+            _expect('{');
+            if (_consume('}')) {
+                return;
+            }
+            size_t hint = 0;
+            do {
+                _read_string(m_key);
+                _expect(':');
+                const auto step = plan.find(m_key, hint);
+                if (step == nullptr || step->is_const) {
+                    _skip_value();
+                    continue;
                 }
+                _read_field(static_cast<char *>(object) + step->offset, step->kind, step->nested);
+            } while (_consume(','));
+            _expect('}');
+        }
+
+        void _read_array(void* array, const CodecPlan& plan) {
+            const auto& push_back = plan.push_back;
+            if (!push_back || plan.elem_kind == CodecKind::unsupported) {
+                _fail("unsupported array type");
+            }
+
+            _expect('[');
+            if (_consume(']')) {
+                return;
             }
-            if (member_type == typeid(bool)) {
-                for (size_t i = 0; i < size; ++i) {
-                    proxy = reflection.invoke_method(object, "pop_back");
-                    proxy >> phantom;
-                    array.push_back(json_parser::JsonObject{
-                        proxy.to_wrapped().deref_into<bool>()
-                    });
+            do {
+                switch (plan.elem_kind) {
+                    case CodecKind::object:
+                    case CodecKind::array: {
+                        auto elem = _construct(*plan.elem_reflection, m_arena);
+                        void* elem_raw = elem.get_raw();
+                        _read_reflected(elem_raw, *plan.elem_reflection);
+                        push_back.invoke(array, simple_reflection::RawArgList{&elem_raw});
+                        break;
+                    }
+                    case CodecKind::string:
+                        _push_primitive<std::string>(array, push_back, CodecKind::string);
+                        break;
+                    case CodecKind::integer:
+                        _push_primitive<int>(array, push_back, CodecKind::integer);
+                        break;
+                    case CodecKind::number:
+                        _push_primitive<double>(array, push_back, CodecKind::number);
+                        break;
+                    case CodecKind::boolean:
+                        _push_primitive<bool>(array, push_back, CodecKind::boolean);
+                        break;
+                    default:
+                        _fail("nullable type is not supported");
                 }
+            } while (_consume(','));
+            _expect(']');
+        }
+
+        template <typename ElemType>
+        void _push_primitive(void* array, const simple_reflection::MethodHandle& push_back, const CodecKind kind) {
+            ElemType value{};
+            _read_field(&value, kind, nullptr);
+            push_back.call<void>(array, std::move(value));
+        }
+    };
+
+    /**
+     * Deserialize into an existing object, with no intermediate JsonObject tree.
+     * @exception std::runtime_error If the JSON is malformed, or the type is not registered.
+     */
+    template <typename Serializable>
+    void from_json_into(const std::string_view json_str, Serializable& object) {
+        const auto base = simple_reflection::try_get_reflection(typeid(Serializable));
+        if (base == nullptr) {
+            throw std::runtime_error("type " + std::string(typeid(Serializable).name()) + " is not registered");
+        }
+        JsonReader(json_str).read(&object, *base);
+    }
+
+    template <typename Serializable>
+    simple_reflection::ReturnValueProxy from_json(const std::string& json_str) {
+        auto& base = simple_reflection::ReflectionRegistryBase::instance().get_reflection(typeid(Serializable));
+        auto instance = _construct(base, nullptr);
+        JsonReader(json_str).read(instance.get_raw(), base);
+        return instance;
+    }
+
+    /**
+     * Deserialize into the given arena.
+     * @note The result and every nested temporary are constructed in the arena,
+     * @note so the returned proxy is valid until the arena is released.
+     */
+    template <typename Serializable>
+    simple_reflection::ReturnValueProxy from_json(const std::string& json_str,
+                                                  simple_reflection::ReflectionArena& arena) {
+        auto& base = simple_reflection::ReflectionRegistryBase::instance().get_reflection(typeid(Serializable));
+        auto instance = _construct(base, &arena);
+        JsonReader(json_str, &arena).read(instance.get_raw(), base);
+        return instance;
+    }
+
+    /**
+     * Parse a top-level array into an array_like container on a thread pool.
+     * @note The input is split at the element boundaries by the structural scan, and the elements are parsed
+     * @note in chunks of at least min_chunk_size, each chunk into an arena of its own, on whichever worker takes it.
+     * @note The parsed elements are then moved into the container in document order, on the calling thread.
+     * @note Arrays of primitives, and arrays with too few elements to split, are parsed on the calling thread.
+     */
+    inline void _read_array_batch(const std::string_view json_str, void* array,
+                                  simple_reflection::ReflectionBase& reflection,
+                                  simple_reflection::ThreadPool& pool, const size_t min_chunk_size) {
+        if (!_is_array_like(reflection)) {
+            throw std::runtime_error("type " + reflection.get_type_string() + " is not array_like");
+        }
+        const auto plan_owner = codec_plan(reflection);
+        const auto& plan = *plan_owner;
+        const auto& push_back = plan.push_back;
+        const auto elem_reflection = plan.elem_reflection;
+        if (!push_back || elem_reflection == nullptr) {
+            JsonReader(json_str).read(array, reflection);
+            return;
+        }
+
+        std::vector<std::string_view> elements;
+        if (!json_parser::_internal::split_array(json_str.data(), json_str.data() + json_str.size(), elements)) {
+            throw std::runtime_error("json: malformed array");
+        }
+        // a few chunks per worker, so that the workers which finish early can steal the rest.
+        const size_t chunk_size = std::max<size_t>({min_chunk_size, 1, elements.size() / (pool.size() * 4)});
+        const size_t chunk_count = (elements.size() + chunk_size - 1) / chunk_size;
+        if (chunk_count <= 1) {
+            JsonReader(json_str).read(array, reflection);
+            return;
+        }
+
+        struct Chunk {
+            simple_reflection::ReflectionArena arena;
+            std::vector<simple_reflection::ReturnValueProxy> values;
+        };
+        std::vector<std::unique_ptr<Chunk>> chunks(chunk_count);
+        pool.parallel_for(chunk_count, [&](const size_t index) {
+            auto chunk = std::make_unique<Chunk>();
+            const size_t first = index * chunk_size;
+            const size_t last = std::min(first + chunk_size, elements.size());
+            chunk->values.reserve(last - first);
+            for (size_t i = first; i < last; ++i) {
+                auto elem = _construct(*elem_reflection, &chunk->arena);
+                JsonReader(elements[i], &chunk->arena).read(elem.get_raw(), *elem_reflection);
+                chunk->values.push_back(std::move(elem));
+            }
+            chunks[index] = std::move(chunk);
+        });
+
+        for (const auto& chunk: chunks) {
+            for (const auto& value: chunk->values) {
+                void* raw = value.get_raw();
+                push_back.invoke(array, simple_reflection::RawArgList{&raw});
             }
-            return json_parser::JsonObject{std::move(array)};
         }
+    }
+
+    /**
+     * Deserialize a top-level array into an existing array_like container, in parallel.
+     * @note The elements are appended to the container.
+     * @exception std::runtime_error If the JSON is malformed, or the type is not a registered array_like type.
+     */
+    template <typename Container>
+    void from_json_batch_into(const std::string_view json_str, Container& container,
+                              simple_reflection::ThreadPool& pool = simple_reflection::ThreadPool::shared(),
+                              const size_t min_chunk_size = 64) {
+        const auto base = simple_reflection::try_get_reflection(typeid(Container));
+        if (base == nullptr) {
+            throw std::runtime_error("type " + std::string(typeid(Container).name()) + " is not registered");
+        }
+        _read_array_batch(json_str, &container, *base, pool, min_chunk_size);
+    }
+
+    /**
+     * Deserialize a top-level array in parallel, see from_json_batch_into.
+     * @note This relies on the registry and reflective construction being safe to use from several threads,
+     * @note which they are once the types involved are registered.
+     */
+    template <typename Container>
+    simple_reflection::ReturnValueProxy from_json_batch(const std::string_view json_str,
+                                                        simple_reflection::ThreadPool& pool =
+                                                                simple_reflection::ThreadPool::shared(),
+                                                        const size_t min_chunk_size = 64) {
+        auto& base = simple_reflection::ReflectionRegistryBase::instance().get_reflection(typeid(Container));
+        auto instance = _construct(base, nullptr);
+        _read_array_batch(json_str, instance.get_raw(), base, pool, min_chunk_size);
+        return instance;
+    }
+
+    /**
+     * Dump the fields of an object into a MapType, i.e. a JsonMap or a JsonOrderedMap.
+     */
+    template <typename MapType = json_parser::JsonMap>
+    json_parser::JsonObject _dump_json_object(void* object, const CodecPlan& plan,
+                                              const simple_reflection::DirtySet* dirty = nullptr);
+
+    /**
+     * Get the view of an array_like container through its "view" method.
+     * @return False if the container does not expose a view.
+     */
+    inline bool _array_view(void* object, const CodecPlan& plan, JsonArrayView& view) {
+        return plan.view && plan.view.invoke_into(object, view);
+    }
+
+    /**
+     * Read an element of an array_like container, by copy.
+     */
+    template <typename ElemType>
+    ElemType _array_element(void* object, const JsonArrayView& view, const simple_reflection::MethodHandle& element,
+                            size_t i) {
+        if (view.data != nullptr) {
+            return *static_cast<const ElemType *>(view.at(i));
+        }
+        return element.call<ElemType>(object, i);
+    }
 
-        auto member_refl = simple_reflection::ReflectionRegistryBase::instance().get_reflection(member_type);
+    template <typename ElemType>
+    void _pop_primitives(void* object, const simple_reflection::MethodHandle& pop_back, const size_t size,
+                         json_parser::JsonArray& array) {
         for (size_t i = 0; i < size; ++i) {
-            proxy = reflection.invoke_method(object, "pop_back");
+            array.push_back(json_parser::JsonObject{pop_back.call<ElemType>(object)});
+        }
+    }
+
+    /**
+     * The fallback for array_like types which expose no "view", which consumes the container through "pop_back".
+     */
+    template <typename MapType>
+    json_parser::JsonObject _dump_json_array_by_pop(void* object, simple_reflection::ReflectionBase& reflection,
+                                                    const CodecPlan& plan) {
+        simple_reflection::PhantomDataHelper phantom;
+
+        size_t size = 0;
+        reflection.invoke_into(object, "size", size);
+        const auto pop_back = reflection.resolve_method("pop_back");
+
+        json_parser::JsonArray array;
+        switch (plan.elem_kind) {
+            case CodecKind::string:
+                _pop_primitives<std::string>(object, pop_back, size, array);
+                return json_parser::JsonObject{std::move(array)};
+            case CodecKind::integer:
+                _pop_primitives<int>(object, pop_back, size, array);
+                return json_parser::JsonObject{std::move(array)};
+            case CodecKind::number:
+                _pop_primitives<double>(object, pop_back, size, array);
+                return json_parser::JsonObject{std::move(array)};
+            case CodecKind::boolean:
+                _pop_primitives<bool>(object, pop_back, size, array);
+                return json_parser::JsonObject{std::move(array)};
+            case CodecKind::null:
+                return json_parser::JsonObject{std::move(array)};
+            default:
+                break;
+        }
+
+        if (plan.elem_reflection == nullptr) {
+            throw simple_reflection::reflection_registry_not_found_exception(plan.elem_type.name());
+        }
+        const auto elem_plan_owner = codec_plan(*plan.elem_reflection);
+        const auto& elem_plan = *elem_plan_owner;
+        for (size_t i = 0; i < size; ++i) {
+            auto proxy = pop_back.invoke(object);
             proxy >> phantom;
-            auto member_object = _dump_json_object(proxy.get_raw(), member_refl);
+            auto member_object = _dump_json_object<MapType>(proxy.get_raw(), elem_plan);
             array.push_back(std::move(member_object));
         }
         return json_parser::JsonObject{std::move(array)};
     }
 
-    inline json_parser::JsonObject _dump_json_object(void* object,
-                                                     simple_reflection::ReflectionBase& reflection) {
-        auto fields = reflection.get_member_map();
-        test_helper::dbg_print("dumping object with type: ", reflection.get_type_string());
+    /**
+     * Dump an array_like container, in order and without modifying it.
+     */
+    template <typename MapType = json_parser::JsonMap>
+    json_parser::JsonObject _dump_json_array(void* object, simple_reflection::ReflectionBase& reflection) {
+        test_helper::dbg_print("dumping json array with type: ", reflection.get_type_string());
 
-        json_parser::JsonMap map;
+        const auto plan_owner = codec_plan(reflection);
 
-        for (auto& [_, pair]: fields) {
-            auto field_type = pair.second;
-            auto name = std::string(pair.first);
+        const auto& plan = *plan_owner;
+        JsonArrayView view;
+        if (!_array_view(object, plan, view)) {
+            return _dump_json_array_by_pop<MapType>(object, reflection, plan);
+        }
+        const auto& element = plan.element;
 
-            json_parser::JsonObject inner = json_parser::JsonObject();
-            if (is_json_primitives(field_type)) {
-                if (field_type == typeid(std::string)) {
-                    auto member = reflection.get_member_ref<std::string>(object, name);
-                    inner.value = *member;
-                    map.emplace(std::move(name), std::move(inner));
-                    continue;
-                }
-                if (field_type == typeid(int)) {
-                    auto member = reflection.get_member_ref<int>(object, name);
-                    inner.value = *member;
-                    map.emplace(name, std::move(inner));
-                    continue;
+        json_parser::JsonArray array;
+        array.reserve(view.size);
+        switch (plan.elem_kind) {
+            case CodecKind::string:
+                for (size_t i = 0; i < view.size; ++i) {
+                    array.push_back(json_parser::JsonObject{_array_element<std::string>(object, view, element, i)});
                 }
-                if (field_type == typeid(double)) {
-                    auto member = reflection.get_member_ref<double>(object, name);
-                    inner.value = *member;
-                    map.emplace(name, inner);
-                    continue;
+                return json_parser::JsonObject{std::move(array)};
+            case CodecKind::integer:
+                for (size_t i = 0; i < view.size; ++i) {
+                    array.push_back(json_parser::JsonObject{_array_element<int>(object, view, element, i)});
                 }
-                if (field_type == typeid(bool)) {
-                    auto member = reflection.get_member_ref<bool>(object, name);
-                    inner.value = *member;
-                    map.emplace(name, inner);
-                    continue;
+                return json_parser::JsonObject{std::move(array)};
+            case CodecKind::number:
+                for (size_t i = 0; i < view.size; ++i) {
+                    array.push_back(json_parser::JsonObject{_array_element<double>(object, view, element, i)});
                 }
-                if (field_type == typeid(std::monostate)) {
-                    throw std::runtime_error("nullable field is not supported");
+                return json_parser::JsonObject{std::move(array)};
+            case CodecKind::boolean:
+                for (size_t i = 0; i < view.size; ++i) {
+                    array.push_back(json_parser::JsonObject{_array_element<bool>(object, view, element, i)});
                 }
-            }
+                return json_parser::JsonObject{std::move(array)};
+            case CodecKind::null:
+                return json_parser::JsonObject{std::move(array)};
+            default:
+                break;
+        }
 
+        if (plan.elem_reflection == nullptr) {
+            throw simple_reflection::reflection_registry_not_found_exception(plan.elem_type.name());
+        }
+        const auto elem_plan_owner = codec_plan(*plan.elem_reflection);
+        const auto& elem_plan = *elem_plan_owner;
+        for (size_t i = 0; i < view.size; ++i) {
+            array.push_back(_dump_json_object<MapType>(const_cast<void *>(view.at(i)), elem_plan));
+        }
+        return json_parser::JsonObject{std::move(array)};
+    }
 
-            const auto field_ptr = reflection.get_member_wrapped(object, name);
-            try {
-                auto field_reflection = simple_reflection::ReflectionRegistryBase::instance().
-                        get_reflection(field_type);
-                if (field_reflection.has_metadata("json_object_type")) {
-                    if (field_reflection.get_metadata_as<std::string>("json_object_type") == "array_like") {
-                        inner = _dump_json_array(field_ptr.object, field_reflection);
-                        map.emplace(name, inner);
-                        continue;
-                    }
-                }
-                inner = _dump_json_object(field_ptr.object, field_reflection);
-                map.emplace(name, inner);
-            } catch (const std::exception& e) {
-                // std::cout << e.what() << std::endl;
-                return json_parser::JsonObject{};
+    template <typename MapType>
+    json_parser::JsonObject _dump_json_object(void* object, const CodecPlan& plan,
+                                              const simple_reflection::DirtySet* dirty) {
+        const auto bytes = static_cast<char *>(object);
+        MapType map;
+
+        for (const auto& step: plan.fields) {
+            if (dirty != nullptr && !dirty->contains(step.table_index)) {
+                continue;
+            }
+            const auto field = bytes + step.offset;
+            json_parser::JsonObject inner = json_parser::JsonObject();
+            switch (step.kind) {
+                case CodecKind::string:
+                    inner.value = *reinterpret_cast<const std::string *>(field);
+                    break;
+                case CodecKind::integer:
+                    inner.value = *reinterpret_cast<const int *>(field);
+                    break;
+                case CodecKind::number:
+                    inner.value = *reinterpret_cast<const double *>(field);
+                    break;
+                case CodecKind::boolean:
+                    inner.value = *reinterpret_cast<const bool *>(field);
+                    break;
+                case CodecKind::null:
+                    throw std::runtime_error("nullable field is not supported");
+                case CodecKind::unsupported:
+                    return json_parser::JsonObject{};
+                case CodecKind::array:
+                    inner = _dump_json_array<MapType>(field, *step.nested);
+                    break;
+                case CodecKind::object:
+                    inner = _dump_json_object<MapType>(field, *codec_plan(*step.nested));
+                    break;
             }
+            map.emplace(step.name, std::move(inner));
         }
         return json_parser::JsonObject{std::move(map)};
     }
 
     template <typename Serializable>
     json_parser::JsonObject dump_json_object(Serializable& object) {
-        try {
-            auto base = simple_reflection::ReflectionRegistryBase::instance().get_reflection(typeid(Serializable));
-            if (base.has_metadata("json_object_type")) {
-                if (base.get_metadata_as<std::string>("json_object_type") == "array_like") {
-                    return _dump_json_array(&object, base);
+        const auto base = simple_reflection::try_get_reflection(typeid(Serializable));
+        if (base == nullptr) {
+            throw std::runtime_error("type " + std::string(typeid(Serializable).name()) + " is not registered");
+        }
+        if (_is_array_like(*base)) {
+            return _dump_json_array(&object, *base);
+        }
+        return _dump_json_object(&object, *codec_plan(*base));
+    }
+
+    /**
+     * Dump an object like dump_json_object, but into JsonOrderedMaps, which keep the fields in the order of the
+     * registrations, so that print_object writes them in a deterministic order.
+     */
+    template <typename Serializable>
+    json_parser::JsonObject dump_json_ordered(Serializable& object) {
+        const auto base = simple_reflection::try_get_reflection(typeid(Serializable));
+        if (base == nullptr) {
+            throw std::runtime_error("type " + std::string(typeid(Serializable).name()) + " is not registered");
+        }
+        if (_is_array_like(*base)) {
+            return _dump_json_array<json_parser::JsonOrderedMap>(&object, *base);
+        }
+        return _dump_json_object<json_parser::JsonOrderedMap>(&object, *codec_plan(*base));
+    }
+
+    /**
+     * Dump only the members written since the changes of the object were last cleared.
+     * @note Changed nested objects and arrays are dumped as a whole.
+     * @note The changes are cleared unless told otherwise.
+     * @exception std::runtime_error If the type is not registered, or doesn't track its changes.
+     */
+    template <typename Serializable>
+    json_parser::JsonObject dump_delta(Serializable& object, const bool clear_changes = true) {
+        const auto base = simple_reflection::try_get_reflection(typeid(Serializable));
+        if (base == nullptr || !base->tracks_changes()) {
+            throw std::runtime_error("type " + std::string(typeid(Serializable).name()) + " doesn't track changes");
+        }
+        const auto dirty = base->get_dirty_set(&object);
+        auto delta = _dump_json_object(&object, *codec_plan(*base), dirty);
+        if (clear_changes) {
+            dirty->clear();
+        }
+        return delta;
+    }
+
+    /**
+     * A streaming encoder, which walks the reflected members and writes the bytes straight into a buffer.
+     * @note Unlike dump_json_object followed by print_object, no JsonObject tree is built,
+     * @note so fields are never copied: strings are escaped straight from the member,
+     * @note and numbers are formatted with std::to_chars.
+     * @note When constructed with a sink, the buffer is flushed into it whenever it grows past the threshold.
+     * @note Arrays are read in place through their "view", so the object is left untouched,
+     * @note and the same object can be serialized from several threads at once.
+     */
+    class JsonWriter {
+        std::string m_buffer;
+        std::ostream* m_sink = nullptr;
+        size_t m_flush_threshold = 0;
+
+    public:
+        JsonWriter() = default;
+
+        explicit JsonWriter(std::ostream& sink, const size_t flush_threshold = 4096)
+            : m_sink(&sink), m_flush_threshold(flush_threshold) {
+            m_buffer.reserve(flush_threshold);
+        }
+
+        JsonWriter(const JsonWriter&) = delete;
+
+        JsonWriter& operator=(const JsonWriter&) = delete;
+
+        ~JsonWriter() {
+            flush();
+        }
+
+        /**
+         * Encode an object.
+         * @param object The pointer to the object.
+         * @param reflection The reflection of the object.
+         */
+        void write(void* object, simple_reflection::ReflectionBase& reflection) {
+            const auto plan_owner = codec_plan(reflection);
+            const auto& plan = *plan_owner;
+            if (plan.array_like) {
+                _write_array(object, reflection, plan);
+            } else {
+                _write_object(object, plan);
+            }
+            _maybe_flush();
+        }
+
+        /**
+         * Encode only the members of an object marked in the DirtySet, as a JSON object.
+         */
+        void write_delta(void* object, simple_reflection::ReflectionBase& reflection,
+                         const simple_reflection::DirtySet& dirty) {
+            _write_object(object, *codec_plan(reflection), &dirty);
+            _maybe_flush();
+        }
+
+        [[nodiscard]] const std::string& buffer() const noexcept {
+            return m_buffer;
+        }
+
+        /**
+         * Take the encoded bytes out of the buffer, leaving it empty.
+         */
+        std::string take() noexcept {
+            return std::move(m_buffer);
+        }
+
+        /**
+         * Write the buffered bytes into the sink, if there's one.
+         */
+        void flush() {
+            if (m_sink != nullptr && !m_buffer.empty()) {
+                m_sink->write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                m_buffer.clear();
+            }
+        }
+
+    private:
+        void _maybe_flush() {
+            if (m_sink != nullptr && m_buffer.size() >= m_flush_threshold) {
+                flush();
+            }
+        }
+
+        void _write_string(const std::string_view str) {
+            _append_json_string(m_buffer, str);
+        }
+
+        template <typename NumberType>
+        void _write_number(const NumberType value) {
+            if constexpr (std::is_floating_point_v<NumberType>) {
+                if (!std::isfinite(value)) {
+                    // JSON has no representation of NaN and infinities.
+                    m_buffer.append("null");
+                    return;
+                }
+            }
+            char digits[32];
+            const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            m_buffer.append(digits, result.ptr);
+        }
+
+        void _write_field(void* field, const CodecKind kind, simple_reflection::ReflectionBase* nested) {
+            switch (kind) {
+                case CodecKind::string:
+                    _write_string(*static_cast<const std::string *>(field));
+                    break;
+                case CodecKind::integer:
+                    _write_number(*static_cast<const int *>(field));
+                    break;
+                case CodecKind::number:
+                    _write_number(*static_cast<const double *>(field));
+                    break;
+                case CodecKind::boolean:
+                    m_buffer.append(*static_cast<const bool *>(field) ? "true" : "false");
+                    break;
+                case CodecKind::null:
+                    throw std::runtime_error("nullable field is not supported");
+                case CodecKind::object:
+                    _write_object(field, *codec_plan(*nested));
+                    _maybe_flush();
+                    break;
+                case CodecKind::array:
+                    _write_array(field, *nested, *codec_plan(*nested));
+                    _maybe_flush();
+                    break;
+                case CodecKind::unsupported:
+                    m_buffer.append("null");
+                    break;
+            }
+        }
+
+        void _write_object(void* object, const CodecPlan& plan, const simple_reflection::DirtySet* dirty = nullptr) {
+            m_buffer.push_back('{');
+            bool first = true;
+            for (const auto& step: plan.fields) {
+                if (dirty != nullptr && !dirty->contains(step.table_index)) {
+                    continue;
+                }
+                if (!first) {
+                    m_buffer.push_back(',');
+                }
+                first = false;
+                m_buffer.append(step.key);
+                _write_field(static_cast<char *>(object) + step.offset, step.kind, step.nested);
+            }
+            m_buffer.push_back('}');
+        }
+
+        void _write_array(void* array, const simple_reflection::ReflectionBase& reflection, const CodecPlan& plan) {
+            JsonArrayView view;
+            if (!_array_view(array, plan, view)) {
+                throw std::runtime_error("array_like type " + reflection.get_type_string() + " exposes no view");
+            }
+
+            m_buffer.push_back('[');
+            for (size_t i = 0; i < view.size; ++i) {
+                if (i != 0) {
+                    m_buffer.push_back(',');
+                }
+                if (view.data != nullptr) {
+                    _write_field(const_cast<void *>(view.at(i)), plan.elem_kind, plan.elem_reflection);
+                } else if (plan.elem_kind == CodecKind::boolean) {
+                    m_buffer.append(plan.element.call<bool>(array, i) ? "true" : "false");
+                } else {
+                    throw std::runtime_error("unsupported array type");
                 }
             }
-            return _dump_json_object(&object, base);
-        } catch (const std::exception& e) {
+            m_buffer.push_back(']');
+        }
+    };
+
+    /**
+     * Serialize an object into a JSON string, with no intermediate JsonObject tree.
+     * @exception std::runtime_error If the type is not registered.
+     */
+    template <typename Serializable>
+    std::string to_json(Serializable& object) {
+        const auto base = simple_reflection::try_get_reflection(typeid(Serializable));
+        if (base == nullptr) {
+            throw std::runtime_error("type " + std::string(typeid(Serializable).name()) + " is not registered");
+        }
+        JsonWriter writer;
+        writer.write(&object, *base);
+        return writer.take();
+    }
+
+    /**
+     * Serialize an object into a stream, in chunks.
+     * @exception std::runtime_error If the type is not registered.
+     */
+    template <typename Serializable>
+    void to_json(Serializable& object, std::ostream& os) {
+        const auto base = simple_reflection::try_get_reflection(typeid(Serializable));
+        if (base == nullptr) {
             throw std::runtime_error("type " + std::string(typeid(Serializable).name()) + " is not registered");
         }
+        JsonWriter writer(os);
+        writer.write(&object, *base);
+    }
+
+    /**
+     * Serialize only the members written since the changes of the object were last cleared, see dump_delta.
+     * @note The result is a JSON object with a subset of the keys, which apply_delta merges into another object.
+     * @exception std::runtime_error If the type is not registered, or doesn't track its changes.
+     */
+    template <typename Serializable>
+    std::string to_json_delta(Serializable& object, const bool clear_changes = true) {
+        const auto base = simple_reflection::try_get_reflection(typeid(Serializable));
+        if (base == nullptr || !base->tracks_changes()) {
+            throw std::runtime_error("type " + std::string(typeid(Serializable).name()) + " doesn't track changes");
+        }
+        const auto dirty = base->get_dirty_set(&object);
+        JsonWriter writer;
+        writer.write_delta(&object, *base, *dirty);
+        if (clear_changes) {
+            dirty->clear();
+        }
+        return writer.take();
+    }
+
+    /**
+     * Merge a delta into an object: the members present in the delta are overwritten, the others are kept.
+     * @note The writes are not recorded in the DirtySet of the object.
+     * @exception std::runtime_error If the JSON is malformed, or the type is not registered.
+     */
+    template <typename Serializable>
+    void apply_delta(const std::string_view delta, Serializable& object) {
+        from_json_into(delta, object);
     }
 
 #define define_json_vector(_Type) \
-    static auto _refl_base_##_Type = simple_reflection::make_reflection<json_mapper::JsonVector<_Type>>() \
+    static auto& _refl_base_##_Type = simple_reflection::make_reflection<json_mapper::JsonVector<_Type>>() \
         .register_method<json_mapper::JsonVector<_Type>, size_t>("size", &json_mapper::JsonVector<_Type>::size) \
         .register_method<json_mapper::JsonVector<_Type>, _Type>("pop_back", &json_mapper::JsonVector<_Type>::pop_back) \
+        .register_method<&json_mapper::JsonVector<_Type>::view>("view") \
+        .register_method<&json_mapper::JsonVector<_Type>::element>("element") \
         .register_method<json_mapper::JsonVector<_Type>, void, _Type&&>("push_back",\
             &json_mapper::JsonVector<_Type>::push_back)\
         .register_function<json_mapper::JsonVector<_Type>>("ctor",\
@@ -678,7 +2092,7 @@ namespace json_parser_test {
         }
     };
 
-    static auto test_internal_refl = simple_reflection::make_reflection<TestInternal>()
+    static auto& test_internal_refl = simple_reflection::make_reflection<TestInternal>()
             .register_member<&TestInternal::str>("str")
             .register_member<&TestInternal::num>("num")
             .register_function<TestInternal>("ctor", []() { return TestInternal(); });
@@ -728,14 +2142,14 @@ namespace json_parser_test {
         }
     };
 
-    static auto test_list_elem_refl = simple_reflection::make_reflection<TestListElem>()
+    static auto& test_list_elem_refl = simple_reflection::make_reflection<TestListElem>()
             .register_member<&TestListElem::num>("num")
             .register_member<&TestListElem::str>("str")
             .register_function<TestListElem>("ctor", []() { return TestListElem(); });
 
     define_json_vector(TestListElem);
 
-    static auto test_refl = simple_reflection::make_reflection<Test>()
+    static auto& test_refl = simple_reflection::make_reflection<Test>()
             .register_member<&Test::name>("name")
             .register_member<&Test::age>("age")
             .register_member<&Test::height>("height")
@@ -782,14 +2196,276 @@ namespace json_parser_test {
         deserialized.print();
         test_helper::dbg_print("time elapsed: ", stopwatch.elapsed_ms(), "ms");
 
-        print_object(json_mapper::dump_json_object(deserialized), std::cout, false);
+        const auto dumped = json_mapper::dump_json_object(deserialized);
+        print_object(dumped, std::cout, false);
         std::cout << std::endl;
 
-        auto refl = simple_reflection::ReflectionRegistryBase::instance()
+        // dumping leaves the object untouched, and keeps the order of the arrays.
+        assert(deserialized.numbers.size() == 5 && deserialized.list.size() == 3);
+        const auto& dumped_fields = std::get<json_parser::JsonMap>(dumped.value);
+        const auto& dumped_numbers = std::get<json_parser::JsonArray>(dumped_fields.at("numbers").value);
+        assert(std::get<int>(dumped_numbers.front().value) == 1);
+        assert(json_mapper::dump_json_object(deserialized) == dumped);
+
+        // ordered dumps keep the fields in the order of the registrations, and compare whatever their order.
+        {
+            const auto ordered = json_mapper::dump_json_ordered(deserialized);
+            const auto& ordered_fields = std::get<json_parser::JsonOrderedMap>(ordered.value);
+            assert(ordered_fields.begin()->first == "name" && std::next(ordered_fields.begin())->first == "age");
+            assert(ordered_fields.size() == dumped_fields.size());
+            assert(ordered == json_mapper::dump_json_ordered(deserialized));
+            std::stringstream ss;
+            print_object(ordered, ss, false);
+            assert(ss.str().rfind(R"({"name": )", 0) == 0);
+
+            json_parser::JsonOrderedMap lhs, rhs;
+            lhs["b"].value = 1;
+            lhs["a"].value = 2;
+            lhs["b"].value = 3;
+            rhs.emplace("a", json_parser::JsonObject{2});
+            rhs.emplace("b", json_parser::JsonObject{3});
+            assert(lhs == rhs && lhs.begin()->first == "b" && lhs.at("b") == rhs.at("b"));
+        }
+
+        // std::vector<bool> is not addressable, so its elements are read one by one.
+        json_mapper::JsonVector<bool> flags;
+        flags.push_back(true);
+        flags.push_back(false);
+        assert(json_mapper::to_json(flags) == "[true,false]");
+        assert(json_mapper::dump_json_object(flags) == json_parser::parse_json_object("[true, false]"));
+
+        // the same, but every temporary is constructed in an arena instead of a separate heap allocation.
+        {
+            simple_reflection::ReflectionArena arena;
+            auto arena_proxy = json_mapper::from_json<Test>(json_str, arena);
+            const auto arena_deserialized = static_cast<Test *>(arena_proxy.get_raw());
+            assert(arena_deserialized->name == deserialized.name);
+            assert(arena_deserialized->internal.num == deserialized.internal.num);
+            assert(arena_deserialized->list.size() == 3);
+        }
+
+        // the streaming writer produces the same document as dump_json_object, and escapes strings.
+        {
+            Test streamed = deserialized;
+            Test dumped = deserialized;
+            streamed.name = "quote\" tab\t end";
+            dumped.name = streamed.name;
+            const auto json = json_mapper::to_json(streamed);
+            assert(json_parser::parse_json_object(json) == json_mapper::dump_json_object(dumped));
+
+            Test round_trip;
+            json_mapper::from_json_into(json, round_trip);
+            assert(round_trip.name == streamed.name && round_trip.height == 1.8);
+            assert(round_trip.list.size() == 3 && round_trip.numbers.size() == 5);
+
+            std::stringstream ss;
+            json_mapper::to_json(deserialized, ss);
+            assert(json_parser::parse_json_object(ss.str()) == json_parser::parse_json_object(
+                json_mapper::to_json(deserialized)));
+        }
+
+        // the DOM-based mapping gives the same result as the direct reader used by from_json.
+        {
+            simple_reflection::PhantomDataHelper phantom;
+            auto dom = json_parser::parse_json_object(json_str);
+            auto dom_proxy = json_mapper::map_fields(test_refl, std::get<json_parser::JsonMap>(dom.value), phantom);
+            const auto dom_deserialized = static_cast<Test *>(dom_proxy.get_raw());
+            assert(dom_deserialized->height == 1.8 && dom_deserialized->gender);
+            assert(dom_deserialized->internal.str == "Hello" && dom_deserialized->strings.size() == 3);
+        }
+
+        // unknown keys are skipped, null leaves the field untouched, and escapes are decoded.
+        {
+            Test direct;
+            direct.age = 7;
+            json_mapper::from_json_into(R"({"unknown": {"a": [1, {"b": null}], "c": "}"},
+                "age": null, "name": "a\"b\u00e9", "numbers": [], "list": [{"num": -3}]})", direct);
+            assert(direct.age == 7);
+            assert(direct.name == "a\"b\xc3\xa9");
+            assert(direct.numbers.empty());
+            assert(direct.list.size() == 1 && direct.list[0].num == -3);
+
+            bool thrown = false;
+            try {
+                json_mapper::from_json_into(R"({"age": 1)", direct);
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+
+        auto& refl = simple_reflection::ReflectionRegistryBase::instance()
             .get_reflection("json_mapper::JsonVector<std::string>");
         std::cout << refl.get_type_parsed().as_readable_format() << std::endl;
         // print_object(result);
     }
+
+    inline void test_structural_scan() {
+        using namespace json_parser::_internal;
+        test_helper::dbg_print("json scanning kernel: ", simd::kernel_name);
+
+        // runs of every length around the block size, so that both the blocks and the tails are exercised.
+        for (size_t n = 0; n < 3 * simd::block_size; ++n) {
+            const std::string spaces = std::string(n, ' ') + "x";
+            assert(simd::skip_whitespace(spaces.data(), spaces.data() + spaces.size()) == spaces.data() + n);
+            const std::string plain = std::string(n, 'a') + "\\\"";
+            assert(simd::find_quote_or_escape(plain.data(), plain.data() + plain.size()) == plain.data() + n);
+            const std::string space_only(n, '\t');
+            assert(simd::skip_whitespace(space_only.data(), space_only.data() + n) == space_only.data() + n);
+        }
+
+        assert(check_brackets(R"({"a": [1, {"b": "]}"}]})"));
+        assert(check_brackets(R"({"a": "\"}"})"));
+        assert(check_brackets(R"(["\\", []])"));
+        assert(!check_brackets(R"({"a": [})"));
+        assert(!check_brackets(R"({"a": "})"));
+        assert(!check_brackets("]"));
+
+        // an escaped quote and a bracket inside a string, right at a block boundary.
+        std::string padded = "[\"" + std::string(simd::block_size - 3, 'a') + "\\\"]\"]";
+        assert(check_brackets(padded));
+        auto parsed = json_parser::parse_json_object(padded);
+        const auto& array = std::get<json_parser::JsonArray>(parsed.value);
+        assert(std::get<std::string>(array[0].value) == std::string(simd::block_size - 3, 'a') + "\"]");
+
+        const auto numbers = json_parser::parse_json_object("[1, -2, 3.5, 1e3, 2147483648]");
+        const auto& values = std::get<json_parser::JsonArray>(numbers.value);
+        assert(std::get<int>(values[1].value) == -2);
+        assert(std::get<double>(values[2].value) == 3.5 && std::get<double>(values[3].value) == 1000.0);
+        assert(std::get<double>(values[4].value) == 2147483648.0);
+
+        bool thrown = false;
+        try {
+            json_parser::parse_json_object(R"({"a": 1}})");
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        std::vector<std::string_view> elements;
+        const std::string nested = R"( [ {"a": [1, 2]}, "x,]", 3 ] )";
+        assert(split_array(nested.data(), nested.data() + nested.size(), elements) && elements.size() == 3);
+        assert(elements[1] == R"( "x,]")");
+        elements.clear();
+        assert(split_array("[ ]", "[ ]" + 3, elements) && elements.empty());
+        assert(!split_array("[1, 2", "[1, 2" + 5, elements));
+        assert(!split_array("[1] 2", "[1] 2" + 5, elements));
+        assert(!split_array("{}", "{}" + 2, elements));
+    }
+
+    inline void test_parse_batch() {
+        std::string json_str = "[";
+        for (int i = 0; i < 1000; ++i) {
+            json_str += (i == 0 ? "" : ",\n") + std::string(R"({"num": )") + std::to_string(i) +
+                    R"(, "str": "item, [)" + std::to_string(i) + R"(]\"", "extra": {"k": [1, 2]}})";
+        }
+        json_str += "]";
+
+        simple_reflection::ThreadPool pool(4);
+        auto proxy = json_mapper::from_json_batch<json_mapper::JsonVector<TestListElem>>(json_str, pool, 16);
+        const auto& batch = *static_cast<json_mapper::JsonVector<TestListElem> *>(proxy.get_raw());
+        auto sequential = json_mapper::from_json<json_mapper::JsonVector<TestListElem>>(json_str);
+        const auto& expected = *static_cast<json_mapper::JsonVector<TestListElem> *>(sequential.get_raw());
+        assert(batch.std::vector<TestListElem>::size() == 1000);
+        for (size_t i = 0; i < expected.std::vector<TestListElem>::size(); ++i) {
+            assert(batch[i].num == expected[i].num && batch[i].str == expected[i].str);
+        }
+        assert(batch[999].num == 999 && batch[999].str == "item, [999]\"");
+
+        // primitives, and arrays too small to split, are parsed in place.
+        json_mapper::JsonVector<int> numbers;
+        json_mapper::from_json_batch_into("[1, 2, 3]", numbers, pool);
+        assert(numbers.size() == 3 && numbers[2] == 3);
+
+        bool thrown = false;
+        try {
+            json_mapper::from_json_batch<json_mapper::JsonVector<TestListElem>>(
+                json_str.substr(0, json_str.size() - 1), pool, 16);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        thrown = false;
+        try {
+            json_mapper::from_json_batch<json_mapper::JsonVector<TestListElem>>(
+                json_str.substr(0, json_str.size() - 1) + R"(, {"num": "x"}])", pool, 16);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    class TestLate {
+    public:
+        int value = 0;
+    };
+
+    class TestState {
+    public:
+        std::string name;
+        int version = 0;
+        json_mapper::JsonVector<int> numbers;
+        simple_reflection::DirtySet changes;
+    };
+
+    static auto& test_state_refl = simple_reflection::make_reflection<TestState>()
+            .register_member<&TestState::name>("name")
+            .register_member<&TestState::version>("version")
+            .register_member<&TestState::numbers>("numbers")
+            .register_function<TestState>("ctor", []() { return TestState(); })
+            .track_changes<&TestState::changes>();
+
+    inline void test_delta() {
+        TestState state;
+        state.name = "state";
+        state.numbers.push_back(1);
+        TestState replica = state;
+
+        assert(json_mapper::to_json_delta(state) == "{}");
+        int version = 2;
+        test_state_refl.set_member(&state, "version", simple_reflection::wrap_object(version));
+        const auto delta = json_mapper::to_json_delta(state, false);
+        assert(delta == R"({"version":2})");
+        const auto tree = json_mapper::dump_delta(state);
+        assert(std::get<json_parser::JsonMap>(tree.value).size() == 1 && !state.changes.any());
+
+        json_mapper::apply_delta(delta, replica);
+        assert(replica.version == 2 && replica.name == "state" && replica.numbers.size() == 1);
+        assert(!replica.changes.any());
+    }
+
+    inline void test_codec_plan() {
+        const auto plan = json_mapper::codec_plan(test_refl);
+        assert(json_mapper::codec_plan(test_refl) == plan);
+        assert(!plan->array_like && plan->fields.size() == 8);
+        size_t hint = 0;
+        const auto age = plan->find("age", hint);
+        Test test;
+        assert(age != nullptr && age->kind == json_mapper::CodecKind::integer);
+        assert(reinterpret_cast<char *>(&test) + age->offset == reinterpret_cast<char *>(&test.age));
+        assert(age->key == R"("age":)");
+        assert(plan->find("internal", hint)->kind == json_mapper::CodecKind::object);
+        assert(plan->find("internal", hint)->nested == &test_internal_refl);
+        assert(plan->find("list", hint)->kind == json_mapper::CodecKind::array);
+        assert(plan->find("missing", hint) == nullptr);
+
+        const auto list_plan = json_mapper::codec_plan(*plan->find("list", hint)->nested);
+        assert(list_plan->array_like && list_plan->elem_kind == json_mapper::CodecKind::object);
+        assert(list_plan->elem_reflection == &test_list_elem_refl && list_plan->push_back && list_plan->view);
+
+        // registering an unrelated type leaves the existing plans valid, and cached.
+        simple_reflection::make_reflection<TestLate>().register_member<&TestLate::value>("value");
+        assert(json_mapper::codec_plan(test_refl) == plan);
+        assert(json_mapper::codec_plan(*plan->find("list", hint)->nested) == list_plan);
+        assert(plan->find("age", hint) == age && age->key == R"("age":)");
+
+        // attaching metadata builds the plans of the type anew, the held ones stay valid.
+        auto& late_refl = simple_reflection::get_reflection(typeid(TestLate));
+        const auto late_plan = json_mapper::codec_plan(late_refl);
+        assert(!late_plan->array_like && late_plan->fields.size() == 1);
+        late_refl.attach_metadata("json_object_type", "array_like");
+        assert(json_mapper::codec_plan(late_refl)->array_like && !late_plan->array_like);
+    }
 }
 
 #endif //JSON_PARSER_H
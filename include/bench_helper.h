@@ -0,0 +1,381 @@
+//
+// Created on 2025/4/2.
+//
+
+#ifndef BENCH_HELPER_H
+#define BENCH_HELPER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+/** Microbenchmark harness for the reflection hot paths. */
+namespace bench_helper {
+    /**
+     * Counters bumped by the operator new defined by BENCH_HELPER_DEFINE_ALLOCATION_HOOKS.
+     * @note They stay at zero if no translation unit defines the hooks.
+     */
+    struct AllocationCounters {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> bytes{0};
+
+        static AllocationCounters& instance() {
+            static AllocationCounters counters;
+            return counters;
+        }
+
+        void record(const size_t size) {
+            count.fetch_add(1, std::memory_order_relaxed);
+            bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * Keep the compiler from discarding a value computed by the benchmark body.
+     */
+    template <typename T>
+    void do_not_optimize(T& value) {
+#if defined (__GNUC__) || defined (__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    template <typename T>
+    void do_not_optimize(const T& value) {
+        do_not_optimize(const_cast<T&>(value));
+    }
+
+    enum class OutputFormat {
+        text,
+        json,
+        csv
+    };
+
+    struct Options {
+        /** Number of timed samples per benchmark. */
+        size_t samples = 51;
+        /** Number of discarded samples run after calibration. */
+        size_t warmup_samples = 5;
+        /** Each sample repeats the body until it takes at least this long. */
+        std::chrono::nanoseconds min_sample_time = std::chrono::microseconds(200);
+        /** Only benchmarks whose name contains this string are run. */
+        std::string filter;
+        OutputFormat format = OutputFormat::text;
+    };
+
+    /**
+     * Print the options accepted by parse_options.
+     * @param out The stream to print to.
+     * @param program The name of the executable.
+     */
+    inline void print_usage(std::ostream& out, const char* program) {
+        out << "usage: " << program << " [options]\n"
+               "  --format=text|json|csv  output format, text by default\n"
+               "  --filter=<substring>    only run the benchmarks whose name contains it\n"
+               "  --samples=<n>           number of timed samples per benchmark\n"
+               "  --min-time-us=<n>       minimal duration of one sample in microseconds\n"
+               "  --help                  print this message\n";
+    }
+
+    /**
+     * Parse `--format=text|json|csv`, `--filter=<substring>`, `--samples=<n>` and `--min-time-us=<n>`.
+     * @note `--help` prints the usage to std::cout and exits with 0.
+     * @note Unknown arguments and malformed values print the usage to std::cerr and exit with 2,
+     * @note so that a typo doesn't silently run every benchmark with the default settings.
+     */
+    inline Options parse_options(const int argc, const char* const* argv) {
+        const char* program = argc > 0 ? argv[0] : "bench";
+        const auto reject = [program](const std::string& message) {
+            std::cerr << program << ": " << message << std::endl;
+            print_usage(std::cerr, program);
+            std::exit(2);
+        };
+        const auto parse_count = [&reject](const std::string& argument, const char* value) {
+            char* end = nullptr;
+            const auto count = std::strtoull(value, &end, 10);
+            if (*value == '\0' || *value == '-' || *end != '\0') {
+                reject("invalid number in " + argument);
+            }
+            return static_cast<size_t>(count);
+        };
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            const auto value_of = [&argument](const char* prefix) -> const char* {
+                const auto length = std::strlen(prefix);
+                return argument.compare(0, length, prefix) == 0 ? argument.c_str() + length : nullptr;
+            };
+            if (argument == "--help" || argument == "-h") {
+                print_usage(std::cout, program);
+                std::exit(0);
+            }
+            if (const auto value = value_of("--format=")) {
+                const std::string format = value;
+                if (format == "json") {
+                    options.format = OutputFormat::json;
+                } else if (format == "csv") {
+                    options.format = OutputFormat::csv;
+                } else if (format == "text") {
+                    options.format = OutputFormat::text;
+                } else {
+                    reject("unknown format: " + format);
+                }
+            } else if (const auto filter = value_of("--filter=")) {
+                options.filter = filter;
+            } else if (const auto samples = value_of("--samples=")) {
+                options.samples = std::max<size_t>(1, parse_count(argument, samples));
+            } else if (const auto min_time = value_of("--min-time-us=")) {
+                options.min_sample_time = std::chrono::microseconds(parse_count(argument, min_time));
+            } else {
+                reject("unknown argument: " + argument);
+            }
+        }
+        return options;
+    }
+
+    /**
+     * Statistics of one benchmark, per iteration of its body.
+     */
+    struct Result {
+        std::string name;
+        size_t iterations = 0;
+        size_t samples = 0;
+        double min_ns = 0;
+        double median_ns = 0;
+        double p99_ns = 0;
+        double mean_ns = 0;
+        double allocations = 0;
+        double allocated_bytes = 0;
+    };
+
+    class Harness {
+        using Clock = std::chrono::steady_clock;
+
+        Options m_options;
+        std::vector<Result> m_results;
+
+        template <typename Body>
+        static double _time_batch(Body& body, const size_t iterations) {
+            const auto start = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                body();
+            }
+            const auto end = Clock::now();
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+
+        static double _percentile(const std::vector<double>& sorted, const double percentile) {
+            const auto rank = static_cast<size_t>(percentile * static_cast<double>(sorted.size()) + 0.5);
+            return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+        }
+
+        static void _write_json_string(std::ostream& os, const std::string& str) {
+            os << '"';
+            for (const char c: str) {
+                if (c == '"' || c == '\\') {
+                    os << '\\';
+                }
+                os << c;
+            }
+            os << '"';
+        }
+
+    public:
+        explicit Harness(Options options): m_options(std::move(options)) {
+        }
+
+        [[nodiscard]] const Options& options() const {
+            return m_options;
+        }
+
+        [[nodiscard]] const std::vector<Result>& results() const {
+            return m_results;
+        }
+
+        /**
+         * Calibrate, warm up and sample the body.
+         * @note The iteration count is doubled until one batch takes at least Options::min_sample_time,
+         * @note then every sample runs that many iterations.
+         * @note Allocations are only counted during the timed samples.
+         */
+        template <typename Body>
+        void run(const std::string& name, Body&& body) {
+            if (!m_options.filter.empty() && name.find(m_options.filter) == std::string::npos) {
+                return;
+            }
+
+            const auto min_sample_ns = static_cast<double>(m_options.min_sample_time.count());
+            size_t iterations = 1;
+            while (_time_batch(body, iterations) < min_sample_ns && iterations < (size_t{1} << 30)) {
+                iterations *= 2;
+            }
+            for (size_t i = 0; i < m_options.warmup_samples; ++i) {
+                _time_batch(body, iterations);
+            }
+
+            auto& counters = AllocationCounters::instance();
+            const auto allocations_before = counters.count.load(std::memory_order_relaxed);
+            const auto bytes_before = counters.bytes.load(std::memory_order_relaxed);
+
+            std::vector<double> samples;
+            samples.reserve(m_options.samples);
+            for (size_t i = 0; i < m_options.samples; ++i) {
+                samples.push_back(_time_batch(body, iterations) / static_cast<double>(iterations));
+            }
+
+            const auto total = static_cast<double>(iterations * m_options.samples);
+            Result result;
+            result.name = name;
+            result.iterations = iterations;
+            result.samples = samples.size();
+            result.allocations = static_cast<double>(
+                                     counters.count.load(std::memory_order_relaxed) - allocations_before) / total;
+            result.allocated_bytes = static_cast<double>(
+                                         counters.bytes.load(std::memory_order_relaxed) - bytes_before) / total;
+            for (const auto sample: samples) {
+                result.mean_ns += sample;
+            }
+            result.mean_ns /= static_cast<double>(samples.size());
+            std::sort(samples.begin(), samples.end());
+            result.min_ns = samples.front();
+            result.median_ns = _percentile(samples, 0.5);
+            result.p99_ns = _percentile(samples, 0.99);
+            m_results.push_back(std::move(result));
+        }
+
+        void report(std::ostream& os) const {
+            switch (m_options.format) {
+                case OutputFormat::json:
+                    os << "[\n";
+                    for (size_t i = 0; i < m_results.size(); ++i) {
+                        const auto& result = m_results[i];
+                        os << "  {\"name\": ";
+                        _write_json_string(os, result.name);
+                        os << ", \"iterations\": " << result.iterations
+                                << ", \"samples\": " << result.samples
+                                << ", \"min_ns\": " << result.min_ns
+                                << ", \"median_ns\": " << result.median_ns
+                                << ", \"p99_ns\": " << result.p99_ns
+                                << ", \"mean_ns\": " << result.mean_ns
+                                << ", \"allocations\": " << result.allocations
+                                << ", \"allocated_bytes\": " << result.allocated_bytes << "}"
+                                << (i + 1 == m_results.size() ? "\n" : ",\n");
+                    }
+                    os << "]" << std::endl;
+                    break;
+                case OutputFormat::csv:
+                    os << "name,iterations,samples,min_ns,median_ns,p99_ns,mean_ns,allocations,allocated_bytes\n";
+                    for (const auto& result: m_results) {
+                        os << result.name << ',' << result.iterations << ',' << result.samples << ','
+                                << result.min_ns << ',' << result.median_ns << ',' << result.p99_ns << ','
+                                << result.mean_ns << ',' << result.allocations << ','
+                                << result.allocated_bytes << '\n';
+                    }
+                    os << std::flush;
+                    break;
+                case OutputFormat::text:
+                default:
+                    os << std::left << std::setw(48) << "benchmark" << std::right
+                            << std::setw(12) << "min ns" << std::setw(12) << "median ns"
+                            << std::setw(12) << "p99 ns" << std::setw(10) << "allocs" << std::setw(12) << "bytes"
+                            << '\n';
+                    os << std::fixed << std::setprecision(1);
+                    for (const auto& result: m_results) {
+                        os << std::left << std::setw(48) << result.name << std::right
+                                << std::setw(12) << result.min_ns << std::setw(12) << result.median_ns
+                                << std::setw(12) << result.p99_ns << std::setw(10) << result.allocations
+                                << std::setw(12) << result.allocated_bytes << '\n';
+                    }
+                    os << std::defaultfloat << std::flush;
+                    break;
+            }
+        }
+    };
+}
+
+/**
+ * Replace the global operator new/delete with versions that feed bench_helper::AllocationCounters.
+ * @note The aligned overloads are replaced too, so over-aligned allocations are counted, and never reach
+ * @note the default aligned delete with memory from std::malloc.
+ * @note Expand it exactly once, at global scope, in the benchmark executable.
+ */
+#define BENCH_HELPER_DEFINE_ALLOCATION_HOOKS() \
+    void* operator new(const std::size_t size) { \
+        bench_helper::AllocationCounters::instance().record(size); \
+        if (void* ptr = std::malloc(size == 0 ? 1 : size)) { \
+            return ptr; \
+        } \
+        throw std::bad_alloc(); \
+    } \
+    void* operator new[](const std::size_t size) { \
+        return operator new(size); \
+    } \
+    void* operator new(const std::size_t size, const std::nothrow_t&) noexcept { \
+        bench_helper::AllocationCounters::instance().record(size); \
+        return std::malloc(size == 0 ? 1 : size); \
+    } \
+    void* operator new[](const std::size_t size, const std::nothrow_t& tag) noexcept { \
+        return operator new(size, tag); \
+    } \
+    void operator delete(void* ptr) noexcept { \
+        std::free(ptr); \
+    } \
+    void operator delete[](void* ptr) noexcept { \
+        std::free(ptr); \
+    } \
+    void operator delete(void* ptr, std::size_t) noexcept { \
+        std::free(ptr); \
+    } \
+    void operator delete[](void* ptr, std::size_t) noexcept { \
+        std::free(ptr); \
+    } \
+    void* operator new(const std::size_t size, const std::align_val_t alignment) { \
+        if (void* ptr = operator new(size, alignment, std::nothrow)) { \
+            return ptr; \
+        } \
+        throw std::bad_alloc(); \
+    } \
+    void* operator new[](const std::size_t size, const std::align_val_t alignment) { \
+        return operator new(size, alignment); \
+    } \
+    void* operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept { \
+        bench_helper::AllocationCounters::instance().record(size); \
+        const auto align = static_cast<std::size_t>(alignment); \
+        /* aligned_alloc wants a non-zero size which is a multiple of the alignment. */ \
+        return std::aligned_alloc(align, std::max<std::size_t>(1, (size + align - 1) / align) * align); \
+    } \
+    void* operator new[](const std::size_t size, const std::align_val_t alignment, \
+                         const std::nothrow_t& tag) noexcept { \
+        return operator new(size, alignment, tag); \
+    } \
+    void operator delete(void* ptr, std::align_val_t) noexcept { \
+        std::free(ptr); \
+    } \
+    void operator delete[](void* ptr, std::align_val_t) noexcept { \
+        std::free(ptr); \
+    } \
+    void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { \
+        std::free(ptr); \
+    } \
+    void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { \
+        std::free(ptr); \
+    } \
+    void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { \
+        std::free(ptr); \
+    } \
+    void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { \
+        std::free(ptr); \
+    }
+
+#endif //BENCH_HELPER_H
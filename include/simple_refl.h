@@ -25,6 +25,30 @@
 #include <map>
 #include <optional>
 #include <stack>
+#include <array>
+#include <new>
+#include <memory_resource>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <string_view>
+#include <unordered_set>
+#include <deque>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined (__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define SIMPLE_REFL_HAS_COROUTINES 1
+#else
+#define SIMPLE_REFL_HAS_COROUTINES 0
+#endif
+
+#ifndef SIMPLE_REFL_ENABLE_STATS
+#define SIMPLE_REFL_ENABLE_STATS 0
+#endif
 
 #define make_args(...) simple_reflection::refl_args(__VA_ARGS__)
 
@@ -171,79 +195,475 @@ namespace simple_reflection {
         return full_string.find(sub_string) != std::string::npos;
     }
 
-    inline std::string _remove_redundant_space(const std::string& full_string) {
-        std::string result = full_string;
-        while (result.find(' ') != std::string::npos) {
-            result.erase(result.find(' '), 1);
-        }
-        return result;
-    }
-
-    inline std::string _string_replace(std::string& full_string, const std::string& sub_string,
-                                       const std::string& replacement) {
-        return full_string.replace(full_string.find(sub_string), sub_string.length(), replacement);
+    template <typename T>
+    constexpr const char* _type_signature(const std::string* = nullptr) {
+#if defined (__GNUC__) || defined (__clang__)
+        return __PRETTY_FUNCTION__;
+#elif defined (_MSC_VER)
+        return __FUNCSIG__;
+#else
+        return "";
+#endif
     }
 
-    inline std::string _extract_type(std::string& full_string) {
-        size_t begin = full_string.find("[with T = ") + 9;
-        size_t end = full_string.find(']');
+#if defined (__GNUC__) || defined (__clang__) || defined (_MSC_VER)
+#define SIMPLE_REFL_CONSTEXPR_TYPE_NAME 1
+#else
+#define SIMPLE_REFL_CONSTEXPR_TYPE_NAME 0
+#endif
 
-        std::vector<size_t> semicolons;
-        for (size_t i = begin; i < end; ++i) {
-            if (full_string[i] == ';') {
-                semicolons.push_back(i);
+    /**
+     * Match the pattern at the beginning of the text, ignoring the spaces in both.
+     * @return The number of characters of the text matched, or 0 if it does not match.
+     */
+    constexpr size_t _match_ignoring_space(const std::string_view text, const std::string_view pattern) {
+        size_t i = 0;
+        size_t j = 0;
+        while (j < pattern.size()) {
+            if (pattern[j] == ' ') {
+                ++j;
+            } else if (i < text.size() && text[i] == ' ') {
+                ++i;
+            } else if (i < text.size() && text[i] == pattern[j]) {
+                ++i;
+                ++j;
+            } else {
+                return 0;
             }
         }
+        return i;
+    }
 
-        std::vector<std::string> segments;
-        for (size_t i = 0; i < semicolons.size(); ++i) {
-            size_t start = i == 0 ? begin : semicolons[i - 1] + 1;
-            size_t stop = semicolons[i];
-            segments.push_back(_remove_redundant_space(full_string.substr(start, stop - start)));
-        }
-        segments.push_back(
-            _remove_redundant_space(full_string.substr(semicolons.back() + 1, end - semicolons.back() - 1)));
-
-        std::string base_type = _remove_redundant_space(segments[0]);
-        std::map<std::string, std::string> aliases;
-        aliases["T"] = base_type;
-        for (size_t i = 1; i < segments.size(); ++i) {
-            size_t equal_sign = segments[i].find('=');
-            std::string alias = _remove_redundant_space(segments[i].substr(0, equal_sign));
-            std::string type = _remove_redundant_space(segments[i].substr(equal_sign + 1));
-            aliases[alias] = type;
+    /**
+     * Turn the signature of _type_signature<T>() into the name of T.
+     * @note With GCC, the aliases listed after T (e.g. std::string) are substituted back into the name,
+     * @note and the spaces are removed, so that std::vector<std::string> is spelt like that.
+     * @param signature The signature.
+     * @param out The buffer to write the name to, or nullptr to only measure it.
+     * @return The length of the name.
+     */
+    constexpr size_t _normalize_type_name(const std::string_view signature, char* out) {
+#if defined (__GNUC__) || defined (__clang__)
+        constexpr size_t max_aliases = 8;
+        const size_t begin = signature.find("T = ") + 4;
+        const size_t close = signature.rfind(']');
+        size_t end = signature.find(';', begin);
+        if (end == std::string_view::npos || end > close) {
+            end = close;
+        }
+
+        std::string_view alias_names[max_aliases] = {};
+        std::string_view alias_values[max_aliases] = {};
+        size_t alias_count = 0;
+        for (size_t segment = end; segment < close && alias_count < max_aliases;) {
+            size_t next = signature.find(';', segment + 1);
+            if (next == std::string_view::npos || next > close) {
+                next = close;
+            }
+            const auto alias = signature.substr(segment + 1, next - segment - 1);
+            if (const size_t equal_sign = alias.find(" = "); equal_sign != std::string_view::npos) {
+                alias_names[alias_count] = alias.substr(0, equal_sign);
+                alias_values[alias_count] = alias.substr(equal_sign + 3);
+                ++alias_count;
+            }
+            segment = next;
         }
 
-
-        for (auto it = aliases.rbegin(); it != aliases.rend(); ++it) {
-            for (auto it2 = aliases.rbegin(); it2 != aliases.rend(); ++it2) {
-                if (it == it2) continue;
-                if (string_contains(it2->second, it->second)) {
-                    _string_replace(it2->second, it->second, it->first);
+        const auto type = signature.substr(begin, end - begin);
+        size_t length = 0;
+        const auto emit = [&](const std::string_view text) {
+            for (const char c: text) {
+                if (c == ' ') {
+                    continue;
+                }
+                if (out != nullptr) {
+                    out[length] = c;
                 }
+                ++length;
+            }
+        };
+        for (size_t i = 0; i < type.size();) {
+            size_t matched = 0;
+            for (size_t a = 0; a < alias_count && matched == 0; ++a) {
+                matched = _match_ignoring_space(type.substr(i), alias_values[a]);
+                if (matched != 0) {
+                    emit(alias_names[a]);
+                }
+            }
+            if (matched == 0) {
+                emit(type.substr(i, 1));
+                matched = 1;
+            }
+            i += matched;
+        }
+        return length;
+#elif defined (_MSC_VER)
+        const size_t begin = signature.find("_type_signature<") + 16;
+        const size_t end = signature.rfind(">(");
+        if (out != nullptr) {
+            for (size_t i = begin; i < end; ++i) {
+                out[i - begin] = signature[i];
             }
         }
-        return aliases["T"];
+        return end - begin;
+#else
+        static_cast<void>(signature);
+        static_cast<void>(out);
+        return 0;
+#endif
     }
 
+    template <typename T>
+    struct _type_name_storage {
+        static constexpr std::string_view signature = _type_signature<T>();
+        static constexpr size_t length = _normalize_type_name(signature, nullptr);
+        static constexpr std::array<char, length + 1> value = [] {
+            std::array<char, length + 1> buffer = {};
+            _normalize_type_name(signature, buffer.data());
+            return buffer;
+        }();
+    };
+
+    /**
+     * The name of a type, computed at compile time.
+     * @note Only available where SIMPLE_REFL_CONSTEXPR_TYPE_NAME is 1, use extract_type_name<T>() otherwise.
+     * @code
+     * static_assert(type_name_v<my_namespace::MyType> == "my_namespace::MyType");
+     * @endcode
+     */
+    template <typename T>
+    constexpr std::string_view type_name_v{_type_name_storage<T>::value.data(), _type_name_storage<T>::length};
+
     template <typename T>
     std::string extract_type_name() {
-        std::string fn_sig;
-        std::string type_name;
-#if defined (__GNUC__) || defined (__clang__)
-        fn_sig = __PRETTY_FUNCTION__;
-        type_name = _extract_type(fn_sig);
-#elif defined (_MSC_VER)
-        fn_sig = __FUNCSIG__;
-        size_t start = fn_sig.find("extract_type_name<") + 13;
-        size_t end = fn_sig.find(">(void)");
-        type_name = fn_sig.substr(start, end - start);
+#if SIMPLE_REFL_CONSTEXPR_TYPE_NAME
+        return std::string(type_name_v<T>);
 #else
         return std::string(typeid(T).name());
 #endif
-        return type_name;
     }
 
+    /**
+     * The set of all the type names, each stored once.
+     * @note Interned names of the same text share the same address, so they are compared by their data pointers.
+     * @note Names are never removed, so the views stay valid for the lifetime of the program.
+     */
+    class TypeNameInterner {
+        mutable std::shared_mutex m_mutex;
+        std::unordered_set<std::string_view> m_names;
+        std::deque<std::string> m_owned;
+
+    public:
+        static TypeNameInterner& instance() {
+            static TypeNameInterner _instance;
+            return _instance;
+        }
+
+        /**
+         * Intern a name, copying it if it is not interned yet.
+         */
+        std::string_view intern(const std::string_view name) {
+            if (const auto interned = find(name); interned.data() != nullptr) {
+                return interned;
+            }
+            std::unique_lock lock(m_mutex);
+            if (const auto find = m_names.find(name); find != m_names.end()) {
+                return *find;
+            }
+            return *m_names.insert(m_owned.emplace_back(name)).first;
+        }
+
+        /**
+         * Intern a name which outlives the interner, e.g. type_name_v<T>, without copying it.
+         */
+        std::string_view intern_static(const std::string_view name) {
+            if (const auto interned = find(name); interned.data() != nullptr) {
+                return interned;
+            }
+            std::unique_lock lock(m_mutex);
+            return *m_names.insert(name).first;
+        }
+
+        /**
+         * Find an interned name.
+         * @return The interned view, or an empty view with a null data pointer if the name is not interned.
+         */
+        [[nodiscard]] std::string_view find(const std::string_view name) const noexcept {
+            std::shared_lock lock(m_mutex);
+            if (const auto find = m_names.find(name); find != m_names.end()) {
+                return *find;
+            }
+            return {};
+        }
+    };
+
+    /**
+     * An interned name of a member, a method or a metadata entry.
+     * @note Symbols of the same text are equal, and compare as one pointer.
+     * @note Constructing a symbol interns the text, Symbol::find() only looks it up,
+     * @note so looking up a name that was never registered does not grow the table.
+     * @code
+     * static const Symbol x_symbol("x");
+     * reflection.find_member(x_symbol);
+     * @endcode
+     */
+    class Symbol {
+    public:
+        struct Entry {
+            std::string text;
+            uint32_t id;
+        };
+
+    private:
+        const Entry* m_entry = nullptr;
+
+        explicit Symbol(const Entry* entry) noexcept : m_entry(entry) {
+        }
+
+        /**
+         * The table of all the symbols, entries are never removed.
+         * @note The index is an open addressing hash table whose slots are only ever filled in,
+         * @note and which is replaced by one twice the size once half full, so lookups never lock.
+         * @note Replaced indices are kept, they take less memory than the last one all together.
+         */
+        class Table {
+            struct Index {
+                explicit Index(const size_t capacity)
+                    : mask(capacity - 1), slots(std::make_unique<std::atomic<const Entry*>[]>(capacity)) {
+                }
+
+                size_t mask;
+                std::unique_ptr<std::atomic<const Entry*>[]> slots;
+            };
+
+            std::mutex m_mutex;
+            std::atomic<const Index*> m_index{nullptr};
+            std::vector<std::unique_ptr<const Index>> m_indices;
+            std::deque<Entry> m_entries;
+
+            static const Entry* _probe(const Index& index, const std::string_view text, size_t i) noexcept {
+                while (true) {
+                    const auto entry = index.slots[i & index.mask].load(std::memory_order_acquire);
+                    if (entry == nullptr || entry->text == text) {
+                        return entry;
+                    }
+                    ++i;
+                }
+            }
+
+            static void _insert(const Index& index, const Entry& entry) noexcept {
+                size_t i = std::hash<std::string_view>()(entry.text);
+                while (index.slots[i & index.mask].load(std::memory_order_relaxed) != nullptr) {
+                    ++i;
+                }
+                index.slots[i & index.mask].store(&entry, std::memory_order_release);
+            }
+
+            void _grow() {
+                const auto current = m_index.load(std::memory_order_relaxed);
+                auto grown = std::make_unique<const Index>(current == nullptr ? 64 : (current->mask + 1) * 2);
+                for (const auto& entry: m_entries) {
+                    _insert(*grown, entry);
+                }
+                m_index.store(grown.get(), std::memory_order_release);
+                m_indices.push_back(std::move(grown));
+            }
+
+        public:
+            static Table& instance() {
+                static Table _instance;
+                return _instance;
+            }
+
+            const Entry* find(const std::string_view text) const noexcept {
+                const auto index = m_index.load(std::memory_order_acquire);
+                if (index == nullptr) {
+                    return nullptr;
+                }
+                return _probe(*index, text, std::hash<std::string_view>()(text));
+            }
+
+            const Entry* intern(const std::string_view text) {
+                if (const auto entry = find(text)) {
+                    return entry;
+                }
+                std::lock_guard lock(m_mutex);
+                if (const auto entry = find(text)) {
+                    return entry;
+                }
+                const auto& entry = m_entries.emplace_back(
+                    Entry{std::string(text), static_cast<uint32_t>(m_entries.size())});
+                const auto index = m_index.load(std::memory_order_relaxed);
+                if (index == nullptr || m_entries.size() * 2 > index->mask + 1) {
+                    _grow();
+                } else {
+                    _insert(*index, entry);
+                }
+                return &entry;
+            }
+        };
+
+    public:
+        Symbol() noexcept = default;
+
+        explicit Symbol(const std::string_view text) : m_entry(Table::instance().intern(text)) {
+        }
+
+        /**
+         * Find the symbol of a text, without interning it.
+         * @return The symbol, or an invalid one if the text was never interned.
+         */
+        static Symbol find(const std::string_view text) noexcept {
+            return Symbol(Table::instance().find(text));
+        }
+
+        [[nodiscard]] bool valid() const noexcept {
+            return m_entry != nullptr;
+        }
+
+        explicit operator bool() const noexcept {
+            return valid();
+        }
+
+        /**
+         * The id of the symbol, which is dense and in the order of interning.
+         */
+        [[nodiscard]] uint32_t id() const noexcept {
+            return m_entry->id;
+        }
+
+        [[nodiscard]] const std::string& str() const noexcept {
+            return m_entry->text;
+        }
+
+        [[nodiscard]] std::string_view view() const noexcept {
+            return m_entry == nullptr ? std::string_view() : std::string_view(m_entry->text);
+        }
+
+        friend bool operator==(const Symbol lhs, const Symbol rhs) noexcept {
+            return lhs.m_entry == rhs.m_entry;
+        }
+
+        friend bool operator!=(const Symbol lhs, const Symbol rhs) noexcept {
+            return lhs.m_entry != rhs.m_entry;
+        }
+
+        friend bool operator<(const Symbol lhs, const Symbol rhs) noexcept {
+            return lhs.id() < rhs.id();
+        }
+    };
+
+    /**
+     * A small map keyed by symbols, stored as a sorted array.
+     * @note Tables of reflections rarely have more than a few dozen entries,
+     * @note for which a binary search over one contiguous array beats hashing the name.
+     * @note Any insertion may move the values, like std::vector.
+     * @note Values only need to be move constructible, Member for instance is not assignable.
+     * @tparam Value The type of the values.
+     */
+    template <typename Value>
+    class SymbolMap {
+        std::vector<std::pair<Symbol, Value>> m_entries;
+
+        auto _lower_bound(const Symbol key) const noexcept {
+            return std::lower_bound(m_entries.begin(), m_entries.end(), key,
+                                    [](const std::pair<Symbol, Value>& entry, const Symbol value) {
+                                        return entry.first < value;
+                                    });
+        }
+
+    public:
+        using value_type = std::pair<Symbol, Value>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        iterator begin() noexcept {
+            return m_entries.begin();
+        }
+
+        iterator end() noexcept {
+            return m_entries.end();
+        }
+
+        const_iterator begin() const noexcept {
+            return m_entries.begin();
+        }
+
+        const_iterator end() const noexcept {
+            return m_entries.end();
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_entries.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return m_entries.empty();
+        }
+
+        void reserve(const size_t capacity) {
+            m_entries.reserve(capacity);
+        }
+
+        [[nodiscard]] const Value* find(const Symbol key) const noexcept {
+            if (!key) {
+                return nullptr;
+            }
+            const auto it = _lower_bound(key);
+            return it != m_entries.end() && it->first == key ? &it->second : nullptr;
+        }
+
+        [[nodiscard]] Value* find(const Symbol key) noexcept {
+            return const_cast<Value *>(static_cast<const SymbolMap&>(*this).find(key));
+        }
+
+        [[nodiscard]] const Value* find(const std::string_view key) const noexcept {
+            return find(Symbol::find(key));
+        }
+
+        [[nodiscard]] Value* find(const std::string_view key) noexcept {
+            return find(Symbol::find(key));
+        }
+
+        [[nodiscard]] bool contains(const std::string_view key) const noexcept {
+            return find(key) != nullptr;
+        }
+
+        /**
+         * Insert a value if the key is not in the map yet.
+         * @return The value of the key, and whether it was inserted.
+         */
+        template <typename... ArgTypes>
+        std::pair<Value*, bool> try_emplace(const Symbol key, ArgTypes&&... args) {
+            const auto index = static_cast<size_t>(_lower_bound(key) - m_entries.cbegin());
+            if (index < m_entries.size() && m_entries[index].first == key) {
+                return {&m_entries[index].second, false};
+            }
+            if (index == m_entries.size()) {
+                m_entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key),
+                                       std::forward_as_tuple(std::forward<ArgTypes>(args)...));
+                return {&m_entries.back().second, true};
+            }
+            // rebuilt rather than shifted, so that the values are never assigned.
+            std::vector<value_type> entries;
+            entries.reserve(m_entries.size() + 1);
+            for (size_t i = 0; i < index; ++i) {
+                entries.push_back(std::move(m_entries[i]));
+            }
+            entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key),
+                                 std::forward_as_tuple(std::forward<ArgTypes>(args)...));
+            for (size_t i = index; i < m_entries.size(); ++i) {
+                entries.push_back(std::move(m_entries[i]));
+            }
+            m_entries = std::move(entries);
+            return {&m_entries[index].second, true};
+        }
+
+        Value& operator[](const Symbol key) {
+            return *try_emplace(key).first;
+        }
+    };
+
     struct ParsedTypeString {
         std::string type_name;
         std::vector<std::string> namespaces;
@@ -341,33 +761,45 @@ namespace simple_reflection {
         return result;
     }
 
+    /**
+     * @note The message is built once in the constructor, so what() neither allocates nor writes to stderr.
+     * @note On hot paths where a missing method is expected, prefer the try_* counterparts, which do not throw.
+     */
     class method_not_found_exception final : public std::exception {
         std::string method_name;
+        std::string message;
 
     public:
-        explicit method_not_found_exception(std::string method_name) : method_name(std::move(method_name)) {
+        explicit method_not_found_exception(std::string method_name)
+            : method_name(std::move(method_name)),
+              message("Method \"" + this->method_name + "\" not found, or the signature mismatched.") {
+        }
+
+        [[nodiscard]] const std::string& name() const noexcept {
+            return method_name;
         }
 
         [[nodiscard]] const char* what() const noexcept override {
-            std::stringstream ss;
-            ss << "Method \"" << method_name << "\" not found, or the signature mismatched.";
-            std::cerr << ss.str() << std::endl;
-            return ss.str().c_str();
+            return message.c_str();
         }
     };
 
     class metadata_not_found_exception : public std::exception {
         std::string metadata_name;
+        std::string message;
 
     public:
-        explicit metadata_not_found_exception(std::string metadata_name) : metadata_name(std::move(metadata_name)) {
+        explicit metadata_not_found_exception(std::string metadata_name)
+            : metadata_name(std::move(metadata_name)),
+              message("Metadata \"" + this->metadata_name + "\" not found.") {
+        }
+
+        [[nodiscard]] const std::string& name() const noexcept {
+            return metadata_name;
         }
 
         [[nodiscard]] const char* what() const noexcept override {
-            std::stringstream ss;
-            ss << "Metadata \"" << metadata_name << "\" not found.";
-            std::cerr << ss.str() << std::endl;
-            return ss.str().c_str();
+            return message.c_str();
         }
     };
 
@@ -408,8 +840,11 @@ namespace simple_reflection {
     struct RawObjectWrapper {
         void* object;
         std::type_index type_index;
+        // whether the object may be moved from, e.g. by set_member or by a by-value parameter.
+        bool is_rvalue = false;
 
-        RawObjectWrapper(void* object, std::type_index type_index) : object(object), type_index(type_index) {
+        RawObjectWrapper(void* object, std::type_index type_index, const bool is_rvalue = false)
+            : object(object), type_index(type_index), is_rvalue(is_rvalue) {
         }
 
         template <typename T>
@@ -472,744 +907,4077 @@ namespace simple_reflection {
         return {object, typeid(T)};
     }
 
+    /**
+     * Wrap an object, which is marked as an rvalue if it is one, e.g. `wrap_object(std::move(value))`.
+     */
     template <typename T>
     RawObjectWrapper wrap_object(T&& object) {
-        return {std::addressof(object), typeid(T)};
+        return {std::addressof(object), typeid(T), !std::is_lvalue_reference_v<T>};
     }
 
     using RawArg = void *;
     using RawArgList = RawArg *;
 
+    /**
+     * One bit per argument of a RawArgList, set if the argument may be moved from.
+     * @note Arguments past the 64th are always treated as lvalues, i.e. copied, since there's no bit to tell.
+     */
+    using ArgFlags = uint64_t;
+
+    inline constexpr ArgFlags all_rvalues = ~ArgFlags{0};
+
+    inline bool is_rvalue_arg(const ArgFlags flags, const size_t index) noexcept {
+        return index < 64 && (flags >> index & 1) != 0;
+    }
+
     class ReturnValueProxy;
-    using CommonCallable = std::function<ReturnValueProxy (void*, void** args)>;
 
-    using RawObjectWrapperVec = std::pmr::vector<RawObjectWrapper>;
+    /**
+     * A type-erased callable, which is a plain function pointer (a thunk) and the context passed to it.
+     * @note Invoking it is a single indirect call, with no std::function involved.
+     * @note The context is owned elsewhere, see CallableWrapper.
+     */
+    struct CommonCallable {
+        using Thunk = ReturnValueProxy (*)(const void* context, void* object, RawArgList args, ArgFlags rvalues);
 
-    struct ArgList {
-        RawArgList args;
-        std::pmr::vector<std::type_index> type_indices;
-        size_t size;
+        Thunk thunk = nullptr;
+        const void* context = nullptr;
 
-        ArgList(RawArgList args, std::pmr::vector<std::type_index> type_indices, size_t size) {
-            this->args = args;
-            this->type_indices = std::move(type_indices);
-            this->size = size;
-        }
+        /**
+         * @param rvalues The arguments which may be moved from, the others are copied into by-value parameters.
+         */
+        ReturnValueProxy operator()(void* object, RawArgList args, ArgFlags rvalues = all_rvalues) const;
 
-        explicit ArgList(const RawObjectWrapperVec& args) {
-            this->args = new RawArg[args.size()];
-            for (size_t i = 0; i < args.size(); i++) {
-                this->args[i] = args[i].object;
-                this->type_indices.emplace_back(args[i].type_index);
-            }
-            this->size = args.size();
+        explicit operator bool() const noexcept {
+            return thunk != nullptr;
         }
+    };
 
-        ArgList(std::initializer_list<RawObjectWrapper> args) {
-            this->args = new RawArg[args.size()];
-            for (size_t i = 0; i < args.size(); i++) {
-                this->args[i] = args.begin()[i].object;
-                this->type_indices.emplace_back(args.begin()[i].type_index);
-            }
-            this->size = args.size();
-        }
+    /**
+     * A callable that constructs the return value in the given storage, instead of returning a ReturnValueProxy.
+     * @note The storage must be uninitialized, and suitable in size and alignment for the return type.
+     */
+    struct IntoCallable {
+        using Thunk = void (*)(const void* context, void* object, RawArgList args, ArgFlags rvalues, void* storage);
 
-        ArgList(const ArgList& other) = delete;
+        Thunk thunk = nullptr;
+        const void* context = nullptr;
 
-        ArgList(ArgList&& other) noexcept {
-            args = other.args;
-            type_indices = std::move(other.type_indices);
-            size = other.size;
-            other.args = nullptr;
-        }
+        void operator()(void* object, RawArgList args, void* storage, ArgFlags rvalues = all_rvalues) const;
 
-        ~ArgList() {
-            delete[] args;
+        explicit operator bool() const noexcept {
+            return thunk != nullptr;
         }
+    };
 
-        friend ArgList operator|(ArgList&& lhs, ArgList&& rhs) {
-            auto merged_args = new RawArg[lhs.size + rhs.size];
+    using RawObjectWrapperVec = std::pmr::vector<RawObjectWrapper>;
 
-            for (size_t i = 0; i < lhs.size; i++) {
-                merged_args[i] = lhs.args[i];
-            }
-            for (size_t i = 0; i < rhs.size; i++) {
-                merged_args[i + lhs.size] = rhs.args[i];
-            }
+    /**
+     * The memory resource for data that lives as long as the registry does,
+     * such as the argument types of the registered callables and the base class lists.
+     * @note Since registrations may happen from any thread, the resource is synchronized.
+     */
+    inline std::pmr::memory_resource* registry_memory_resource() {
+        static std::pmr::synchronized_pool_resource resource;
+        return &resource;
+    }
 
-            auto type_indices = lhs.type_indices;
-            type_indices.insert(type_indices.end(), rhs.type_indices.begin(), rhs.type_indices.end());
+    /**
+     * A counter bumped by every registration, which invalidates the flattened lookup tables of the reflections.
+     */
+    inline std::atomic<uint64_t>& registration_epoch() {
+        static std::atomic<uint64_t> epoch = 1;
+        return epoch;
+    }
 
-            delete[] lhs.args;
-            delete[] rhs.args;
+    inline void bump_registration_epoch() {
+        registration_epoch().fetch_add(1, std::memory_order_acq_rel);
+    }
 
-            lhs.args = nullptr;
-            rhs.args = nullptr;
+    /**
+     * A counter bumped by every registration of a new type, which lets the cached plans check their missing types.
+     */
+    inline std::atomic<uint64_t>& type_registration_epoch() {
+        static std::atomic<uint64_t> epoch = 1;
+        return epoch;
+    }
 
-            return {merged_args, type_indices, lhs.size + rhs.size};
-        }
+    /**
+     * Whether the reflection calls are instrumented, see ReflectionStats.
+     * @note Define SIMPLE_REFL_ENABLE_STATS to 1 before including this header to turn it on.
+     * @note When it is off, the hooks are discarded at compile time.
+     */
+    inline constexpr bool stats_enabled = SIMPLE_REFL_ENABLE_STATS;
+
+    enum class StatKind : uint8_t {
+        /** A member looked up by name. */
+        member_access,
+        /** A method or function looked up by name, i.e. a call through the name-based API. */
+        method_lookup,
+        /** A signature that had to be resolved by scanning the overloads. */
+        overload_miss,
+        /** The flattened lookup tables rebuilt after a registration. */
+        table_rebuild,
+        /** A member or method found in a base class. */
+        base_class_hit,
+        /** An exception thrown by the library. */
+        exception,
+        /** A heap allocation made by ReturnValueProxy or ArgList. */
+        allocation,
+    };
 
-        friend ArgList operator,(ArgList&& lhs, ArgList&& rhs) {
-            return std::move(lhs) | std::move(rhs);
-        }
+    inline constexpr size_t stat_kind_count = 7;
 
-        [[nodiscard]] RawArgList get() const & {
-            return args;
-        }
+    constexpr std::string_view stat_kind_name(const StatKind kind) noexcept {
+        constexpr std::string_view names[stat_kind_count] = {
+            "member_access", "method_lookup", "overload_miss", "table_rebuild",
+            "base_class_hit", "exception", "allocation"
+        };
+        return names[static_cast<size_t>(kind)];
+    }
 
-        /**
-         * This is to prevent calling the get() method on rvalue reference.
-         * If not doing so, under certain circumstances, the RawArgList can be invalidated but used afterward.
-         * To be specific, the destructor can be, though not always, called right after the get() method,
-         * if we don't prevent it.
-         */
-        [[nodiscard]] RawArgList get() const && = delete;
+    /**
+     * The counters of one type and member/method name, aggregated over all threads.
+     * @note Counters that are not about a specific name (rebuilds, allocations) have an empty name,
+     * @note and those not about a specific type have an empty type name.
+     */
+    struct StatEntry {
+        std::string type_name;
+        std::string name;
+        std::array<uint64_t, stat_kind_count> counters{};
 
-        [[nodiscard]] std::pmr::vector<RawObjectWrapper> to_object_wrappers() const {
-            std::pmr::vector<RawObjectWrapper> wrappers;
-            for (size_t i = 0; i < size; i++) {
-                wrappers.emplace_back(args[i], type_indices[i]);
-            }
-            return wrappers;
+        uint64_t operator[](const StatKind kind) const noexcept {
+            return counters[static_cast<size_t>(kind)];
         }
+    };
 
-        static ArgList empty() {
-            return {nullptr, {}, 0};
-        }
+    /**
+     * Per-thread counters of the reflection calls.
+     * @note Every thread counts into its own table, with plain relaxed stores and no read-modify-write,
+     * @note so recording never locks nor contends. snapshot() sums the tables on demand.
+     * @note The counters of exited threads are folded into the snapshot too.
+     * @note Only does anything when stats_enabled is true.
+     * @code
+     * for (const auto& entry: ReflectionStats::instance().snapshot()) {
+     *     metrics.gauge(entry.type_name + "." + entry.name, entry[StatKind::method_lookup]);
+     * }
+     * @endcode
+     */
+    class ReflectionStats {
+        using Counters = std::array<uint64_t, stat_kind_count>;
+        using Key = std::pair<std::string, std::string>;
+
+        struct Slot {
+            // written once by the owning thread before `used` is published.
+            std::string_view type_name;
+            Symbol name;
+            std::atomic<bool> used{false};
+            std::array<std::atomic<uint64_t>, stat_kind_count> counters{};
+        };
+
+        struct ThreadTable {
+            static constexpr size_t capacity = 256;
+
+            std::array<Slot, capacity> slots{};
+            // shared by the keys that do not fit.
+            Slot overflow;
+
+            ThreadTable() {
+                instance()._attach(this);
+            }
 
-        friend ArgList operator|(ArgList&& lhs, RawObjectWrapper rhs) {
-            return std::move(lhs) | ArgList(std::initializer_list{rhs});
+            ~ThreadTable() {
+                instance()._detach(this);
+            }
+
+            ThreadTable(const ThreadTable&) = delete;
+
+            ThreadTable& operator=(const ThreadTable&) = delete;
+
+            Slot& slot(const std::string_view type_name, const Symbol name) noexcept {
+                const uint64_t hash = (reinterpret_cast<uintptr_t>(type_name.data()) >> 3)
+                                      ^ (name ? name.id() + 1 : 0) * 0x9e3779b97f4a7c15ull;
+                for (size_t i = 0; i < capacity; ++i) {
+                    auto& slot = slots[(hash + i) % capacity];
+                    if (!slot.used.load(std::memory_order_relaxed)) {
+                        slot.type_name = type_name;
+                        slot.name = name;
+                        slot.used.store(true, std::memory_order_release);
+                        return slot;
+                    }
+                    if (slot.name == name && slot.type_name.data() == type_name.data()
+                        && slot.type_name.size() == type_name.size()) {
+                        return slot;
+                    }
+                }
+                return overflow;
+            }
+        };
+
+        mutable std::mutex m_mutex;
+        std::vector<const ThreadTable*> m_threads;
+        std::map<Key, Counters> m_retired;
+        std::map<Key, Counters> m_baseline;
+
+        static void _accumulate(std::map<Key, Counters>& totals, const Slot& slot, const Key& key) {
+            auto& counters = totals[key];
+            for (size_t i = 0; i < stat_kind_count; ++i) {
+                counters[i] += slot.counters[i].load(std::memory_order_relaxed);
+            }
         }
 
-        friend ArgList operator|(RawObjectWrapper lhs, ArgList&& rhs) {
-            return ArgList(std::initializer_list{lhs}) | std::move(rhs);
+        static void _accumulate(std::map<Key, Counters>& totals, const ThreadTable& table) {
+            for (const auto& slot: table.slots) {
+                if (slot.used.load(std::memory_order_acquire)) {
+                    _accumulate(totals, slot, {std::string(slot.type_name), std::string(slot.name.view())});
+                }
+            }
+            _accumulate(totals, table.overflow, {"", "<overflow>"});
         }
 
-        friend ArgList operator|(ArgList&& lhs, const RawObjectWrapperVec& rhs) {
-            return std::move(lhs) | ArgList(rhs);
+        void _attach(const ThreadTable* table) {
+            std::lock_guard lock(m_mutex);
+            m_threads.push_back(table);
         }
 
-        friend ArgList operator|(const RawObjectWrapperVec& lhs, ArgList&& rhs) {
-            return ArgList(lhs) | std::move(rhs);
+        void _detach(const ThreadTable* table) {
+            std::lock_guard lock(m_mutex);
+            _accumulate(m_retired, *table);
+            m_threads.erase(std::remove(m_threads.begin(), m_threads.end(), table), m_threads.end());
         }
 
-        friend ArgList operator,(ArgList&& lhs, RawObjectWrapper rhs) {
-            return std::move(lhs) | ArgList(std::initializer_list{rhs});
+        [[nodiscard]] std::map<Key, Counters> _totals() const {
+            auto totals = m_retired;
+            for (const auto table: m_threads) {
+                _accumulate(totals, *table);
+            }
+            return totals;
         }
 
-        friend ArgList operator,(RawObjectWrapper lhs, ArgList&& rhs) {
-            return ArgList(std::initializer_list{lhs}) | std::move(rhs);
+        static ThreadTable& _thread_table() {
+            thread_local ThreadTable table;
+            return table;
         }
 
-        friend ArgList operator,(ArgList&& lhs, const RawObjectWrapperVec& rhs) {
-            return std::move(lhs) | ArgList(rhs);
+    public:
+        static ReflectionStats& instance() {
+            static ReflectionStats _instance;
+            return _instance;
         }
 
-        friend ArgList operator,(const RawObjectWrapperVec& lhs, ArgList&& rhs) {
-            return ArgList(lhs) | std::move(rhs);
+        /**
+         * Count one event.
+         * @param type_name The interned name of the type, or a string literal. It is kept by reference.
+         * @param name The member or method name, or an invalid symbol.
+         */
+        static void record(const StatKind kind, const std::string_view type_name, const Symbol name = {}) {
+            auto& counter = _thread_table().slot(type_name, name).counters[static_cast<size_t>(kind)];
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
         }
-    };
 
-    inline ArgList refl_arg_list(const RawObjectWrapperVec& args) {
-        return ArgList(args);
-    }
+        /**
+         * Sum the counters of all threads since the last reset().
+         * @note Entries are sorted by type name and name, entries whose counters are all zero are skipped.
+         */
+        [[nodiscard]] std::vector<StatEntry> snapshot() const {
+            std::lock_guard lock(m_mutex);
+            std::vector<StatEntry> entries;
+            for (const auto& [key, counters]: _totals()) {
+                StatEntry entry{key.first, key.second, counters};
+                bool any = false;
+                if (const auto baseline = m_baseline.find(key); baseline != m_baseline.end()) {
+                    for (size_t i = 0; i < stat_kind_count; ++i) {
+                        entry.counters[i] -= std::min(entry.counters[i], baseline->second[i]);
+                    }
+                }
+                for (const auto counter: entry.counters) {
+                    any = any || counter != 0;
+                }
+                if (any) {
+                    entries.push_back(std::move(entry));
+                }
+            }
+            return entries;
+        }
 
-    inline ArgList empty_arg_list() {
-        return ArgList::empty();
+        /**
+         * Find the counters of a type and name in a snapshot.
+         * @return The counters, all zero if the entry is not in the snapshot.
+         */
+        [[nodiscard]] static StatEntry find(const std::vector<StatEntry>& snapshot, const std::string_view type_name,
+                                            const std::string_view name = {}) {
+            for (const auto& entry: snapshot) {
+                if (entry.type_name == type_name && entry.name == name) {
+                    return entry;
+                }
+            }
+            return {std::string(type_name), std::string(name), {}};
+        }
+
+        /**
+         * Start counting from zero again.
+         * @note Threads never see their counters written by another one, the current totals are subtracted instead.
+         */
+        void reset() {
+            std::lock_guard lock(m_mutex);
+            m_baseline = _totals();
+        }
+    };
+
+    /**
+     * Count an event that is not about a specific reflection, when the stats are enabled.
+     */
+    inline void record_stat(const StatKind kind, const std::string_view type_name = {}) {
+        if constexpr (stats_enabled) {
+            ReflectionStats::record(kind, type_name);
+        }
     }
 
     /**
-     * Merge two ArgList into one.
-     * @note This will invalidate the ArgList passed in.
-     * @param lhs The first ArgList.
-     * @param rhs The second ArgList.
-     * @return The merged ArgList.
+     * Get the offset of the Parent subobject within Derived.
+     * @note Virtual inheritance is not supported.
      */
-    inline ArgList merge_arg_list(ArgList&& lhs, ArgList&& rhs) {
-        return std::move(lhs) | std::move(rhs);
+    template <typename Parent, typename Derived>
+    size_t base_offset_of() {
+        static_assert(std::is_base_of_v<Parent, Derived>, "Derived must derive from Parent");
+        alignas(Derived) unsigned char storage[sizeof(Derived)];
+        const auto derived = reinterpret_cast<Derived *>(storage);
+        return reinterpret_cast<unsigned char *>(static_cast<Parent *>(derived)) - storage;
     }
 
     /**
-     * Merge multiple ArgList into one.
-     * @note This will invalidate the ArgList passed in.
-     * @tparam ArgTypes
-     * @param args The ArgList to be merged.
-     * @return The merged ArgList.
+     * A read-only view over a contiguous sequence of std::type_index.
+     * @note The view does not own the data, so the data must outlive the view.
      */
-    template <
-        typename... ArgTypes,
-        std::enable_if_t<(std::is_same_v<remove_cvref_t<ArgTypes>, ArgList> && ...), bool>  = false,
-        std::enable_if_t<sizeof...(ArgTypes) >= 2, bool>  = false
-    >
-    ArgList merge_arg_list(ArgTypes&&... args) {
-        std::vector<ArgList> arg_lists;
-        (arg_lists.emplace_back(std::forward<ArgTypes>(args)), ...);
+    class TypeIndexSpan {
+        const std::type_index* m_data = nullptr;
+        size_t m_size = 0;
 
-        size_t size = std::accumulate(
-            arg_lists.begin(), arg_lists.end(), 0,
-            [](size_t sum, const ArgList& arg_list) {
-                return sum + arg_list.size;
-            });
+    public:
+        TypeIndexSpan() = default;
 
-        auto* merged_args = new RawArg[size];
-        size_t offset = 0;
-        for (auto& arg_list: arg_lists) {
-            for (size_t j = 0; j < arg_list.size; j++) {
-                merged_args[offset++] = arg_list.args[j];
-            }
+        TypeIndexSpan(const std::type_index* data, const size_t size) : m_data(data), m_size(size) {
         }
 
-        for (auto& arg_list: arg_lists) {
-            delete[] arg_list.args;
-            arg_list.args = nullptr;
+        TypeIndexSpan(const std::pmr::vector<std::type_index>& type_indices)
+            : m_data(type_indices.data()), m_size(type_indices.size()) {
         }
 
-        auto type_indices = arg_lists[0].type_indices;
-        for (size_t i = 1; i < arg_lists.size(); i++) {
-            type_indices.insert(
-                type_indices.end(), arg_lists[i].type_indices.begin(),
-                arg_lists[i].type_indices.end());
+        template <size_t N>
+        TypeIndexSpan(const std::array<std::type_index, N>& type_indices)
+            : m_data(type_indices.data()), m_size(N) {
         }
 
-        return {merged_args, type_indices, size};
-    }
-
-    template <size_t I = 0, typename... Args>
-    constexpr void extract_type_indices(const std::tuple<Args...>&, std::pmr::vector<std::type_index>& indices) {
-        if constexpr (I < sizeof...(Args)) {
-            indices.emplace_back(typeid(std::tuple_element_t<I, std::tuple<Args...>>));
-            extract_type_indices<I + 1>(std::tuple<Args...>{}, indices);
+        [[nodiscard]] const std::type_index* data() const noexcept {
+            return m_data;
         }
-    }
 
-    template <size_t I = 0, typename... Args>
-    constexpr void assign_raw_args(RawArgList indices, std::tuple<Args...> args) {
-        if constexpr (I < sizeof...(Args)) {
-            indices[I] = std::get<I>(args);
-            assign_raw_args<I + 1>(indices, args);
+        [[nodiscard]] size_t size() const noexcept {
+            return m_size;
         }
-    }
 
-    template <typename... ArgTypes>
-    ArgList refl_args(ArgTypes&&... args) {
-        auto arg_tuple = std::make_tuple(std::addressof(args)...);
-        auto arg_list = new RawArg[sizeof...(ArgTypes)];
+        [[nodiscard]] bool empty() const noexcept {
+            return m_size == 0;
+        }
 
-        assign_raw_args(arg_list, arg_tuple);
+        [[nodiscard]] const std::type_index* begin() const noexcept {
+            return m_data;
+        }
 
-        std::pmr::vector<std::type_index> type_indices;
-        extract_type_indices(std::tuple<remove_cvref_t<ArgTypes>...>(), type_indices);
+        [[nodiscard]] const std::type_index* end() const noexcept {
+            return m_data + m_size;
+        }
 
-        return {arg_list, type_indices, sizeof...(ArgTypes)};
-    }
+        const std::type_index& operator[](const size_t index) const noexcept {
+            return m_data[index];
+        }
+    };
 
     /**
-     * A struct to represent a member of a class.
-     * @tparam MemberType The type of the member.
+     * The type indices of a signature, stored in a static table,
+     * which is shared by all the calls with the same signature.
+     * @tparam ArgTypes The argument types, with cvref qualifiers removed.
      */
-    struct Member {
-        size_t offset = 0;
-        size_t size = 0;
-        bool is_const = false;
-        const std::type_info& type_info;
-
-        std::function<void(void*, void*)> setter;
-
-        template <typename MemberType>
-        Member init_setter() {
-            size_t offset = this->offset;
-            size_t size = sizeof(MemberType);
-            bool is_const = this->is_const;
-            setter = [offset, size, is_const](void* obj, void* arg) {
-                if (is_const) {
-                    throw std::runtime_error("Cannot assign to const member");
-                }
-                if constexpr (std::is_copy_assignable_v<MemberType>) {
-                    auto* member = const_cast<remove_const_t<MemberType> *>(static_cast<MemberType *>(
-                        obj + offset));
-                    *member = *static_cast<MemberType *>(arg);
-                } else if constexpr (std::is_trivially_copyable_v<MemberType>) {
-                    auto* member = obj + offset;
-                    std::memcpy(member, arg, size);
-                } else {
-                    throw std::runtime_error("MemberType is neither copy assignable nor trivially copyable");
-                }
-            };
-            return *this;
-        }
-
-        explicit Member(const size_t offset, const size_t size, const std::type_info& type_info)
-            : offset(offset), size(size), type_info(type_info) {
-        }
+    template <typename... ArgTypes>
+    struct StaticSignature {
+        static inline const std::array<std::type_index, sizeof...(ArgTypes)> type_indices = {
+            std::type_index(typeid(ArgTypes))...
+        };
 
-        Member(const size_t offset, const size_t size, const bool is_const, const std::type_info& type_info)
-            : offset(offset), size(size), is_const(is_const), type_info(type_info) {
+        static TypeIndexSpan span() {
+            return type_indices;
         }
     };
 
     /**
-     * A struct to represent a method of a class.
+     * A type-erased argument list.
+     * @note Up to inline_capacity arguments (and their type indices) are stored inline,
+     * @note and only larger lists spill to the heap.
+     * @note The type indices of lists built by refl_args or StaticArgList are borrowed from a StaticSignature,
+     * @note so building them never allocates.
+     * @note Small trivially copyable rvalues passed to refl_args (like `refl_args(1.0f, 2)`) are copied inline,
+     * @note so the list stays valid after the temporaries are gone. Other arguments are referenced by address.
      */
-    struct CallableWrapper {
-        // compatibility for API of older versions.
-        std::any method;
-        bool is_const = false;
+    struct ArgList {
+        static constexpr size_t inline_capacity = 8;
+        static constexpr size_t inline_value_size = 8;
 
-        CommonCallable callable;
-        std::type_index return_type;
-        std::pmr::vector<std::type_index> arg_types;
-        std::variant<std::type_index, std::monostate> parent_type;
+        size_t size = 0;
 
-        CallableWrapper(
-            std::any method,
-            CommonCallable callable,
-            std::type_index return_type,
-            std::pmr::vector<std::type_index>&& arg_types,
-            std::variant<std::type_index, std::monostate> parent_type,
-            bool is_const = false
-        ) : method(std::move(method)),
-            is_const(is_const),
-            callable(std::move(callable)),
-            return_type(return_type),
-            arg_types(std::move(arg_types)),
-            parent_type(parent_type) {
-        }
-    };
+    private:
+        enum class TypeStorage {
+            Inline,
+            Heap,
+            Borrowed
+        };
 
-    struct Metadata {
-        std::type_index type_index;
-        std::any data;
+        RawArg m_inline_args[inline_capacity] = {};
+        alignas(inline_value_size) unsigned char m_inline_values[inline_capacity][inline_value_size] = {};
 
-        Metadata(std::type_index type_index, std::any data) : type_index(type_index), data(std::move(data)) {
-        }
-    };
+        union {
+            std::type_index m_inline_types[inline_capacity];
+        };
 
-    template <typename MetadataType>
-    Metadata make_metadata(MetadataType metadata) {
-        return Metadata(typeid(MetadataType), std::move(metadata));
-    }
+        std::unique_ptr<RawArg[]> m_heap_args;
 
-    using PhantomData = std::shared_ptr<void>;
+        // the values copied from other lists past the inline ones, see concat.
+        struct alignas(inline_value_size) ValueSlot {
+            unsigned char bytes[inline_value_size];
+        };
 
-    class PhantomDataProvider {
-    public:
-        virtual ~PhantomDataProvider() = default;
+        std::unique_ptr<ValueSlot[]> m_heap_values;
+        size_t m_heap_value_count = 0;
+        // spilled type indices come from the default memory resource, see std::pmr::set_default_resource.
+        std::pmr::vector<std::type_index> m_heap_types;
 
-        [[nodiscard]] virtual PhantomData phantom() const = 0;
-    };
+        RawArgList m_args = m_inline_args;
+        const std::type_index* m_types = nullptr;
+        TypeStorage m_type_storage = TypeStorage::Inline;
+        ArgFlags m_rvalues = 0;
+
+        ArgList() : m_types(m_inline_types) {
+        }
 
-    /**
-     * A struct to represent a return value of a method.
-     * @note This class does not only serve as a proxy,
-     * @note but also handles the @b life @b cycle of the actual return value.
-     * @note When the ReturnValueProxy is destroyed,
-     * @note the actual return value @b WILL @b BE @b DESTROYED as well!
-     * @note The discard may not be so obvious,
-     * @note especially when using an identifier to store an instance of ReturnValueProxy,
-     * @note extracted the raw pointer and then reused the identifier for another instance.
-     * @note Here the first ReturnValueProxy, along with the actual data, is invalidated!
-     * @note See PhantomDataHelper for more details.
-     * @code
-     * auto proxy = reflection.invoke_function("ctor", args1);
-     * void* ptr = proxy.get_raw();
-     * proxy = reflection.invoke_function("ctor", args2); // the 'ptr' is invalidated here.
-     * do_something(ptr); // undefined behavior!
-     * @endcode
-     */
-    class ReturnValueProxy : public PhantomDataProvider {
         /**
-         * pointer to the return value.
-         * @note this does not only serve as a pointer,
-         * @note but also handles the @b life @b cycle of the actual return value.
-         * @note so when the ReturnValueProxy is destroyed,
-         * @note the actual return value WILL BE DESTROYED as well!
+         * Prepare the owned storage for the given number of arguments.
+         * @param count The number of arguments.
          */
-        std::shared_ptr<void> ptr;
-        size_t size;
-        std::type_index type_index = typeid(void);
+        void _reserve(const size_t count) {
+            if (count <= inline_capacity) {
+                return;
+            }
+            record_stat(StatKind::allocation);
+            m_heap_args = std::make_unique<RawArg[]>(count);
+            std::copy(m_args, m_args + size, m_heap_args.get());
+            m_args = m_heap_args.get();
 
-    public:
-        template <typename ValueType>
-        explicit ReturnValueProxy(ValueType&& ptr): type_index(typeid(ValueType)) {
-            this->ptr = std::make_shared<ValueType>(std::forward<ValueType>(ptr));
-            this->size = sizeof(ValueType);
+            m_heap_types.reserve(count);
+            m_heap_types.assign(m_types, m_types + size);
+            m_types = m_heap_types.data();
+            m_type_storage = TypeStorage::Heap;
         }
 
-        ReturnValueProxy(std::shared_ptr<void> ptr, size_t size, std::type_index type_index) {
-            this->ptr = std::move(ptr);
-            this->size = size;
-            this->type_index = type_index;
+        [[nodiscard]] bool _owns_value(const size_t index) const {
+            if (index < inline_capacity && m_args[index] == m_inline_values[index]) {
+                return true;
+            }
+            const std::less<const void *> before;
+            return m_heap_value_count != 0 && !before(m_args[index], m_heap_values.get())
+                   && before(m_args[index], m_heap_values.get() + m_heap_value_count);
         }
 
-        template <typename ValueType>
-        ValueType get() {
-            return *static_cast<ValueType *>(this->ptr.get());
+        void _push(RawArg arg, const std::type_index type_index, const bool rvalue) {
+            set_rvalue(size, rvalue);
+            m_args[size] = arg;
+            if (m_type_storage == TypeStorage::Inline) {
+                new(&m_inline_types[size]) std::type_index(type_index);
+            } else {
+                m_heap_types.push_back(type_index);
+                m_types = m_heap_types.data();
+            }
+            ++size;
         }
 
         /**
-         * Get the raw pointer to the return value.
-         * Be aware that the life cycle of the actual return value can be unclear if you use this method.
-         * @return the raw pointer to the return value.
+         * Append the arguments of another list, copying the values it owns.
+         * @note The values landing past the inline ones go to m_heap_values, which must have room for them.
          */
-        [[nodiscard]] void* get_raw() const {
-            return this->ptr.get();
+        void _append(const ArgList& other) {
+            for (size_t i = 0; i < other.size; i++) {
+                if (!other._owns_value(i)) {
+                    _push(other.m_args[i], other.m_types[i], other.is_rvalue(i));
+                    continue;
+                }
+                auto* value = size < inline_capacity
+                                  ? m_inline_values[size]
+                                  : m_heap_values[m_heap_value_count++].bytes;
+                std::memcpy(value, other.m_args[i], inline_value_size);
+                _push(value, other.m_types[i], other.is_rvalue(i));
+            }
         }
 
-        [[nodiscard]] size_t get_size() const {
-            return this->size;
+        template <typename ArgType>
+        void _store(const size_t index, ArgType&& arg) {
+            using ValueType = remove_cvref_t<ArgType>;
+            set_rvalue(index, !std::is_lvalue_reference_v<ArgType>);
+            if constexpr (!std::is_lvalue_reference_v<ArgType>
+                          && std::is_trivially_copyable_v<ValueType>
+                          && sizeof(ValueType) <= inline_value_size
+                          && alignof(ValueType) <= inline_value_size) {
+                if (index < inline_capacity) {
+                    std::memcpy(m_inline_values[index], std::addressof(arg), sizeof(ValueType));
+                    m_args[index] = m_inline_values[index];
+                    return;
+                }
+            }
+            m_args[index] = static_cast<void *>(std::addressof(arg));
         }
 
+    public:
         /**
-         * Alias for get_ptr().
-         * @return a copy of the shared pointer to the return value.
+         * Build an ArgList by taking over an array of arguments.
+         * @note The ownership is passed explicitly, so that an array which is only borrowed,
+         * @note e.g. one on the stack, always goes to the constructor copying the arguments instead.
+         * @param args The arguments.
+         * @param type_indices The types of the arguments.
+         * @param size The number of arguments.
          */
-        [[nodiscard]] std::shared_ptr<void> duplicate_inner() const {
-            return get_ptr();
+        ArgList(std::unique_ptr<RawArg[]> args, const TypeIndexSpan type_indices, const size_t size) : ArgList() {
+            m_heap_args = std::move(args);
+            m_rvalues = all_rvalues;
+            if (size > inline_capacity) {
+                m_args = m_heap_args.get();
+                m_heap_types.assign(type_indices.begin(), type_indices.end());
+                m_types = m_heap_types.data();
+                m_type_storage = TypeStorage::Heap;
+                this->size = size;
+                return;
+            }
+            for (size_t i = 0; i < size; i++) {
+                _push(m_heap_args[i], type_indices[i], true);
+            }
+            m_heap_args.reset();
         }
 
         /**
-         * Get a copy of the shared pointer to the return value.
-         * @return a copy of the shared pointer to the return value.
+         * Build an ArgList whose type indices are borrowed.
+         * @note The arguments are copied, while the type indices are not,
+         * @note so the type indices must outlive the ArgList, like the ones in a StaticSignature.
+         * @param args The arguments.
+         * @param static_type_indices The types of the arguments.
+         * @param rvalues The arguments which may be moved from.
          */
-        [[nodiscard]] std::shared_ptr<void> get_ptr() const {
-            return this->ptr;
-        }
-
-        ReturnValueProxy(const ReturnValueProxy& other) {
-            this->ptr = other.ptr;
-            this->size = other.size;
-            this->type_index = other.type_index;
+        ArgList(const RawArg* args, const TypeIndexSpan static_type_indices, const ArgFlags rvalues = all_rvalues)
+            : ArgList() {
+            m_rvalues = rvalues;
+            size = static_type_indices.size();
+            if (size > inline_capacity) {
+                record_stat(StatKind::allocation);
+                m_heap_args = std::make_unique<RawArg[]>(size);
+                m_args = m_heap_args.get();
+            }
+            std::copy(args, args + size, m_args);
+            m_types = static_type_indices.data();
+            m_type_storage = TypeStorage::Borrowed;
         }
 
-        /**
-         * Get a copy of the ReturnValueProxy.
-         * @return a copy of the ReturnValueProxy.
-         */
-        [[nodiscard]] ReturnValueProxy duplicate() const {
-            return {this->ptr, this->size, this->type_index};
+        explicit ArgList(const RawObjectWrapperVec& args) : ArgList() {
+            _reserve(args.size());
+            for (const auto& arg: args) {
+                _push(arg.object, arg.type_index, arg.is_rvalue);
+            }
         }
 
-        [[nodiscard]] std::type_index get_type_index() const {
-            return this->type_index;
+        ArgList(std::initializer_list<RawObjectWrapper> args) : ArgList() {
+            _reserve(args.size());
+            for (const auto& arg: args) {
+                _push(arg.object, arg.type_index, arg.is_rvalue);
+            }
         }
 
         /**
-         * Convert the ReturnValueProxy to a RawObjectWrapper.
-         * @return a RawObjectWrapper.
+         * Build an ArgList from typed arguments. This is what refl_args does.
+         * @tparam ArgTypes The argument types.
+         * @param args The arguments.
+         * @return The ArgList.
          */
-        [[nodiscard]] RawObjectWrapper to_wrapped() const {
-            return {this->ptr.get(), this->type_index};
+        template <typename... ArgTypes>
+        static ArgList from_values(ArgTypes&&... args) {
+            ArgList list;
+            list.size = sizeof...(ArgTypes);
+            if (list.size > inline_capacity) {
+                record_stat(StatKind::allocation);
+                list.m_heap_args = std::make_unique<RawArg[]>(list.size);
+                list.m_args = list.m_heap_args.get();
+            }
+            size_t index = 0;
+            (list._store(index++, std::forward<ArgTypes>(args)), ...);
+            list.m_types = StaticSignature<remove_cvref_t<ArgTypes>...>::span().data();
+            list.m_type_storage = TypeStorage::Borrowed;
+            return list;
         }
 
-        [[nodiscard]] SharedObjectWrapper to_shared() const {
-            return {this->ptr, this->type_index};
-        }
+        ArgList(const ArgList& other) = delete;
 
-        [[nodiscard]] std::shared_ptr<void> phantom() const override {
-            return this->ptr;
+        ArgList(ArgList&& other) noexcept : ArgList() {
+            size = other.size;
+            if (other.m_heap_args) {
+                m_heap_args = std::move(other.m_heap_args);
+                m_args = m_heap_args.get();
+            } else {
+                std::copy(other.m_inline_args, other.m_inline_args + other.size, m_inline_args);
+            }
+            for (size_t i = 0; i < other.size && i < inline_capacity; i++) {
+                if (other._owns_value(i)) {
+                    std::memcpy(m_inline_values[i], other.m_inline_values[i], inline_value_size);
+                    m_args[i] = m_inline_values[i];
+                }
+            }
+
+            m_type_storage = other.m_type_storage;
+            switch (other.m_type_storage) {
+                case TypeStorage::Inline:
+                    for (size_t i = 0; i < other.size; i++) {
+                        new(&m_inline_types[i]) std::type_index(other.m_inline_types[i]);
+                    }
+                    break;
+                case TypeStorage::Heap:
+                    m_heap_types = std::move(other.m_heap_types);
+                    m_types = m_heap_types.data();
+                    break;
+                case TypeStorage::Borrowed:
+                    m_types = other.m_types;
+                    break;
+            }
+
+            m_heap_values = std::move(other.m_heap_values);
+            m_heap_value_count = other.m_heap_value_count;
+            other.m_heap_value_count = 0;
+
+            m_rvalues = other.m_rvalues;
+            other.size = 0;
+            other.m_rvalues = 0;
+            other.m_args = other.m_inline_args;
+            other.m_types = other.m_inline_types;
+            other.m_type_storage = TypeStorage::Inline;
+        }
+
+        ~ArgList() = default;
+
+        /**
+         * Concatenate multiple ArgList into a new one.
+         * @param lists The ArgList to be concatenated.
+         * @return The concatenated ArgList.
+         */
+        static ArgList concat(const std::initializer_list<std::reference_wrapper<const ArgList>> lists) {
+            ArgList merged;
+            size_t total = 0;
+            size_t spilled_values = 0;
+            for (const ArgList& list: lists) {
+                for (size_t i = 0; i < list.size; i++) {
+                    if (total + i >= inline_capacity && list._owns_value(i)) {
+                        ++spilled_values;
+                    }
+                }
+                total += list.size;
+            }
+            merged._reserve(total);
+            if (spilled_values != 0) {
+                record_stat(StatKind::allocation);
+                merged.m_heap_values = std::make_unique<ValueSlot[]>(spilled_values);
+            }
+            for (const ArgList& list: lists) {
+                merged._append(list);
+            }
+            return merged;
+        }
+
+        friend ArgList operator|(ArgList&& lhs, ArgList&& rhs) {
+            return concat({lhs, rhs});
+        }
+
+        friend ArgList operator,(ArgList&& lhs, ArgList&& rhs) {
+            return std::move(lhs) | std::move(rhs);
+        }
+
+        [[nodiscard]] RawArgList get() const & {
+            return m_args;
+        }
+
+        /**
+         * This is to prevent calling the get() method on rvalue reference.
+         * If not doing so, under certain circumstances, the RawArgList can be invalidated but used afterward.
+         * To be specific, the destructor can be, though not always, called right after the get() method,
+         * if we don't prevent it.
+         */
+        [[nodiscard]] RawArgList get() const && = delete;
+
+        [[nodiscard]] TypeIndexSpan type_indices() const {
+            return {m_types, size};
+        }
+
+        [[nodiscard]] std::pmr::vector<RawObjectWrapper> to_object_wrappers() const {
+            std::pmr::vector<RawObjectWrapper> wrappers;
+            for (size_t i = 0; i < size; i++) {
+                wrappers.emplace_back(m_args[i], m_types[i], is_rvalue(i));
+            }
+            return wrappers;
+        }
+
+        /**
+         * The arguments which may be moved from by the invoked callable.
+         * @note refl_args marks the arguments which were passed as rvalues, wrappers carry their own mark,
+         * @note and lists built from raw pointers mark all of them.
+         */
+        [[nodiscard]] ArgFlags rvalue_flags() const noexcept {
+            return m_rvalues;
+        }
+
+        [[nodiscard]] bool is_rvalue(const size_t index) const noexcept {
+            return is_rvalue_arg(m_rvalues, index);
+        }
+
+        void set_rvalue(const size_t index, const bool rvalue = true) noexcept {
+            if (index >= 64) {
+                return;
+            }
+            if (rvalue) {
+                m_rvalues |= ArgFlags{1} << index;
+            } else {
+                m_rvalues &= ~(ArgFlags{1} << index);
+            }
+        }
+
+        static ArgList empty() {
+            return {};
+        }
+
+        friend ArgList operator|(ArgList&& lhs, RawObjectWrapper rhs) {
+            return std::move(lhs) | ArgList(std::initializer_list{rhs});
+        }
+
+        friend ArgList operator|(RawObjectWrapper lhs, ArgList&& rhs) {
+            return ArgList(std::initializer_list{lhs}) | std::move(rhs);
+        }
+
+        friend ArgList operator|(ArgList&& lhs, const RawObjectWrapperVec& rhs) {
+            return std::move(lhs) | ArgList(rhs);
+        }
+
+        friend ArgList operator|(const RawObjectWrapperVec& lhs, ArgList&& rhs) {
+            return ArgList(lhs) | std::move(rhs);
+        }
+
+        friend ArgList operator,(ArgList&& lhs, RawObjectWrapper rhs) {
+            return std::move(lhs) | ArgList(std::initializer_list{rhs});
+        }
+
+        friend ArgList operator,(RawObjectWrapper lhs, ArgList&& rhs) {
+            return ArgList(std::initializer_list{lhs}) | std::move(rhs);
+        }
+
+        friend ArgList operator,(ArgList&& lhs, const RawObjectWrapperVec& rhs) {
+            return std::move(lhs) | ArgList(rhs);
+        }
+
+        friend ArgList operator,(const RawObjectWrapperVec& lhs, ArgList&& rhs) {
+            return ArgList(lhs) | std::move(rhs);
+        }
+    };
+
+    /**
+     * An argument list whose signature is fixed at compile time.
+     * @note The arguments are stored inline, and the type indices live in a StaticSignature,
+     * @note so neither building it nor converting it into an ArgList allocates.
+     * @code
+     * float x = 1.0f, y = 2.0f;
+     * auto args = simple_reflection::StaticArgList<float, float>(x, y);
+     * reflection.invoke_method(ptr, "fetch_add_x_and_y", args);
+     * @endcode
+     * @tparam ArgTypes The argument types.
+     */
+    template <typename... ArgTypes>
+    class StaticArgList {
+        RawArg m_args[sizeof...(ArgTypes) + 1];
+
+    public:
+        using signature = StaticSignature<remove_cvref_t<ArgTypes>...>;
+
+        static constexpr size_t size = sizeof...(ArgTypes);
+
+        /**
+         * @note The arguments are referenced by address, so they must outlive the StaticArgList.
+         */
+        template <
+            typename... ValueTypes,
+            std::enable_if_t<(std::is_same_v<remove_const_t<ValueTypes>, remove_cvref_t<ArgTypes>> && ...), bool>  = false
+        >
+        explicit StaticArgList(ValueTypes&... args)
+            : m_args{const_cast<void *>(static_cast<const void *>(std::addressof(args)))...} {
+        }
+
+        [[nodiscard]] RawArgList get() & {
+            return m_args;
+        }
+
+        [[nodiscard]] static TypeIndexSpan type_indices() {
+            return signature::span();
+        }
+
+        operator ArgList() const {
+            return {m_args, signature::span(), 0};
+        }
+    };
+
+    inline ArgList refl_arg_list(const RawObjectWrapperVec& args) {
+        return ArgList(args);
+    }
+
+    inline ArgList empty_arg_list() {
+        return ArgList::empty();
+    }
+
+    /**
+     * Merge two ArgList into one.
+     * @note This will invalidate the ArgList passed in.
+     * @param lhs The first ArgList.
+     * @param rhs The second ArgList.
+     * @return The merged ArgList.
+     */
+    inline ArgList merge_arg_list(ArgList&& lhs, ArgList&& rhs) {
+        return std::move(lhs) | std::move(rhs);
+    }
+
+    /**
+     * Merge multiple ArgList into one.
+     * @note This will invalidate the ArgList passed in.
+     * @tparam ArgTypes
+     * @param args The ArgList to be merged.
+     * @return The merged ArgList.
+     */
+    template <
+        typename... ArgTypes,
+        std::enable_if_t<(std::is_same_v<remove_cvref_t<ArgTypes>, ArgList> && ...), bool>  = false,
+        std::enable_if_t<sizeof...(ArgTypes) >= 2, bool>  = false
+    >
+    ArgList merge_arg_list(ArgTypes&&... args) {
+        return ArgList::concat({std::cref(args)...});
+    }
+
+    template <size_t I = 0, typename... Args>
+    constexpr void extract_type_indices(const std::tuple<Args...>&, std::pmr::vector<std::type_index>& indices) {
+        if constexpr (I < sizeof...(Args)) {
+            indices.emplace_back(typeid(std::tuple_element_t<I, std::tuple<Args...>>));
+            extract_type_indices<I + 1>(std::tuple<Args...>{}, indices);
+        }
+    }
+
+    template <size_t I = 0, typename... Args>
+    constexpr void assign_raw_args(RawArgList indices, std::tuple<Args...> args) {
+        if constexpr (I < sizeof...(Args)) {
+            indices[I] = std::get<I>(args);
+            assign_raw_args<I + 1>(indices, args);
+        }
+    }
+
+    template <typename... ArgTypes>
+    ArgList refl_args(ArgTypes&&... args) {
+        return ArgList::from_values(std::forward<ArgTypes>(args)...);
+    }
+
+    ReflectionBase* try_get_reflection(std::type_index index);
+
+    /**
+     * Compare two objects of a reflected type member by member, see ReflectionBase::equals.
+     */
+    bool reflected_equals(const ReflectionBase& reflection, const void* lhs, const void* rhs);
+
+    /**
+     * Hash an object of a reflected type member by member, see ReflectionBase::hash.
+     */
+    size_t reflected_hash(const ReflectionBase& reflection, const void* object);
+
+    /**
+     * Get the reflection of a type nested in a reflected one, which is looked up only once per type.
+     * @exception std::runtime_error If the type is not reflected.
+     */
+    template <typename T>
+    const ReflectionBase& _nested_reflection() {
+        static std::atomic<const ReflectionBase*> cached{nullptr};
+        auto reflection = cached.load(std::memory_order_acquire);
+        if (reflection == nullptr) {
+            reflection = try_get_reflection(typeid(T));
+            if (reflection == nullptr) {
+                throw std::runtime_error("type " + extract_type_name<T>()
+                                         + " has no reflection to compare or hash it by");
+            }
+            cached.store(reflection, std::memory_order_release);
+        }
+        return *reflection;
+    }
+
+    /**
+     * Hash a block of bytes.
+     * @note The block is consumed in 32-byte stripes by four independent lanes,
+     * @note which the compiler is free to keep in vector registers.
+     */
+    inline uint64_t hash_bytes(const void* data, const size_t size, const uint64_t seed = 0) noexcept {
+        constexpr uint64_t prime = 0x9e3779b97f4a7c15ull;
+        const auto bytes = static_cast<const unsigned char *>(data);
+        uint64_t lanes[4] = {seed ^ 0x243f6a8885a308d3ull, seed ^ 0x13198a2e03707344ull,
+                             seed ^ 0xa4093822299f31d0ull, seed ^ 0x082efa98ec4e6c89ull};
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                uint64_t word;
+                std::memcpy(&word, bytes + i + lane * 8, 8);
+                lanes[lane] = (lanes[lane] ^ word) * prime;
+                lanes[lane] ^= lanes[lane] >> 29;
+            }
+        }
+        uint64_t hash = (lanes[0] ^ lanes[1] * 3 ^ lanes[2] * 5 ^ lanes[3] * 7) + size;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, 8);
+            hash = (hash ^ word) * prime;
+            hash ^= hash >> 29;
+        }
+        if (i < size) {
+            uint64_t word = 0;
+            std::memcpy(&word, bytes + i, size - i);
+            hash = (hash ^ word) * prime;
+        }
+        hash ^= hash >> 32;
+        hash *= 0xd6e8feb86659fd93ull;
+        return hash ^ hash >> 32;
+    }
+
+    inline size_t hash_combine(const size_t seed, const size_t value) noexcept {
+        return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+
+    template <typename T, typename = void>
+    struct is_equality_comparable : std::false_type {
+    };
+
+    template <typename T>
+    struct is_equality_comparable<T, std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>>
+            : std::true_type {
+    };
+
+    template <typename T, typename = void>
+    struct is_iterable : std::false_type {
+    };
+
+    template <typename T>
+    struct is_iterable<T, std::void_t<decltype(std::begin(std::declval<const T&>())),
+                decltype(std::end(std::declval<const T&>()))>> : std::true_type {
+    };
+
+    template <typename T, typename = void>
+    struct is_contiguous_range : std::false_type {
+    };
+
+    template <typename T>
+    struct is_contiguous_range<T, std::void_t<decltype(std::data(std::declval<const T&>())),
+                decltype(std::size(std::declval<const T&>()))>> : std::true_type {
+    };
+
+    /**
+     * Whether the objects of the type are equal if and only if their bytes are.
+     * @note This holds for integers, enums and structs of them without padding, but not for floats.
+     */
+    template <typename T>
+    inline constexpr bool is_bitwise_comparable_v = std::has_unique_object_representations_v<T>;
+
+    template <typename T>
+    inline constexpr bool is_std_hashable_v = std::is_default_constructible_v<std::hash<T>>;
+
+    template <typename T>
+    struct _range_element {
+        using type = remove_cvref_t<decltype(*std::begin(std::declval<const T&>()))>;
+    };
+
+    template <typename T>
+    using _range_element_t = typename _range_element<T>::type;
+
+    template <typename T>
+    struct is_pair : std::false_type {
+    };
+
+    template <typename First, typename Second>
+    struct is_pair<std::pair<First, Second>> : std::true_type {
+    };
+
+    template <typename T>
+    constexpr bool _is_bitwise_range() {
+        if constexpr (is_contiguous_range<T>::value) {
+            return is_bitwise_comparable_v<remove_cvref_t<decltype(*std::data(std::declval<const T&>()))>>;
+        } else {
+            return false;
+        }
+    }
+
+    template <typename T, typename = void>
+    struct is_unordered_container : std::false_type {
+    };
+
+    template <typename T>
+    struct is_unordered_container<T, std::void_t<typename T::hasher, typename T::key_type>> : std::true_type {
+    };
+
+    template <typename T, typename = void>
+    struct _has_mapped_type : std::false_type {
+    };
+
+    template <typename T>
+    struct _has_mapped_type<T, std::void_t<typename T::mapped_type>> : std::true_type {
+    };
+
+    /**
+     * Whether the operator== of the type compiles all the way down.
+     * @note The operator== of the standard containers is declared for any element type,
+     * @note so the elements, and the members of the pairs, are checked instead.
+     */
+    template <typename T>
+    constexpr bool _has_deep_equality() {
+        if constexpr (is_iterable<T>::value) {
+            if constexpr (std::is_same_v<_range_element_t<T>, T>) {
+                return is_equality_comparable<T>::value;
+            } else {
+                return _has_deep_equality<_range_element_t<T>>() && is_equality_comparable<T>::value;
+            }
+        } else if constexpr (is_pair<T>::value) {
+            return _has_deep_equality<remove_cvref_t<typename T::first_type>>()
+                   && _has_deep_equality<remove_cvref_t<typename T::second_type>>();
+        } else {
+            return is_equality_comparable<T>::value;
+        }
+    }
+
+    /**
+     * Compare two values the way ReflectionBase::equals compares members.
+     * @note Contiguous ranges of bitwise comparable elements are compared with memcmp,
+     * @note types with an operator== with it, which compares unordered containers regardless of their order.
+     * @note Without one, ranges are compared element by element, unordered containers by looking the keys up,
+     * @note and the rest by their registered members.
+     */
+    template <typename T>
+    bool value_equals(const T& lhs, const T& rhs) {
+        if constexpr (_is_bitwise_range<T>()) {
+            const auto size = std::size(lhs);
+            return size == std::size(rhs)
+                   && (size == 0 || std::memcmp(std::data(lhs), std::data(rhs), size * sizeof(*std::data(lhs))) == 0);
+        } else if constexpr (_has_deep_equality<T>()) {
+            return lhs == rhs;
+        } else if constexpr (is_unordered_container<T>::value) {
+            return lhs.size() == rhs.size()
+                   && std::all_of(lhs.begin(), lhs.end(), [&rhs](const auto& element) {
+                       if constexpr (_has_mapped_type<T>::value) {
+                           const auto found = rhs.find(element.first);
+                           return found != rhs.end() && value_equals(found->second, element.second);
+                       } else {
+                           return rhs.find(element) != rhs.end();
+                       }
+                   });
+        } else if constexpr (is_iterable<T>::value) {
+            return std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs), std::end(rhs),
+                              [](const auto& left, const auto& right) {
+                                  return value_equals<_range_element_t<T>>(left, right);
+                              });
+        } else if constexpr (is_pair<T>::value) {
+            return value_equals(lhs.first, rhs.first) && value_equals(lhs.second, rhs.second);
+        } else {
+            return reflected_equals(_nested_reflection<T>(), &lhs, &rhs);
+        }
+    }
+
+    /**
+     * Hash a value the way ReflectionBase::hash hashes members, consistently with value_equals.
+     * @note Types with an operator== but no std::hash are hashed by their registered members.
+     * @note The elements of unordered containers are hashed regardless of their order.
+     */
+    template <typename T>
+    size_t value_hash(const T& value) {
+        if constexpr (_is_bitwise_range<T>()) {
+            return hash_bytes(std::data(value), std::size(value) * sizeof(*std::data(value)));
+        } else if constexpr (is_std_hashable_v<T>) {
+            return std::hash<T>{}(value);
+        } else if constexpr (is_unordered_container<T>::value) {
+            size_t hash = value.size();
+            for (const auto& element: value) {
+                hash += hash_combine(0, value_hash<_range_element_t<T>>(element));
+            }
+            return hash;
+        } else if constexpr (is_iterable<T>::value) {
+            size_t hash = 0;
+            for (const auto& element: value) {
+                hash = hash_combine(hash, value_hash<_range_element_t<T>>(element));
+            }
+            return hash;
+        } else if constexpr (is_pair<T>::value) {
+            return hash_combine(value_hash(value.first), value_hash(value.second));
+        } else {
+            return reflected_hash(_nested_reflection<T>(), &value);
+        }
+    }
+
+    /**
+     * The set of the members of an object written since it was last cleared, see ReflectionBase::track_changes.
+     * @note Bit i stands for the member at position i of the flattened member table of the type,
+     * @note i.e. the order of ReflectionBase::for_each_member, which holds until the next registration.
+     * @note The first 64 members take no allocation.
+     */
+    class DirtySet {
+        uint64_t m_bits = 0;
+        std::vector<uint64_t> m_overflow;
+
+    public:
+        void mark(const size_t index) {
+            if (index < 64) {
+                m_bits |= uint64_t{1} << index;
+                return;
+            }
+            const size_t word = index / 64 - 1;
+            if (word >= m_overflow.size()) {
+                m_overflow.resize(word + 1);
+            }
+            m_overflow[word] |= uint64_t{1} << index % 64;
+        }
+
+        [[nodiscard]] bool contains(const size_t index) const noexcept {
+            if (index < 64) {
+                return (m_bits >> index & 1) != 0;
+            }
+            const size_t word = index / 64 - 1;
+            return word < m_overflow.size() && (m_overflow[word] >> index % 64 & 1) != 0;
+        }
+
+        [[nodiscard]] bool any() const noexcept {
+            return m_bits != 0 || std::any_of(m_overflow.begin(), m_overflow.end(), [](const uint64_t word) {
+                return word != 0;
+            });
+        }
+
+        [[nodiscard]] size_t count() const noexcept {
+            size_t count = 0;
+            for_each([&count](size_t) {
+                ++count;
+            });
+            return count;
+        }
+
+        void clear() noexcept {
+            m_bits = 0;
+            std::fill(m_overflow.begin(), m_overflow.end(), 0);
+        }
+
+        /**
+         * Visit the indices of the marked members, in ascending order.
+         */
+        template <typename Visitor>
+        void for_each(Visitor&& visitor) const {
+            for (size_t word = 0; word <= m_overflow.size(); ++word) {
+                uint64_t bits = word == 0 ? m_bits : m_overflow[word - 1];
+                for (size_t bit = 0; bits != 0; ++bit, bits >>= 1) {
+                    if ((bits & 1) != 0) {
+                        visitor(word * 64 + bit);
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * The offset of the DirtySet of a type which doesn't track its changes.
+     */
+    inline constexpr size_t no_dirty_set = ~size_t{0};
+
+    inline void mark_dirty(void* object, const size_t dirty_offset, const size_t index) {
+        if (dirty_offset != no_dirty_set) {
+            reinterpret_cast<DirtySet *>(static_cast<char *>(object) + dirty_offset)->mark(index);
+        }
+    }
+
+    /**
+     * A plain function pointer which assigns the value pointed by arg to the member pointed by member.
+     */
+    using MemberSetter = void (*)(void* member, void* arg);
+
+    /**
+     * Plain function pointers which compare and hash members, see value_equals and value_hash.
+     */
+    using MemberEquals = bool (*)(const void* lhs, const void* rhs);
+    using MemberHash = size_t (*)(const void* member);
+
+    /**
+     * A struct to represent a member of a class.
+     * @tparam MemberType The type of the member.
+     */
+    struct Member {
+        size_t offset = 0;
+        size_t size = 0;
+        bool is_const = false;
+        const std::type_info& type_info;
+
+        MemberSetter setter = nullptr;
+        // moves out of the argument instead, falls back to the copy when the type can't be moved.
+        MemberSetter move_setter = nullptr;
+        MemberEquals equals = nullptr;
+        MemberHash hash = nullptr;
+        // whether the member can be copied with memcpy, and compared and hashed as bytes.
+        bool trivially_copyable = false;
+        bool bitwise_comparable = false;
+        /**
+         * The position of this member in the flattened member table, and the offset of the DirtySet of the class.
+         * @note Both are only set in the flattened tables, see ReflectionBase::track_changes.
+         */
+        uint32_t table_index = 0;
+        size_t dirty_offset = no_dirty_set;
+
+        template <typename MemberType>
+        static void _assign(void* member, void* arg) {
+            if constexpr (std::is_copy_assignable_v<MemberType>) {
+                *static_cast<MemberType *>(member) = *static_cast<MemberType *>(arg);
+            } else if constexpr (std::is_trivially_copyable_v<MemberType>) {
+                std::memcpy(member, arg, sizeof(MemberType));
+            } else {
+                throw std::runtime_error("MemberType is neither copy assignable nor trivially copyable");
+            }
+        }
+
+        template <typename MemberType>
+        static void _move_assign(void* member, void* arg) {
+            if constexpr (std::is_move_assignable_v<MemberType> && !std::is_trivially_copyable_v<MemberType>) {
+                *static_cast<MemberType *>(member) = std::move(*static_cast<MemberType *>(arg));
+            } else {
+                _assign<MemberType>(member, arg);
+            }
+        }
+
+        static void _assign_const(void*, void*) {
+            throw std::runtime_error("Cannot assign to const member");
+        }
+
+        template <typename MemberType>
+        static bool _equals(const void* lhs, const void* rhs) {
+            return value_equals(*static_cast<const MemberType *>(lhs), *static_cast<const MemberType *>(rhs));
+        }
+
+        template <typename MemberType>
+        static size_t _hash(const void* member) {
+            return value_hash(*static_cast<const MemberType *>(member));
+        }
+
+        template <typename MemberType>
+        Member init_setter() {
+            if (is_const) {
+                setter = &_assign_const;
+                move_setter = &_assign_const;
+            } else {
+                setter = &_assign<remove_const_t<MemberType>>;
+                move_setter = &_move_assign<remove_const_t<MemberType>>;
+            }
+            using ValueType = remove_const_t<MemberType>;
+            equals = &_equals<ValueType>;
+            hash = &_hash<ValueType>;
+            trivially_copyable = std::is_trivially_copyable_v<ValueType>;
+            bitwise_comparable = is_bitwise_comparable_v<ValueType>;
+            return *this;
+        }
+
+        /**
+         * Assign the value pointed by arg to this member of the object.
+         * @param object The pointer to the object.
+         * @param arg The pointer to the value.
+         */
+        void assign(void* object, void* arg) const {
+            setter(static_cast<char *>(object) + offset, arg);
+            mark_dirty(object, dirty_offset, table_index);
+        }
+
+        /**
+         * Move the value pointed by arg into this member of the object, leaving the value moved-from.
+         */
+        void move_assign(void* object, void* arg) const {
+            move_setter(static_cast<char *>(object) + offset, arg);
+            mark_dirty(object, dirty_offset, table_index);
+        }
+
+        explicit Member(const size_t offset, const size_t size, const std::type_info& type_info)
+            : offset(offset), size(size), type_info(type_info) {
+        }
+
+        Member(const size_t offset, const size_t size, const bool is_const, const std::type_info& type_info)
+            : offset(offset), size(size), is_const(is_const), type_info(type_info) {
+        }
+    };
+
+    /**
+     * A pre-resolved accessor to a member of a class.
+     * @note Obtain it via ReflectionBase::resolve_member.
+     * @note The offset (with base classes taken into account) and the type check are resolved only once,
+     * @note so accessing a member through the handle is a single pointer addition.
+     * @note If the member is const, only a handle of a const MemberType can be resolved.
+     * @tparam MemberType The type of the member.
+     */
+    template <typename MemberType>
+    class FieldHandle {
+        size_t m_offset = 0;
+        bool m_valid = false;
+        uint32_t m_table_index = 0;
+        size_t m_dirty_offset = no_dirty_set;
+
+    public:
+        FieldHandle() = default;
+
+        explicit FieldHandle(const size_t offset) : m_offset(offset), m_valid(true) {
+        }
+
+        /**
+         * Construct a handle whose writes are recorded in the DirtySet at dirty_offset, see Member::table_index.
+         */
+        FieldHandle(const size_t offset, const uint32_t table_index, const size_t dirty_offset)
+            : m_offset(offset), m_valid(true), m_table_index(table_index), m_dirty_offset(dirty_offset) {
+        }
+
+        [[nodiscard]] bool valid() const noexcept {
+            return m_valid;
+        }
+
+        explicit operator bool() const noexcept {
+            return m_valid;
+        }
+
+        [[nodiscard]] size_t get_offset() const noexcept {
+            return m_offset;
+        }
+
+        /**
+         * Get the pointer to the member.
+         * @note The handle must be valid, and the object must be of the type the handle is resolved from.
+         * @param object The pointer to the object.
+         * @return The pointer to the member.
+         */
+        [[nodiscard]] MemberType* get(void* object) const noexcept {
+            return reinterpret_cast<MemberType *>(static_cast<char *>(object) + m_offset);
+        }
+
+        [[nodiscard]] const MemberType* get(const void* object) const noexcept {
+            return reinterpret_cast<const MemberType *>(static_cast<const char *>(object) + m_offset);
+        }
+
+        /**
+         * Assign a value to the member.
+         * @note The handle must be valid, and the object must be of the type the handle is resolved from.
+         * @param object The pointer to the object.
+         * @param value The value to be assigned.
+         */
+        template <
+            typename ValueType,
+            typename M = MemberType,
+            std::enable_if_t<!std::is_const_v<M>, bool>  = false
+        >
+        void set(void* object, ValueType&& value) const {
+            *get(object) = std::forward<ValueType>(value);
+            mark_dirty(object, m_dirty_offset, m_table_index);
+        }
+
+        /**
+         * Copy the member out of each object in an array, into a dense array (AoS to SoA).
+         * @note The objects are `stride` bytes apart, which is usually the size of the class.
+         * @note Trivially copyable members are copied bytewise, in a single memcpy if the array is dense.
+         * @param objects The pointer to the first object.
+         * @param count The number of objects.
+         * @param stride The distance between two adjacent objects, in bytes.
+         * @param out The array of at least `count` elements to receive the values.
+         */
+        void gather(const void* objects, const size_t count, const size_t stride,
+                    remove_const_t<MemberType>* out) const {
+            using ValueType = remove_const_t<MemberType>;
+            const auto source = static_cast<const unsigned char *>(objects) + m_offset;
+            if constexpr (std::is_trivially_copyable_v<ValueType>) {
+                if (stride == sizeof(ValueType)) {
+                    std::memcpy(out, source, count * sizeof(ValueType));
+                    return;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    std::memcpy(out + i, source + i * stride, sizeof(ValueType));
+                }
+            } else {
+                for (size_t i = 0; i < count; ++i) {
+                    out[i] = *reinterpret_cast<const ValueType *>(source + i * stride);
+                }
+            }
+        }
+
+        /**
+         * Assign the values of a dense array to the member of each object in an array (SoA to AoS).
+         * @param objects The pointer to the first object.
+         * @param count The number of objects.
+         * @param stride The distance between two adjacent objects, in bytes.
+         * @param in The array of at least `count` values.
+         */
+        template <typename M = MemberType, std::enable_if_t<!std::is_const_v<M>, bool>  = false>
+        void scatter(void* objects, const size_t count, const size_t stride, const MemberType* in) const {
+            if (m_dirty_offset != no_dirty_set) {
+                for (size_t i = 0; i < count; ++i) {
+                    mark_dirty(static_cast<unsigned char *>(objects) + i * stride, m_dirty_offset, m_table_index);
+                }
+            }
+            const auto target = static_cast<unsigned char *>(objects) + m_offset;
+            if constexpr (std::is_trivially_copyable_v<MemberType>) {
+                if (stride == sizeof(MemberType)) {
+                    std::memcpy(target, in, count * sizeof(MemberType));
+                    return;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    std::memcpy(target + i * stride, in + i, sizeof(MemberType));
+                }
+            } else {
+                for (size_t i = 0; i < count; ++i) {
+                    *reinterpret_cast<MemberType *>(target + i * stride) = in[i];
+                }
+            }
+        }
+    };
+
+    /**
+     * A compile-time description of a member, which keeps the member pointer as a constant.
+     * @note Create it with field<&ClassType::member>("name").
+     * @tparam MemberPtr The pointer to the member.
+     */
+    template <auto MemberPtr>
+    struct FieldDescriptor {
+        using class_type = extract_member_parent_t<decltype(MemberPtr)>;
+        using member_type = extract_member_type_t<decltype(MemberPtr)>;
+
+        static constexpr auto pointer = MemberPtr;
+
+        std::string_view name;
+
+        static constexpr member_type& get(class_type& object) noexcept {
+            return object.*MemberPtr;
+        }
+
+        static constexpr const member_type& get(const class_type& object) noexcept {
+            return object.*MemberPtr;
+        }
+    };
+
+    /**
+     * A compile-time description of a method.
+     * @note Create it with method<&ClassType::method>("name").
+     * @note For overloaded methods, pick the overload with a static_cast.
+     * @tparam Method The pointer to the method.
+     */
+    template <auto Method>
+    struct MethodDescriptor {
+        using class_type = extract_method_class_type_t<decltype(Method)>;
+        using return_type = extract_method_return_type_t<decltype(Method)>;
+        using arg_types = extract_method_arg_types_t<decltype(Method)>;
+
+        static constexpr auto pointer = Method;
+
+        std::string_view name;
+    };
+
+    template <auto MemberPtr>
+    constexpr FieldDescriptor<MemberPtr> field(const std::string_view name) noexcept {
+        return {name};
+    }
+
+    template <auto Method>
+    constexpr MethodDescriptor<Method> method(const std::string_view name) noexcept {
+        return {name};
+    }
+
+    /**
+     * The compile-time description of a class, to be specialized by the user.
+     * @note The specialization provides a `static constexpr` tuple of FieldDescriptor named `fields`,
+     * @note and optionally a tuple of MethodDescriptor named `methods`.
+     * @note Templated code can then iterate the members with for_each_field, with no runtime dispatch,
+     * @note and ReflectionBase::register_descriptor populates the runtime reflection from the same description.
+     * @code
+     * template <>
+     * struct simple_reflection::describe<Point> {
+     *     static constexpr auto fields = std::make_tuple(
+     *         simple_reflection::field<&Point::x>("x"),
+     *         simple_reflection::field<&Point::y>("y"));
+     * };
+     * @endcode
+     * @tparam ClassType The described class.
+     */
+    template <typename ClassType>
+    struct describe;
+
+    template <typename ClassType, typename = void>
+    struct is_described : std::false_type {
+    };
+
+    template <typename ClassType>
+    struct is_described<ClassType, std::void_t<decltype(describe<ClassType>::fields)>> : std::true_type {
+    };
+
+    template <typename ClassType>
+    constexpr bool is_described_v = is_described<ClassType>::value;
+
+    template <typename ClassType, typename = void>
+    struct has_described_methods : std::false_type {
+    };
+
+    template <typename ClassType>
+    struct has_described_methods<ClassType, std::void_t<decltype(describe<ClassType>::methods)>> : std::true_type {
+    };
+
+    template <typename ClassType>
+    constexpr bool has_described_methods_v = has_described_methods<ClassType>::value;
+
+    template <typename ClassType>
+    constexpr size_t field_count_v = std::tuple_size_v<remove_cvref_t<decltype(describe<ClassType>::fields)>>;
+
+    /**
+     * Visit the descriptor of each described field of a class at compile time.
+     * @tparam ClassType The described class.
+     * @param visitor Called with each FieldDescriptor, in the order of the description.
+     */
+    template <typename ClassType, typename Visitor>
+    constexpr void for_each_field(Visitor&& visitor) {
+        std::apply([&visitor](const auto&... fields) {
+            (visitor(fields), ...);
+        }, describe<ClassType>::fields);
+    }
+
+    /**
+     * Visit each described field of an object.
+     * @param object The object.
+     * @param visitor Called with the name and the reference to each field, in the order of the description.
+     */
+    template <typename ClassType, typename Visitor>
+    constexpr void for_each_field(ClassType& object, Visitor&& visitor) {
+        std::apply([&object, &visitor](const auto&... fields) {
+            (visitor(fields.name, fields.get(object)), ...);
+        }, describe<remove_const_t<ClassType>>::fields);
+    }
+
+    /**
+     * Visit the descriptor of each described method of a class at compile time.
+     * @tparam ClassType The described class.
+     * @param visitor Called with each MethodDescriptor, in the order of the description.
+     */
+    template <typename ClassType, typename Visitor>
+    constexpr void for_each_method(Visitor&& visitor) {
+        if constexpr (has_described_methods_v<ClassType>) {
+            std::apply([&visitor](const auto&... methods) {
+                (visitor(methods), ...);
+            }, describe<ClassType>::methods);
+        }
+    }
+
+    template <typename ValueType>
+    void destroy_value(void* object) {
+        static_cast<ValueType *>(object)->~ValueType();
+    }
+
+    template <typename ValueType>
+    void copy_construct_value(void* storage, const void* source) {
+        ::new (storage) ValueType(*static_cast<const ValueType *>(source));
+    }
+
+    /**
+     * The counters of an ObjectPool, aggregated over all threads.
+     */
+    struct PoolStats {
+        /** The blocks handed out. */
+        uint64_t allocations = 0;
+        /** The blocks handed out from a free list instead of operator new. */
+        uint64_t hits = 0;
+        /** The blocks handed out and not returned yet. */
+        uint64_t live = 0;
+        /** The blocks owned by the pool, i.e. the live ones and the ones cached in the free lists. */
+        uint64_t blocks = 0;
+        /** The largest number of blocks owned by the pool at once. */
+        uint64_t high_water = 0;
+
+        [[nodiscard]] double hit_rate() const noexcept {
+            return allocations == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(allocations);
+        }
+    };
+
+    /**
+     * A per-type pool of the blocks that ReturnValueProxy stores the values of OwnerType in.
+     * @note Each thread keeps its own free list and counters, so a block taken from or returned to it takes no lock
+     * @note and no atomic read-modify-write, only the blocks coming from or going to operator new do.
+     * @note A block returned on another thread than the one it came from joins the free list of that other thread.
+     * @note Each free list keeps at most max_cached_blocks blocks, the surplus goes back to operator delete.
+     * @note The pool is off until enable() is called, make_reflection<OwnerType>() turns it on.
+     */
+    template <typename OwnerType>
+    class ObjectPool {
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        // written by its thread only, read by stats().
+        struct Shard {
+            std::atomic<uint64_t> allocations{0};
+            std::atomic<uint64_t> hits{0};
+            std::atomic<uint64_t> returns{0};
+
+            static void bump(std::atomic<uint64_t>& counter) noexcept {
+                counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        };
+
+        struct Counters {
+            std::atomic<bool> enabled{false};
+            std::atomic<uint64_t> blocks{0};
+            std::atomic<uint64_t> high_water{0};
+
+            std::mutex mutex;
+            std::vector<const Shard*> shards;
+            // the counters of the exited threads, and of the calls made while a thread exits.
+            std::atomic<uint64_t> retired_allocations{0};
+            std::atomic<uint64_t> retired_hits{0};
+            std::atomic<uint64_t> retired_returns{0};
+        };
+
+        struct FreeList {
+            FreeBlock* head = nullptr;
+            size_t count = 0;
+            size_t block_size = 0;
+            Shard shard;
+
+            FreeList() {
+                auto& counters = _counters();
+                std::lock_guard lock(counters.mutex);
+                counters.shards.push_back(&shard);
+            }
+
+            ~FreeList() {
+                s_free_list_alive = false;
+                auto& counters = _counters();
+                while (head != nullptr) {
+                    auto* next = head->next;
+                    ::operator delete(head, std::align_val_t(block_align));
+                    counters.blocks.fetch_sub(1, std::memory_order_relaxed);
+                    head = next;
+                }
+                std::lock_guard lock(counters.mutex);
+                counters.shards.erase(std::find(counters.shards.begin(), counters.shards.end(), &shard));
+                counters.retired_allocations.fetch_add(shard.allocations.load(std::memory_order_relaxed),
+                                                       std::memory_order_relaxed);
+                counters.retired_hits.fetch_add(shard.hits.load(std::memory_order_relaxed),
+                                                std::memory_order_relaxed);
+                counters.retired_returns.fetch_add(shard.returns.load(std::memory_order_relaxed),
+                                                   std::memory_order_relaxed);
+            }
+        };
+
+        static constexpr size_t block_align = alignof(std::max_align_t);
+
+        // trivially destructible, so it can still be read while the thread locals are destroyed.
+        static inline thread_local bool s_free_list_alive = true;
+
+        static FreeList* _free_list() {
+            if (!s_free_list_alive) {
+                return nullptr;
+            }
+            static thread_local FreeList free_list;
+            return &free_list;
+        }
+
+        static Counters& _counters() {
+            static Counters counters;
+            return counters;
+        }
+
+        static void* _new_block(const size_t size, const size_t align) {
+            auto& counters = _counters();
+            record_stat(StatKind::allocation);
+            void* block = ::operator new(size, std::align_val_t(std::max(align, block_align)));
+            const auto blocks = counters.blocks.fetch_add(1, std::memory_order_relaxed) + 1;
+            auto high_water = counters.high_water.load(std::memory_order_relaxed);
+            while (blocks > high_water && !counters.high_water.compare_exchange_weak(
+                       high_water, blocks, std::memory_order_relaxed)) {
+            }
+            return block;
+        }
+
+        static void _delete_block(void* block, const size_t align) noexcept {
+            ::operator delete(block, std::align_val_t(std::max(align, block_align)));
+            _counters().blocks.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+    public:
+        static constexpr size_t max_cached_blocks = 64;
+
+        [[nodiscard]] static bool enabled() noexcept {
+            return _counters().enabled.load(std::memory_order_relaxed);
+        }
+
+        static void enable() noexcept {
+            _counters().enabled.store(true, std::memory_order_relaxed);
+        }
+
+        /**
+         * Stop pooling the values allocated from now on.
+         * @note The blocks handed out already still go back to the free lists.
+         */
+        static void disable() noexcept {
+            _counters().enabled.store(false, std::memory_order_relaxed);
+        }
+
+        /**
+         * Sum the counters of all the threads.
+         * @note The counters of the other threads are read while they may be updated, so the sum is a snapshot.
+         */
+        [[nodiscard]] static PoolStats stats() {
+            auto& counters = _counters();
+            PoolStats stats;
+            uint64_t returns = 0;
+            {
+                std::lock_guard lock(counters.mutex);
+                for (const auto* shard: counters.shards) {
+                    stats.allocations += shard->allocations.load(std::memory_order_relaxed);
+                    stats.hits += shard->hits.load(std::memory_order_relaxed);
+                    returns += shard->returns.load(std::memory_order_relaxed);
+                }
+                stats.allocations += counters.retired_allocations.load(std::memory_order_relaxed);
+                stats.hits += counters.retired_hits.load(std::memory_order_relaxed);
+                returns += counters.retired_returns.load(std::memory_order_relaxed);
+            }
+            stats.live = stats.allocations >= returns ? stats.allocations - returns : 0;
+            stats.blocks = counters.blocks.load(std::memory_order_relaxed);
+            stats.high_water = counters.high_water.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        /**
+         * Allocate a block, from the free list of this thread if it has one of that size.
+         * @note The blocks are aligned to std::max_align_t at least.
+         */
+        [[nodiscard]] static void* allocate(const size_t size, const size_t align) {
+            auto* free_list = _free_list();
+            if (free_list == nullptr) {
+                _counters().retired_allocations.fetch_add(1, std::memory_order_relaxed);
+                return _new_block(size, align);
+            }
+            Shard::bump(free_list->shard.allocations);
+            if (free_list->head != nullptr && free_list->block_size == size && align <= block_align) {
+                auto* block = free_list->head;
+                free_list->head = block->next;
+                --free_list->count;
+                Shard::bump(free_list->shard.hits);
+                return block;
+            }
+            return _new_block(size, align);
+        }
+
+        static void deallocate(void* block, const size_t size, const size_t align) noexcept {
+            auto* free_list = _free_list();
+            if (free_list == nullptr) {
+                _counters().retired_returns.fetch_add(1, std::memory_order_relaxed);
+                _delete_block(block, align);
+                return;
+            }
+            Shard::bump(free_list->shard.returns);
+            if (free_list->count < max_cached_blocks && align <= block_align && size >= sizeof(FreeBlock)
+                && (free_list->block_size == 0 || free_list->block_size == size)) {
+                free_list->block_size = size;
+                free_list->head = ::new (block) FreeBlock{free_list->head};
+                ++free_list->count;
+                return;
+            }
+            _delete_block(block, align);
+        }
+    };
+
+    /**
+     * The allocator std::allocate_shared puts a pooled value, along with its control block, in.
+     */
+    template <typename ValueType, typename OwnerType>
+    struct PoolAllocator {
+        using value_type = ValueType;
+
+        PoolAllocator() = default;
+
+        template <typename OtherType>
+        PoolAllocator(const PoolAllocator<OtherType, OwnerType>&) noexcept {
+        }
+
+        template <typename OtherType>
+        struct rebind {
+            using other = PoolAllocator<OtherType, OwnerType>;
+        };
+
+        [[nodiscard]] ValueType* allocate(const size_t count) {
+            return static_cast<ValueType *>(
+                ObjectPool<OwnerType>::allocate(count * sizeof(ValueType), alignof(ValueType)));
+        }
+
+        void deallocate(ValueType* block, const size_t count) noexcept {
+            ObjectPool<OwnerType>::deallocate(block, count * sizeof(ValueType), alignof(ValueType));
+        }
+
+        template <typename OtherType>
+        bool operator==(const PoolAllocator<OtherType, OwnerType>&) const noexcept {
+            return true;
+        }
+
+        template <typename OtherType>
+        bool operator!=(const PoolAllocator<OtherType, OwnerType>&) const noexcept {
+            return false;
+        }
+    };
+
+    /**
+     * The size, the alignment, the destructor and the copy constructor of a type, in a type-erased form.
+     * @note The destructor is nullptr for trivially destructible types, and the size is 0 for void.
+     * @note The copy constructor is only known for the layouts of reflected classes, see of_class.
+     */
+    struct ValueLayout {
+        size_t size = 0;
+        size_t align = 1;
+        void (*destroy)(void*) = nullptr;
+        bool trivially_copyable = false;
+        void (*copy_construct)(void* storage, const void* source) = nullptr;
+        PoolStats (*pool_stats)() = nullptr;
+
+        template <typename ValueType>
+        static ValueLayout of() {
+            using StoredType = remove_cvref_t<ValueType>;
+            constexpr bool trivially_copyable = std::is_trivially_copyable_v<StoredType>;
+            if constexpr (std::is_void_v<StoredType>) {
+                return {};
+            } else {
+                ValueLayout layout{sizeof(StoredType), alignof(StoredType), nullptr, trivially_copyable};
+                if constexpr (!std::is_trivially_destructible_v<StoredType>) {
+                    layout.destroy = &destroy_value<StoredType>;
+                }
+                return layout;
+            }
+        }
+
+        /**
+         * The layout of a reflected class, which also knows how to copy construct it and where it is pooled.
+         */
+        template <typename ClassType>
+        static ValueLayout of_class() {
+            auto layout = of<ClassType>();
+            if constexpr (std::is_copy_constructible_v<ClassType>) {
+                layout.copy_construct = &copy_construct_value<ClassType>;
+            }
+            layout.pool_stats = &ObjectPool<ClassType>::stats;
+            return layout;
+        }
+    };
+
+    /**
+     * A struct to represent a method of a class.
+     */
+    struct CallableWrapper {
+        // the id of the typed signature, used by the typed invoke_method and invoke_function.
+        const void* signature_id = nullptr;
+        bool is_const = false;
+
+        CommonCallable callable;
+        IntoCallable into;
+        ValueLayout return_layout;
+        std::type_index return_type;
+        std::pmr::vector<std::type_index> arg_types;
+        std::variant<std::type_index, std::monostate> parent_type;
+
+        // the storage of the context of the thunks (e.g. a function object), if they take one.
+        std::shared_ptr<const void> context;
+
+        CallableWrapper(
+            const void* signature_id,
+            CommonCallable callable,
+            std::type_index return_type,
+            std::pmr::vector<std::type_index>&& arg_types,
+            std::variant<std::type_index, std::monostate> parent_type,
+            bool is_const = false,
+            IntoCallable into = {},
+            ValueLayout return_layout = {},
+            std::shared_ptr<const void> context = nullptr
+        ) : signature_id(signature_id),
+            is_const(is_const),
+            callable(callable),
+            into(into),
+            return_layout(return_layout),
+            return_type(return_type),
+            arg_types(std::move(arg_types), registry_memory_resource()),
+            parent_type(parent_type),
+            context(std::move(context)) {
+        }
+    };
+
+    /**
+     * A reference to a registered overload, along with the offset of the subobject it is invoked on.
+     * @note The offset is non-zero for methods inherited from a base class which isn't at the start of the derived one.
+     * @note The wrapper points into the reflection owning the overload, and is valid as long as it.
+     */
+    struct OverloadRef {
+        const CallableWrapper* wrapper = nullptr;
+        size_t this_offset = 0;
+
+        explicit operator bool() const noexcept {
+            return wrapper != nullptr;
+        }
+
+        const CallableWrapper* operator->() const noexcept {
+            return wrapper;
+        }
+
+        [[nodiscard]] void* adjust(void* object) const noexcept {
+            if (object == nullptr) {
+                return nullptr;
+            }
+            return static_cast<unsigned char *>(object) + this_offset;
+        }
+    };
+
+    struct Metadata {
+        std::type_index type_index;
+        std::any data;
+
+        Metadata(std::type_index type_index, std::any data) : type_index(type_index), data(std::move(data)) {
+        }
+    };
+
+    template <typename MetadataType>
+    Metadata make_metadata(MetadataType metadata) {
+        return Metadata(typeid(MetadataType), std::move(metadata));
+    }
+
+    using PhantomData = std::shared_ptr<void>;
+
+    class PhantomDataProvider {
+    public:
+        virtual ~PhantomDataProvider() = default;
+
+        [[nodiscard]] virtual PhantomData phantom() const = 0;
+    };
+
+    /**
+     * A struct to represent a return value of a method.
+     * @note This class does not only serve as a proxy,
+     * @note but also handles the @b life @b cycle of the actual return value.
+     * @note When the ReturnValueProxy is destroyed,
+     * @note the actual return value @b WILL @b BE @b DESTROYED as well!
+     * @note The discard may not be so obvious,
+     * @note especially when using an identifier to store an instance of ReturnValueProxy,
+     * @note extracted the raw pointer and then reused the identifier for another instance.
+     * @note Here the first ReturnValueProxy, along with the actual data, is invalidated!
+     * @note See PhantomDataHelper for more details.
+     * @code
+     * auto proxy = reflection.invoke_function("ctor", args1);
+     * void* ptr = proxy.get_raw();
+     * proxy = reflection.invoke_function("ctor", args2); // the 'ptr' is invalidated here.
+     * do_something(ptr); // undefined behavior!
+     * @endcode
+     * @note Small trivially copyable values (see inline_capacity) are stored inside the proxy instead,
+     * @note so a raw pointer to them lives exactly as long as the proxy object it was taken from,
+     * @note and PhantomDataHelper has nothing to keep alive for them.
+     */
+    class ReturnValueProxy : public PhantomDataProvider {
+    public:
+        /**
+         * The size of the inline buffer.
+         * @note Trivially copyable return values that fit in it are stored in the proxy itself,
+         * @note so returning an int, a bool or a size_t allocates nothing.
+         */
+        static constexpr size_t inline_capacity = 16;
+
+        template <typename ValueType>
+        static constexpr bool is_inline_storable_v = std::is_trivially_copyable_v<ValueType>
+                                                     && sizeof(ValueType) <= inline_capacity
+                                                     && alignof(ValueType) <= alignof(std::max_align_t);
+
+    private:
+        /**
+         * pointer to the return value.
+         * @note this does not only serve as a pointer,
+         * @note but also handles the @b life @b cycle of the actual return value.
+         * @note so when the ReturnValueProxy is destroyed,
+         * @note the actual return value WILL BE DESTROYED as well!
+         * @note it stays empty when the value is stored inline.
+         */
+        std::shared_ptr<void> ptr;
+        size_t size = 0;
+        std::type_index type_index = typeid(void);
+        bool is_inline_value = false;
+        alignas(std::max_align_t) unsigned char inline_value[inline_capacity] = {};
+
+        [[nodiscard]] std::shared_ptr<void> _materialize() const {
+            struct InlineBlock {
+                alignas(std::max_align_t) unsigned char bytes[inline_capacity];
+            };
+            record_stat(StatKind::allocation);
+            auto block = std::make_shared<InlineBlock>();
+            std::memcpy(block->bytes, this->inline_value, this->size);
+            return {block, block->bytes};
+        }
+
+    public:
+        template <typename ValueType>
+        explicit ReturnValueProxy(ValueType&& ptr): type_index(typeid(remove_cvref_t<ValueType>)) {
+            using StoredType = remove_cvref_t<ValueType>;
+            if constexpr (is_inline_storable_v<StoredType>) {
+                ::new (static_cast<void *>(this->inline_value)) StoredType(std::forward<ValueType>(ptr));
+                this->is_inline_value = true;
+            } else {
+                if (ObjectPool<StoredType>::enabled()) {
+                    this->ptr = std::allocate_shared<StoredType>(
+                        PoolAllocator<StoredType, StoredType>(), std::forward<ValueType>(ptr));
+                } else {
+                    record_stat(StatKind::allocation);
+                    this->ptr = std::make_shared<StoredType>(std::forward<ValueType>(ptr));
+                }
+            }
+            this->size = sizeof(StoredType);
+        }
+
+        ReturnValueProxy(std::shared_ptr<void> ptr, size_t size, std::type_index type_index) {
+            this->ptr = std::move(ptr);
+            this->size = size;
+            this->type_index = type_index;
+        }
+
+        template <typename ValueType>
+        ValueType get() {
+            return *static_cast<ValueType *>(this->get_raw());
+        }
+
+        /**
+         * Get the raw pointer to the return value.
+         * Be aware that the life cycle of the actual return value can be unclear if you use this method.
+         * @note For inline values, the pointer points into this proxy, and is valid only as long as this proxy is.
+         * @return the raw pointer to the return value.
+         */
+        [[nodiscard]] void* get_raw() const {
+            if (this->is_inline_value) {
+                return const_cast<unsigned char *>(this->inline_value);
+            }
+            return this->ptr.get();
+        }
+
+        [[nodiscard]] size_t get_size() const {
+            return this->size;
+        }
+
+        /**
+         * Check whether the return value is stored inline, without any heap allocation.
+         */
+        [[nodiscard]] bool is_inline() const {
+            return this->is_inline_value;
+        }
+
+        /**
+         * Alias for get_ptr().
+         * @return a copy of the shared pointer to the return value.
+         */
+        [[nodiscard]] std::shared_ptr<void> duplicate_inner() const {
+            return get_ptr();
+        }
+
+        /**
+         * Get a copy of the shared pointer to the return value.
+         * @note For inline values, this allocates a detached copy of the value.
+         * @return a copy of the shared pointer to the return value.
+         */
+        [[nodiscard]] std::shared_ptr<void> get_ptr() const {
+            if (this->is_inline_value) {
+                return _materialize();
+            }
+            return this->ptr;
+        }
+
+        ReturnValueProxy(const ReturnValueProxy& other) = default;
+
+        ReturnValueProxy(ReturnValueProxy&& other) noexcept = default;
+
+        ReturnValueProxy& operator=(const ReturnValueProxy& other) = default;
+
+        ReturnValueProxy& operator=(ReturnValueProxy&& other) noexcept = default;
+
+        /**
+         * Get a copy of the ReturnValueProxy.
+         * @return a copy of the ReturnValueProxy.
+         */
+        [[nodiscard]] ReturnValueProxy duplicate() const {
+            return *this;
+        }
+
+        [[nodiscard]] std::type_index get_type_index() const {
+            return this->type_index;
+        }
+
+        /**
+         * Convert the ReturnValueProxy to a RawObjectWrapper.
+         * @return a RawObjectWrapper.
+         */
+        [[nodiscard]] RawObjectWrapper to_wrapped() const {
+            return {this->get_raw(), this->type_index};
+        }
+
+        /**
+         * Convert the ReturnValueProxy to a RawObjectWrapper marked as an rvalue,
+         * so that set_member and by-value parameters move the value out instead of copying it.
+         * @note The value is left moved-from, which is fine for temporaries about to be discarded.
+         */
+        [[nodiscard]] RawObjectWrapper to_moved() const {
+            return {this->get_raw(), this->type_index, true};
+        }
+
+        [[nodiscard]] SharedObjectWrapper to_shared() const {
+            return {this->get_ptr(), this->type_index};
+        }
+
+        /**
+         * Get the phantom data, which keeps the heap-allocated return value alive.
+         * @note Inline values own no heap memory, so there is nothing to keep alive and this returns a nullptr.
+         */
+        [[nodiscard]] std::shared_ptr<void> phantom() const override {
+            return this->ptr;
+        }
+
+        static ReturnValueProxy none() {
+            return {nullptr, 0, typeid(void)};
+        }
+
+        /**
+         * Make a ReturnValueProxy that refers to a value owned by someone else, e.g. a ReflectionArena.
+         * @note No control block is allocated, and the proxy does @b NOT keep the value alive.
+         * @param object The pointer to the value.
+         * @param size The size of the value.
+         * @param type_index The type of the value.
+         */
+        static ReturnValueProxy borrowed(void* object, size_t size, std::type_index type_index) {
+            return {std::shared_ptr<void>(std::shared_ptr<void>(), object), size, type_index};
+        }
+
+        [[nodiscard]] bool is_none() const {
+            return this->type_index == typeid(void)
+                   && this->ptr == nullptr && this->size == 0;
+        }
+    };
+
+    /**
+     * A struct to represent a phantom data.
+     * This class is mainly applied to handle the life cycle of classes like ReturnValueProxy.
+     * In cases like reusing the same identifier to store different instances of ReturnValueProxy,
+     * while keeping the memory valid.
+     */
+    class PhantomDataHelper {
+        std::stack<PhantomData> phantom_data = {};
+
+    public:
+        PhantomDataHelper() {
+            this->phantom_data = {};
+        }
+
+        ~PhantomDataHelper() {
+            while (!this->phantom_data.empty()) {
+                this->phantom_data.pop();
+            }
+        }
+
+        PhantomDataHelper(const PhantomDataHelper& other) {
+            this->phantom_data = other.phantom_data;
+        }
+
+        PhantomDataHelper(PhantomDataHelper&& other) noexcept {
+            this->phantom_data = std::move(other.phantom_data);
+        }
+
+        PhantomDataHelper& operator=(const PhantomDataHelper& other) = default;
+
+        PhantomDataHelper& operator=(PhantomDataHelper&& other) noexcept {
+            this->phantom_data = std::move(other.phantom_data);
+            return *this;
+        }
+
+        void push(PhantomData phantom) {
+            this->phantom_data.push(std::move(phantom));
+        }
+
+        void clear() {
+            while (!this->phantom_data.empty()) {
+                this->phantom_data.pop();
+            }
+        }
+
+        PhantomDataHelper& operator<<(PhantomData rhs) {
+            this->push(std::move(rhs));
+            return *this;
+        }
+
+        PhantomDataHelper& operator<<(const PhantomDataProvider& rhs) {
+            this->push(std::move(rhs.phantom()));
+            return *this;
+        }
+
+        friend PhantomDataHelper& operator>>(PhantomData lhs, PhantomDataHelper& rhs) {
+            rhs.push(std::move(lhs));
+            return rhs;
+        }
+
+        friend PhantomDataHelper& operator>>(const PhantomDataProvider& lhs, PhantomDataHelper& rhs) {
+            rhs.push(std::move(lhs.phantom()));
+            return rhs;
+        }
+    };
+
+    /**
+     * A monotonic arena for the objects created during a session, like a deserialization.
+     * @note Objects are placement-constructed in a std::pmr::monotonic_buffer_resource instead of separate
+     * @note shared_ptr allocations, and are destroyed in bulk, in reverse order of creation,
+     * @note when the arena is released or destroyed.
+     * @note ReturnValueProxy instances referring to an arena do not own the value,
+     * @note so they @b MUST @b NOT be used after the arena is released.
+     * @code
+     * ReflectionArena arena;
+     * auto proxy = reflection.invoke_function("ctor", arena); // constructed in the arena.
+     * arena.release(); // the 'proxy' is invalidated here.
+     * @endcode
+     */
+    class ReflectionArena {
+        struct DestructorNode {
+            void (*destroy)(void*);
+            void* object;
+            DestructorNode* next;
+        };
+
+        std::pmr::monotonic_buffer_resource m_resource;
+        DestructorNode* m_destructors = nullptr;
+
+        void _destroy_all() noexcept {
+            while (m_destructors != nullptr) {
+                m_destructors->destroy(m_destructors->object);
+                m_destructors = m_destructors->next;
+            }
+        }
+
+    public:
+        static constexpr size_t default_initial_size = 4096;
+
+        explicit ReflectionArena(const size_t initial_size = default_initial_size,
+                                 std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+            : m_resource(initial_size, upstream) {
+        }
+
+        /**
+         * Build an arena on top of a caller-provided buffer, the upstream resource is used once it's exhausted.
+         */
+        ReflectionArena(void* buffer, const size_t buffer_size,
+                        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+            : m_resource(buffer, buffer_size, upstream) {
+        }
+
+        ReflectionArena(const ReflectionArena&) = delete;
+
+        ReflectionArena& operator=(const ReflectionArena&) = delete;
+
+        ~ReflectionArena() {
+            _destroy_all();
+        }
+
+        [[nodiscard]] std::pmr::memory_resource* resource() noexcept {
+            return &m_resource;
+        }
+
+        [[nodiscard]] void* allocate(const size_t size, const size_t align) {
+            return m_resource.allocate(size, align);
+        }
+
+        /**
+         * Register the destructor of an object constructed in the arena's memory.
+         * @param object The pointer to the object.
+         * @param destroy The destructor, nothing is registered if it's a nullptr.
+         */
+        void adopt(void* object, void (*destroy)(void*)) {
+            if (destroy == nullptr) {
+                return;
+            }
+            const auto node = allocate(sizeof(DestructorNode), alignof(DestructorNode));
+            m_destructors = ::new (node) DestructorNode{destroy, object, m_destructors};
+        }
+
+        template <typename ValueType, typename... ArgTypes>
+        ValueType* create(ArgTypes&&... args) {
+            const auto object = ::new (allocate(sizeof(ValueType), alignof(ValueType)))
+                    ValueType(std::forward<ArgTypes>(args)...);
+            if constexpr (!std::is_trivially_destructible_v<ValueType>) {
+                adopt(object, &destroy_value<ValueType>);
+            }
+            return object;
+        }
+
+        /**
+         * Destroy every object in the arena, and release the memory back to the upstream resource.
+         */
+        void release() {
+            _destroy_all();
+            m_resource.release();
+        }
+    };
+
+    /**
+     * A work-stealing thread pool, for batch operations like json_mapper::from_json_batch.
+     * @note Every worker has its own deque: it pops its own tasks from the back, and steals from the front
+     * @note of the others' once it runs dry. Tasks submitted by a worker go to its own deque,
+     * @note the others are spread round-robin.
+     * @note The thread calling parallel_for runs the calls itself too, so nested batches don't deadlock.
+     */
+    class ThreadPool {
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_workers;
+        std::atomic<size_t> m_pending{0};
+        std::atomic<size_t> m_next{0};
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+
+        struct WorkerTag {
+            const ThreadPool* pool = nullptr;
+            size_t index = 0;
+        };
+
+        static WorkerTag& _current_worker() {
+            thread_local WorkerTag tag;
+            return tag;
+        }
+
+        [[nodiscard]] size_t _self() const {
+            const auto& tag = _current_worker();
+            return tag.pool == this ? tag.index : m_queues.size();
+        }
+
+        bool _pop(const size_t self, std::function<void()>& task) {
+            if (self < m_queues.size()) {
+                auto& own = *m_queues[self];
+                std::lock_guard lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    m_pending.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            for (size_t i = 1; i <= m_queues.size(); ++i) {
+                auto& victim = *m_queues[(self + i) % m_queues.size()];
+                std::lock_guard lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    m_pending.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void _work(const size_t index) {
+            _current_worker() = {this, index};
+            std::function<void()> task;
+            while (true) {
+                if (_pop(index, task)) {
+                    task();
+                    task = nullptr;
+                    continue;
+                }
+                std::unique_lock lock(m_sleep_mutex);
+                m_wake.wait(lock, [this]() {
+                    return m_stopping || m_pending.load(std::memory_order_relaxed) != 0;
+                });
+                if (m_stopping && m_pending.load(std::memory_order_relaxed) == 0) {
+                    return;
+                }
+            }
+        }
+
+    public:
+        /**
+         * @param threads The number of workers, at least one.
+         */
+        explicit ThreadPool(size_t threads = std::thread::hardware_concurrency()) {
+            threads = std::max<size_t>(threads, 1);
+            for (size_t i = 0; i < threads; ++i) {
+                m_queues.push_back(std::make_unique<Queue>());
+            }
+            for (size_t i = 0; i < threads; ++i) {
+                m_workers.emplace_back(&ThreadPool::_work, this, i);
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * Run the pending tasks, then join the workers.
+         */
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(m_sleep_mutex);
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+            for (auto& worker: m_workers) {
+                worker.join();
+            }
+        }
+
+        /**
+         * The pool shared by the batch operations which are not given one, with one worker per core.
+         */
+        static ThreadPool& shared() {
+            static ThreadPool _instance;
+            return _instance;
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_workers.size();
+        }
+
+        /**
+         * Queue a task.
+         * @note The task must not throw, like the function of a std::thread.
+         */
+        void submit(std::function<void()> task) {
+            const size_t self = _self();
+            const size_t target = self < m_queues.size()
+                                      ? self
+                                      : m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+            {
+                auto& queue = *m_queues[target];
+                std::lock_guard lock(queue.mutex);
+                queue.tasks.push_back(std::move(task));
+                m_pending.fetch_add(1, std::memory_order_relaxed);
+            }
+            {
+                std::lock_guard lock(m_sleep_mutex);
+            }
+            m_wake.notify_one();
+        }
+
+        /**
+         * Run one pending task on the calling thread.
+         * @return False if there was none.
+         */
+        bool run_one() {
+            std::function<void()> task;
+            if (!_pop(_self(), task)) {
+                return false;
+            }
+            task();
+            return true;
+        }
+
+        /**
+         * Call `function(i)` for every i in [0, count) on the pool, and wait for all of them.
+         * @note The calling thread and up to one task per worker claim the indices one at a time,
+         * @note so the caller only blocks for the calls which are still running on other threads.
+         * @note If some calls throw, the first exception is rethrown once all of them finished.
+         */
+        template <typename Function>
+        void parallel_for(const size_t count, Function&& function) {
+            if (count == 0) {
+                return;
+            }
+            // the tasks which only start after all the calls finished find no index left, and drop the state.
+            struct Batch {
+                std::atomic<size_t> next{0};
+                std::atomic<size_t> remaining;
+                std::mutex mutex;
+                std::condition_variable done;
+                std::exception_ptr error;
+                std::remove_reference_t<Function>* function;
+                size_t count;
+            };
+            const auto batch = std::make_shared<Batch>();
+            batch->remaining.store(count, std::memory_order_relaxed);
+            batch->function = &function;
+            batch->count = count;
+            const auto run = [](Batch& state) {
+                for (size_t i = state.next.fetch_add(1, std::memory_order_relaxed); i < state.count;
+                     i = state.next.fetch_add(1, std::memory_order_relaxed)) {
+                    try {
+                        (*state.function)(i);
+                    } catch (...) {
+                        std::lock_guard lock(state.mutex);
+                        if (!state.error) {
+                            state.error = std::current_exception();
+                        }
+                    }
+                    if (state.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        std::lock_guard lock(state.mutex);
+                        state.done.notify_all();
+                    }
+                }
+            };
+            for (size_t i = 0, helpers = std::min(count - 1, size()); i < helpers; ++i) {
+                submit([batch, run]() {
+                    run(*batch);
+                });
+            }
+            run(*batch);
+            std::unique_lock lock(batch->mutex);
+            batch->done.wait(lock, [&batch]() {
+                return batch->remaining.load(std::memory_order_acquire) == 0;
+            });
+            if (batch->error) {
+                std::rethrow_exception(batch->error);
+            }
+        }
+    };
+
+    inline ReturnValueProxy CommonCallable::operator()(void* object, const RawArgList args,
+                                                       const ArgFlags rvalues) const {
+        return thunk(context, object, args, rvalues);
+    }
+
+    inline void IntoCallable::operator()(void* object, const RawArgList args, void* storage,
+                                         const ArgFlags rvalues) const {
+        thunk(context, object, args, rvalues, storage);
+    }
+
+    /**
+     * Get an argument out of a RawArgList, as the declared parameter type expects it.
+     * @note Parameters taken by value or by rvalue reference get the argument moved if it is an rvalue,
+     * @note and a copy of it otherwise. Reference parameters get the argument itself.
+     * @note Types that can't be copied are always moved.
+     */
+    template <typename ArgType>
+    decltype(auto) unpack_arg(const RawArg arg, const bool rvalue) {
+        using ValueType = remove_cvref_t<ArgType>;
+        auto& value = *reinterpret_cast<ValueType *>(arg);
+        if constexpr (!std::is_lvalue_reference_v<ArgType>
+                      && std::is_copy_constructible_v<ValueType>
+                      && !std::is_trivially_copyable_v<ValueType>) {
+            return rvalue ? ValueType(std::move(value)) : ValueType(value);
+        } else {
+            return std::forward<ValueType>(value);
+        }
+    }
+
+    /**
+     * Call the invoker with the arguments unpacked from a RawArgList, and wrap the result in a ReturnValueProxy.
+     * @note Each argument is cast to its declared type, and moved or copied into the invoker, see unpack_arg.
+     */
+    template <typename ReturnType, typename... ArgTypes, typename InvokerType, size_t... Indices>
+    ReturnValueProxy invoke_unpacked(InvokerType&& invoker, RawArgList args, const ArgFlags rvalues,
+                                     std::index_sequence<Indices...>) {
+        if constexpr (std::is_void_v<ReturnType>) {
+            invoker(unpack_arg<ArgTypes>(*(args + Indices), is_rvalue_arg(rvalues, Indices))...);
+            // if the return type is void, return a zero value, which is a nullptr.
+            return ReturnValueProxy(0);
+        } else {
+            auto ret = invoker(unpack_arg<ArgTypes>(*(args + Indices), is_rvalue_arg(rvalues, Indices))...);
+            return ReturnValueProxy(std::move(ret));
+        }
+    }
+
+    /**
+     * Construct the result of an invocation in the given storage.
+     * @note The result is constructed in place, so no temporary and no ReturnValueProxy is involved.
+     * @note Nothing is constructed for void return types.
+     */
+    template <typename ReturnType, typename InvokerType>
+    void construct_result_into(void* storage, InvokerType&& invoker) {
+        if constexpr (std::is_void_v<ReturnType>) {
+            invoker();
+        } else {
+            ::new (storage) remove_cvref_t<ReturnType>(invoker());
+        }
+    }
+
+    template <typename ReturnType, typename... ArgTypes, typename InvokerType, size_t... Indices>
+    void invoke_unpacked_into(InvokerType&& invoker, RawArgList args, const ArgFlags rvalues, void* storage,
+                              std::index_sequence<Indices...>) {
+        construct_result_into<ReturnType>(storage, [&]() -> ReturnType {
+            return invoker(unpack_arg<ArgTypes>(*(args + Indices), is_rvalue_arg(rvalues, Indices))...);
+        });
+    }
+
+    template <typename ClassType, typename ReturnType, typename... ArgTypes>
+    struct _method_thunk_base {
+        using return_type = ReturnType;
+        using class_type = ClassType;
+        static constexpr auto indices = std::index_sequence_for<ArgTypes...>{};
+
+        template <typename MethodType>
+        static auto invoker(void* object, const MethodType method) {
+            return [cls = static_cast<ClassType *>(object), method](auto&&... args) -> ReturnType {
+                return (cls->*method)(std::forward<decltype(args)>(args)...);
+            };
+        }
+
+        template <typename MethodType>
+        static ReturnValueProxy call(void* object, const MethodType method, const RawArgList args,
+                                     const ArgFlags rvalues) {
+            return invoke_unpacked<ReturnType, ArgTypes...>(invoker(object, method), args, rvalues, indices);
+        }
+
+        template <typename MethodType>
+        static void into(void* object, const MethodType method, const RawArgList args, const ArgFlags rvalues,
+                         void* storage) {
+            invoke_unpacked_into<ReturnType, ArgTypes...>(invoker(object, method), args, rvalues, storage, indices);
+        }
+    };
+
+    template <typename MethodType>
+    struct _method_thunk_traits;
+
+    template <typename ClassType, typename ReturnType, typename... ArgTypes>
+    struct _method_thunk_traits<ReturnType (ClassType::*)(ArgTypes...)>
+            : _method_thunk_base<ClassType, ReturnType, ArgTypes...> {
+    };
+
+    template <typename ClassType, typename ReturnType, typename... ArgTypes>
+    struct _method_thunk_traits<ReturnType (ClassType::*)(ArgTypes...) const>
+            : _method_thunk_base<ClassType, ReturnType, ArgTypes...> {
+    };
+
+    /**
+     * The thunks of a method known at compile time.
+     * @note The member pointer is a template argument, so the thunks are plain functions with no context,
+     * @note and the compiler can inline the method into them.
+     */
+    template <auto Method>
+    struct MethodThunk {
+        using traits = _method_thunk_traits<decltype(Method)>;
+
+        static ReturnValueProxy call(const void*, void* object, const RawArgList args, const ArgFlags rvalues) {
+            return traits::call(object, Method, args, rvalues);
+        }
+
+        static void into(const void*, void* object, const RawArgList args, const ArgFlags rvalues, void* storage) {
+            traits::into(object, Method, args, rvalues, storage);
+        }
+
+        static CommonCallable callable() noexcept {
+            return {&call, nullptr};
+        }
+
+        static IntoCallable into_callable() noexcept {
+            return {&into, nullptr};
+        }
+    };
+
+    /**
+     * The thunks of a method only known at runtime, whose member pointer is passed as the context.
+     */
+    template <typename MethodType>
+    struct MemberPointerThunk {
+        using traits = _method_thunk_traits<MethodType>;
+
+        static ReturnValueProxy call(const void* context, void* object, const RawArgList args,
+                                     const ArgFlags rvalues) {
+            return traits::call(object, *static_cast<const MethodType *>(context), args, rvalues);
+        }
+
+        static void into(const void* context, void* object, const RawArgList args, const ArgFlags rvalues,
+                         void* storage) {
+            traits::into(object, *static_cast<const MethodType *>(context), args, rvalues, storage);
+        }
+    };
+
+    /**
+     * The thunks of a function, which is passed as the context.
+     * @note The object pointer is a placeholder, to make the behavior consistent with the methods.
+     */
+    template <typename FunctionType, typename ReturnType, typename... ArgTypes>
+    struct FunctionThunk {
+        static constexpr auto indices = std::index_sequence_for<ArgTypes...>{};
+
+        static ReturnValueProxy call(const void* context, void*, const RawArgList args, const ArgFlags rvalues) {
+            return invoke_unpacked<ReturnType, ArgTypes...>(*static_cast<const FunctionType *>(context), args,
+                                                            rvalues, indices);
+        }
+
+        static void into(const void* context, void*, const RawArgList args, const ArgFlags rvalues,
+                         void* storage) {
+            invoke_unpacked_into<ReturnType, ArgTypes...>(*static_cast<const FunctionType *>(context), args,
+                                                          rvalues, storage, indices);
+        }
+    };
+
+    /**
+     * Wrap a method into a std::function, which takes the object and the RawArgList.
+     * @note The registered methods use the thunks directly, this is kept for compatibility.
+     */
+    template <typename ReturnType, typename ClassType, typename... ArgTypes>
+    auto wrap_method(ReturnType (ClassType::*method)(ArgTypes...)) {
+        return std::function<ReturnValueProxy (void*, RawArgList args)>(
+            [method](void* object, RawArgList args) {
+                return MemberPointerThunk<decltype(method)>::call(&method, object, args, all_rvalues);
+            });
+    }
+
+    template <typename ReturnType, typename ClassType, typename... ArgTypes>
+    auto wrap_method_const(ReturnType (ClassType::*method)(ArgTypes...) const) {
+        return std::function<ReturnValueProxy (void*, RawArgList args)>(
+            [method](void* object, RawArgList args) {
+                return MemberPointerThunk<decltype(method)>::call(&method, object, args, all_rvalues);
+            });
+    }
+
+    /**
+     * Wrap a function into a std::function object.
+     * @note Note that the wrapped function takes an additional void pointer as the 1st argument.
+     * @note This is to make the behavior consistent with the wrapped method.
+     */
+    template <typename ReturnType, typename... ArgTypes>
+    auto wrap_function(std::function<ReturnType (ArgTypes...)> function) {
+        using FunctionType = std::function<ReturnType (ArgTypes...)>;
+        return std::function<ReturnValueProxy (void*, RawArgList args)>(
+            [function = std::move(function)](void* placeholder, RawArgList args) {
+                return FunctionThunk<FunctionType, ReturnType, ArgTypes...>::call(&function, placeholder, args,
+                                                                                   all_rvalues);
+            });
+    }
+
+    template <typename Signature>
+    struct _signature_tag {
+        static constexpr char value = 0;
+    };
+
+    /**
+     * An id of a signature, which is unique per signature and cheap to compare.
+     * @note Methods use ReturnType(void*, ArgTypes...), and functions use ReturnType(ArgTypes...),
+     * @note with the cvref qualifiers of the argument types removed.
+     */
+    using SignatureId = const void*;
+
+    template <typename ReturnType, typename... ArgTypes>
+    constexpr SignatureId method_signature_id() noexcept {
+        return &_signature_tag<ReturnType(void*, remove_cvref_t<ArgTypes>...)>::value;
+    }
+
+    template <typename ReturnType, typename... ArgTypes>
+    constexpr SignatureId function_signature_id() noexcept {
+        return &_signature_tag<ReturnType(remove_cvref_t<ArgTypes>...)>::value;
+    }
+
+    /**
+     * Invoke a callable with typed arguments, which are passed without building an ArgList.
+     * @note The result is constructed in place through the IntoCallable when there's one, so no heap allocation is involved.
+     */
+    template <typename ReturnType, typename... ArgTypes>
+    ReturnType invoke_typed(const CommonCallable& callable, const IntoCallable& into, void* object, ArgTypes&&... args) {
+        RawArg raw_args[sizeof...(ArgTypes) + 1] = {
+            const_cast<void *>(static_cast<const void *>(std::addressof(args)))...
+        };
+        ArgFlags rvalues = 0;
+        size_t index = 0;
+        ((rvalues |= !std::is_lvalue_reference_v<ArgTypes> && index < 64 ? ArgFlags{1} << index : ArgFlags{0},
+          ++index), ...);
+        if constexpr (std::is_void_v<ReturnType>) {
+            callable(object, raw_args, rvalues);
+        } else {
+            if (!into) {
+                return callable(object, raw_args, rvalues).template get<ReturnType>();
+            }
+            alignas(ReturnType) unsigned char storage[sizeof(ReturnType)];
+            into(object, raw_args, storage, rvalues);
+            auto& result = *std::launder(reinterpret_cast<ReturnType *>(storage));
+            ReturnType ret = std::move(result);
+            result.~ReturnType();
+            return ret;
+        }
+    }
+
+    /**
+     * A pre-resolved handle to one overload of a method (or a function).
+     * @note Obtain it via ReflectionBase::resolve_method, and reuse it in hot loops:
+     * @note invoking a handle does no name lookup, no overload scanning and no type checks.
+     * @note Invoking an invalid handle does nothing, and returns ReturnValueProxy::none().
+     * @note For functions, simply pass a nullptr as the object.
+     * @code
+     * auto push_back = reflection.resolve_method<int&&>("push_back");
+     * for (int i = 0; i < n; ++i) {
+     *     push_back.invoke(ptr, make_args(i));
+     * }
+     * @endcode
+     */
+    class MethodHandle {
+        CommonCallable m_callable;
+        IntoCallable m_into;
+        std::type_index m_return_type = typeid(void);
+        std::pmr::vector<std::type_index> m_arg_types;
+        bool m_is_const = false;
+        size_t m_this_offset = 0;
+
+        [[nodiscard]] void* _adjust(void* object) const noexcept {
+            if (object == nullptr) {
+                return nullptr;
+            }
+            return static_cast<unsigned char *>(object) + m_this_offset;
+        }
+
+    public:
+        MethodHandle() = default;
+
+        explicit MethodHandle(const CallableWrapper& wrapper, const size_t this_offset = 0)
+            : m_callable(wrapper.callable),
+              m_into(wrapper.into),
+              m_return_type(wrapper.return_type),
+              m_arg_types(wrapper.arg_types),
+              m_is_const(wrapper.is_const),
+              m_this_offset(this_offset) {
+        }
+
+        explicit MethodHandle(const OverloadRef overload) : MethodHandle(*overload.wrapper, overload.this_offset) {
+        }
+
+        [[nodiscard]] bool valid() const noexcept {
+            return static_cast<bool>(m_callable);
+        }
+
+        explicit operator bool() const noexcept {
+            return valid();
+        }
+
+        [[nodiscard]] size_t arity() const noexcept {
+            return m_arg_types.size();
+        }
+
+        [[nodiscard]] bool is_const() const noexcept {
+            return m_is_const;
+        }
+
+        [[nodiscard]] std::type_index get_return_type() const noexcept {
+            return m_return_type;
+        }
+
+        [[nodiscard]] const std::pmr::vector<std::type_index>& get_arg_types() const noexcept {
+            return m_arg_types;
+        }
+
+        /**
+         * Check whether both handles invoke the same overload on the same subobject.
+         */
+        [[nodiscard]] bool same_overload(const MethodHandle& other) const noexcept {
+            return m_callable.thunk == other.m_callable.thunk && m_callable.context == other.m_callable.context
+                   && m_this_offset == other.m_this_offset;
+        }
+
+        /**
+         * Invoke the resolved overload.
+         * @note The argument types are @b NOT checked, only the argument count is.
+         * @param object The pointer to the object, or nullptr for functions.
+         * @param args The arguments, which must match the resolved signature.
+         * @return The return value, or ReturnValueProxy::none() if the handle is invalid.
+         */
+        ReturnValueProxy invoke(void* object, const ArgList& args) const {
+            if (!valid() || args.size != m_arg_types.size()) {
+                return ReturnValueProxy::none();
+            }
+            return m_callable(_adjust(object), args.get(), args.rvalue_flags());
+        }
+
+        /**
+         * @param rvalues The arguments which may be moved from, all of them by default.
+         */
+        ReturnValueProxy invoke(void* object, RawArgList args, const ArgFlags rvalues = all_rvalues) const {
+            if (!valid()) {
+                return ReturnValueProxy::none();
+            }
+            return m_callable(_adjust(object), args, rvalues);
+        }
+
+        ReturnValueProxy invoke(void* object) const {
+            if (!valid() || !m_arg_types.empty()) {
+                return ReturnValueProxy::none();
+            }
+            return m_callable(_adjust(object), nullptr);
+        }
+
+        /**
+         * Invoke the resolved overload with typed arguments, which are passed without building an ArgList.
+         * @note Neither the return type nor the argument types are checked.
+         * @tparam ReturnType The return type of the resolved overload.
+         * @tparam ArgTypes The argument types, which must match the resolved signature.
+         * @param object The pointer to the object, or nullptr for functions.
+         * @param args The arguments.
+         * @return The return value.
+         */
+        template <typename ReturnType, typename... ArgTypes>
+        ReturnType call(void* object, ArgTypes&&... args) const {
+            return invoke_typed<ReturnType>(m_callable, m_into, _adjust(object), std::forward<ArgTypes>(args)...);
+        }
+
+        /**
+         * Invoke the resolved overload, constructing the return value in caller-provided storage.
+         * @note The storage must be uninitialized, and suitable in size and alignment for ReturnType.
+         * @note The caller owns the constructed object, and is responsible for destroying it.
+         * @tparam ReturnType The return type of the resolved overload.
+         * @param object The pointer to the object, or nullptr for functions.
+         * @param storage The uninitialized storage.
+         * @param args The arguments, which must match the resolved signature.
+         * @return The pointer to the constructed value, or nullptr if the handle is invalid or the return type mismatched.
+         */
+        template <typename ReturnType>
+        ReturnType* emplace(void* object, void* storage, RawArgList args, const ArgFlags rvalues = all_rvalues) const {
+            if (!m_into || m_return_type != typeid(ReturnType)) {
+                return nullptr;
+            }
+            m_into(_adjust(object), args, storage, rvalues);
+            return std::launder(static_cast<ReturnType *>(storage));
+        }
+
+        template <typename ReturnType>
+        ReturnType* emplace(void* object, void* storage, const ArgList& args) const {
+            if (args.size != m_arg_types.size()) {
+                return nullptr;
+            }
+            return emplace<ReturnType>(object, storage, args.get(), args.rvalue_flags());
+        }
+
+        /**
+         * Invoke the resolved overload, and assign the return value to the given object.
+         * @note Trivially copyable results are constructed straight into the output, others are move-assigned.
+         * @return Whether the handle was invoked.
+         */
+        template <typename ReturnType>
+        bool invoke_into(void* object, ReturnType& out, RawArgList args) const {
+            if constexpr (std::is_trivially_copyable_v<ReturnType>) {
+                return emplace<ReturnType>(object, std::addressof(out), args) != nullptr;
+            } else {
+                alignas(ReturnType) unsigned char storage[sizeof(ReturnType)];
+                const auto result = emplace<ReturnType>(object, storage, args);
+                if (result == nullptr) {
+                    return false;
+                }
+                out = std::move(*result);
+                result->~ReturnType();
+                return true;
+            }
+        }
+
+        template <typename ReturnType>
+        bool invoke_into(void* object, ReturnType& out, const ArgList& args) const {
+            if (args.size != m_arg_types.size()) {
+                return false;
+            }
+            return invoke_into(object, out, args.get());
+        }
+
+        template <typename ReturnType>
+        bool invoke_into(void* object, ReturnType& out) const {
+            if (!m_arg_types.empty()) {
+                return false;
+            }
+            return invoke_into(object, out, static_cast<RawArgList>(nullptr));
+        }
+    };
+
+    /**
+     * The order InvocationBatch::run runs the recorded calls in.
+     */
+    enum class BatchOrder {
+        /** The order of recording. */
+        recorded,
+        /**
+         * The calls of the same handle one after the other, each in the order of recording.
+         * @note Only use it when the calls of different methods don't depend on one another.
+         */
+        by_method,
+    };
+
+    /**
+     * A list of calls of resolved methods (or functions), run in one pass into a contiguous result buffer.
+     * @note The batch keeps a copy of each distinct handle, and of the arguments of each call,
+     * @note which are passed as lvalues, so that the batch can be run again.
+     * @note A call that throws doesn't stop the others, its exception is kept instead, see error().
+     * @code
+     * auto add = reflection.resolve_method<int, int>("add");
+     * simple_reflection::InvocationBatch batch;
+     * for (auto& counter: counters) {
+     *     batch.add(&counter, add, 1, 2);
+     * }
+     * batch.run(simple_reflection::ThreadPool::shared());
+     * int first = batch.result(0).get<int>();
+     * @endcode
+     */
+    class InvocationBatch {
+        struct StoredArgs {
+            virtual ~StoredArgs() = default;
+
+            [[nodiscard]] virtual ArgList arg_list() = 0;
+        };
+
+        template <typename... ValueTypes>
+        struct StoredValues final : StoredArgs {
+            std::tuple<ValueTypes...> values;
+
+            template <typename... ArgTypes>
+            explicit StoredValues(ArgTypes&&... args) : values(std::forward<ArgTypes>(args)...) {
+            }
+
+            [[nodiscard]] ArgList arg_list() override {
+                return std::apply([](auto&... arguments) {
+                    return refl_args(arguments...);
+                }, values);
+            }
+        };
+
+        struct Call {
+            void* object;
+            size_t handle;
+            // nullptr for calls without arguments.
+            std::unique_ptr<StoredArgs> args;
+        };
+
+        std::vector<MethodHandle> m_handles;
+        std::vector<Call> m_calls;
+        std::vector<ReturnValueProxy> m_results;
+        std::vector<std::exception_ptr> m_errors;
+
+        void _prepare() {
+            m_results.assign(m_calls.size(), ReturnValueProxy::none());
+            m_errors.assign(m_calls.size(), nullptr);
+        }
+
+        void _run_call(const size_t index) noexcept {
+            const auto& call = m_calls[index];
+            const auto& handle = m_handles[call.handle];
+            try {
+                if (call.args == nullptr) {
+                    m_results[index] = handle.invoke(call.object);
+                } else {
+                    const auto args = call.args->arg_list();
+                    m_results[index] = handle.invoke(call.object, args);
+                }
+            } catch (...) {
+                m_errors[index] = std::current_exception();
+            }
+        }
+
+        [[nodiscard]] size_t _handle_index(const MethodHandle& handle) {
+            // command streams tend to repeat the same few methods.
+            for (size_t i = m_handles.size(); i-- > 0;) {
+                if (m_handles[i].same_overload(handle)) {
+                    return i;
+                }
+            }
+            m_handles.push_back(handle);
+            return m_handles.size() - 1;
+        }
+
+    public:
+        /**
+         * Record a call.
+         * @exception std::invalid_argument If the types of the arguments don't match the signature of the handle.
+         * @param object The pointer to the object, or nullptr for functions.
+         * @param handle The resolved overload, invalid handles return ReturnValueProxy::none().
+         * @param args The arguments, which are copied (or moved) into the batch.
+         * @return The index of the call in the results.
+         */
+        template <typename... ArgTypes>
+        size_t add(void* object, const MethodHandle& handle, ArgTypes&&... args) {
+            const auto signature = StaticSignature<remove_cvref_t<ArgTypes>...>::span();
+            if (handle.valid() && !std::equal(signature.begin(), signature.end(),
+                                              handle.get_arg_types().begin(), handle.get_arg_types().end())) {
+                throw std::invalid_argument("the arguments don't match the signature of the method handle");
+            }
+            std::unique_ptr<StoredArgs> stored;
+            if constexpr (sizeof...(ArgTypes) != 0) {
+                stored = std::make_unique<StoredValues<remove_cvref_t<ArgTypes>...>>(std::forward<ArgTypes>(args)...);
+            }
+            m_calls.push_back({object, _handle_index(handle), std::move(stored)});
+            return m_calls.size() - 1;
+        }
+
+        void reserve(const size_t count) {
+            m_calls.reserve(count);
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return m_calls.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return m_calls.empty();
+        }
+
+        /**
+         * Forget the recorded calls and their results.
+         */
+        void clear() noexcept {
+            m_handles.clear();
+            m_calls.clear();
+            m_results.clear();
+            m_errors.clear();
+        }
+
+        /**
+         * Run the recorded calls on the calling thread.
+         */
+        void run(const BatchOrder order = BatchOrder::recorded) {
+            _prepare();
+            if (order == BatchOrder::recorded) {
+                for (size_t i = 0; i < m_calls.size(); ++i) {
+                    _run_call(i);
+                }
+                return;
+            }
+            std::vector<size_t> indices(m_calls.size());
+            std::iota(indices.begin(), indices.end(), size_t{0});
+            std::stable_sort(indices.begin(), indices.end(), [this](const size_t lhs, const size_t rhs) {
+                return m_calls[lhs].handle < m_calls[rhs].handle;
+            });
+            for (const auto index: indices) {
+                _run_call(index);
+            }
+        }
+
+        /**
+         * Run the recorded calls on a pool, and wait for them.
+         * @note The calls on the same object run on the same thread, in the order of recording,
+         * @note so an object is never entered by two threads at once. The calls of functions are independent.
+         * @param pool The pool.
+         * @param min_chunk_size The smallest number of calls worth a task.
+         */
+        void run(ThreadPool& pool, const size_t min_chunk_size = 64) {
+            _prepare();
+            std::vector<size_t> indices(m_calls.size());
+            std::iota(indices.begin(), indices.end(), size_t{0});
+            std::stable_sort(indices.begin(), indices.end(), [this](const size_t lhs, const size_t rhs) {
+                return std::less<void *>()(m_calls[lhs].object, m_calls[rhs].object);
+            });
+
+            const size_t chunk_size = std::max<size_t>(
+                std::max<size_t>(min_chunk_size, 1), m_calls.size() / (pool.size() * 4) + 1);
+            // a chunk may only end where the object changes.
+            std::vector<size_t> bounds{0};
+            for (size_t i = 1; i < indices.size(); ++i) {
+                const auto object = m_calls[indices[i]].object;
+                if (i - bounds.back() >= chunk_size
+                    && (object == nullptr || object != m_calls[indices[i - 1]].object)) {
+                    bounds.push_back(i);
+                }
+            }
+            bounds.push_back(indices.size());
+
+            if (bounds.size() <= 2 || pool.size() == 1) {
+                for (const auto index: indices) {
+                    _run_call(index);
+                }
+                return;
+            }
+            pool.parallel_for(bounds.size() - 1, [this, &indices, &bounds](const size_t chunk) {
+                for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+                    _run_call(indices[i]);
+                }
+            });
+        }
+
+        /**
+         * The return values of the last run, indexed like the calls.
+         * @note The entry of a call which threw is ReturnValueProxy::none().
+         */
+        [[nodiscard]] const std::vector<ReturnValueProxy>& results() const noexcept {
+            return m_results;
+        }
+
+        [[nodiscard]] const ReturnValueProxy& result(const size_t index) const {
+            return m_results.at(index);
+        }
+
+        [[nodiscard]] ReturnValueProxy& result(const size_t index) {
+            return m_results.at(index);
+        }
+
+        /**
+         * The exception thrown by a call of the last run, or nullptr.
+         */
+        [[nodiscard]] std::exception_ptr error(const size_t index) const {
+            return m_errors.at(index);
+        }
+
+        [[nodiscard]] size_t failures() const noexcept {
+            return static_cast<size_t>(std::count_if(m_errors.begin(), m_errors.end(),
+                                                     [](const std::exception_ptr& error) {
+                                                         return error != nullptr;
+                                                     }));
+        }
+
+        /**
+         * Rethrow the exception of the first call, in the order of recording, which threw in the last run.
+         */
+        void rethrow() const {
+            for (const auto& error: m_errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+    };
+
+    /**
+     * The eventual result of an invocation run on a ThreadPool, see ReflectionBase::invoke_async.
+     * @note get() blocks until the invocation finished, and rethrows what it threw.
+     * @note then() registers a callback which the thread finishing the invocation runs,
+     * @note or which the caller runs right away if the invocation already finished.
+     * @note The continuation must not throw, an exception escaping it on the pool calls std::terminate.
+     * @note With SIMPLE_REFL_HAS_COROUTINES, it can also be co_awaited without blocking.
+     * @note The awaiting coroutine is resumed by the thread which finished the invocation,
+     * @note so an event loop would post its continuation back to itself from there.
+     */
+    class InvocationFuture {
+        struct State {
+            std::mutex mutex;
+            std::condition_variable finished;
+            bool done = false;
+            ReturnValueProxy value = ReturnValueProxy::none();
+            std::exception_ptr error;
+            std::function<void()> continuation;
+        };
+
+        std::shared_ptr<State> m_state;
+
+        // noexcept: a throwing continuation terminates, like an exception escaping a std::thread.
+        static void _finish(State& state, ReturnValueProxy&& value, std::exception_ptr error) noexcept {
+            std::function<void()> continuation;
+            {
+                std::lock_guard lock(state.mutex);
+                state.value = std::move(value);
+                state.error = std::move(error);
+                state.done = true;
+                continuation = std::move(state.continuation);
+            }
+            state.finished.notify_all();
+            if (continuation) {
+                continuation();
+            }
+        }
+
+        // queue the continuation, or return false if the invocation finished already.
+        bool _defer(std::function<void()>& continuation) const {
+            std::lock_guard lock(m_state->mutex);
+            if (m_state->done) {
+                return false;
+            }
+            if (m_state->continuation) {
+                continuation = [first = std::move(m_state->continuation), second = std::move(continuation)]() {
+                    first();
+                    second();
+                };
+            }
+            m_state->continuation = std::move(continuation);
+            return true;
+        }
+
+    public:
+        InvocationFuture() = default;
+
+        /**
+         * Run a callable returning a ReturnValueProxy on a pool.
+         * @note The callable may be move-only.
+         */
+        template <typename Body>
+        static InvocationFuture submit(ThreadPool& pool, Body&& body) {
+            InvocationFuture future;
+            future.m_state = std::make_shared<State>();
+            auto task = std::make_shared<remove_cvref_t<Body>>(std::forward<Body>(body));
+            pool.submit([state = future.m_state, task]() {
+                ReturnValueProxy value = ReturnValueProxy::none();
+                std::exception_ptr error;
+                try {
+                    value = (*task)();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                _finish(*state, std::move(value), std::move(error));
+            });
+            return future;
+        }
+
+        [[nodiscard]] bool valid() const noexcept {
+            return m_state != nullptr;
+        }
+
+        [[nodiscard]] bool ready() const {
+            std::lock_guard lock(m_state->mutex);
+            return m_state->done;
+        }
+
+        void wait() const {
+            std::unique_lock lock(m_state->mutex);
+            m_state->finished.wait(lock, [this]() {
+                return m_state->done;
+            });
+        }
+
+        /**
+         * Wait for the invocation, and get its return value.
+         * @exception Whatever the invoked method threw.
+         */
+        [[nodiscard]] ReturnValueProxy get() const {
+            wait();
+            if (m_state->error) {
+                std::rethrow_exception(m_state->error);
+            }
+            return m_state->value;
+        }
+
+        /**
+         * Call the continuation once the invocation finished, see the class notes for the thread it runs on.
+         */
+        void then(std::function<void()> continuation) const {
+            if (!_defer(continuation)) {
+                continuation();
+            }
         }
 
-        static ReturnValueProxy none() {
-            return {nullptr, 0, typeid(void)};
+#if SIMPLE_REFL_HAS_COROUTINES
+        [[nodiscard]] bool await_ready() const {
+            return ready();
         }
 
-        [[nodiscard]] bool is_none() const {
-            return this->type_index == typeid(void)
-                   && this->ptr == nullptr && this->size == 0;
+        bool await_suspend(const std::coroutine_handle<> awaiting) const {
+            std::function<void()> continuation = [awaiting]() {
+                awaiting.resume();
+            };
+            return _defer(continuation);
+        }
+
+        ReturnValueProxy await_resume() const {
+            return get();
         }
+#endif
+    };
+
+    ReflectionBase& get_reflection(std::type_index index);
+
+    ReflectionBase* try_get_reflection(std::type_index index);
+
+    using NameTypeInfo = std::pair<std::string, std::type_index>;
+
+    using NameTypeInfoList = std::vector<NameTypeInfo>;
+    using NameTypeInfoMap = std::unordered_map<std::string, NameTypeInfo>;
+
+    // Return type, class type, argument types.
+    using MethodInfo = std::tuple<std::type_index, std::type_index, std::vector<std::type_index>>;
+    // Return type, argument types.
+    using FunctionInfo = std::tuple<std::type_index, std::vector<std::type_index>>;
+
+    using CallableInfo = std::variant<MethodInfo, FunctionInfo>;
+    using OverloadedCallableInfo = std::vector<CallableInfo>;
+
+    using NameCallableInfo = std::pair<std::string, OverloadedCallableInfo>;
+
+    using NameCallableInfoList = std::vector<NameCallableInfo>;
+    using NameCallableInfoMap = std::unordered_map<std::string, NameCallableInfo>;
+
+    /**
+     * The names and types of the members and callables registered on a class.
+     * @note The lists are in the order of declaration, i.e. of the first registration of each name.
+     * @note It is rebuilt after a registration on the class or one of its bases, see ReflectionBase::get_descriptor.
+     */
+    struct ReflectionDescriptor {
+        NameTypeInfoList members;
+        NameTypeInfoMap member_map;
+        NameCallableInfoList callables;
+        NameCallableInfoMap callable_map;
     };
 
     /**
-     * A struct to represent a phantom data.
-     * This class is mainly applied to handle the life cycle of classes like ReturnValueProxy.
-     * In cases like reusing the same identifier to store different instances of ReturnValueProxy,
-     * while keeping the memory valid.
+     * The overloads registered under one name.
+     * @note The copy is deleted, so that growing the table of a reflection moves the deque instead of copying it,
+     * @note which keeps the addresses of the registered overloads, that OverloadRef points to.
      */
-    class PhantomDataHelper {
-        std::stack<PhantomData> phantom_data = {};
+    struct OverloadList : std::pmr::deque<CallableWrapper> {
+        using std::pmr::deque<CallableWrapper>::deque;
 
-    public:
-        PhantomDataHelper() {
-            this->phantom_data = {};
+        OverloadList(OverloadList&&) = default;
+        OverloadList(const OverloadList&) = delete;
+        OverloadList& operator=(OverloadList&&) = default;
+        OverloadList& operator=(const OverloadList&) = delete;
+    };
+
+    /**
+     * A class for reflection.
+     */
+    class ReflectionBase {
+        SymbolMap<Member> m_offsets = {};
+        SymbolMap<OverloadList> m_funcs = {};
+        SymbolMap<Metadata> m_metadata = {};
+        // the names of m_offsets and m_funcs in the order of their first registration.
+        std::pmr::vector<Symbol> m_member_order{registry_memory_resource()};
+        std::pmr::vector<Symbol> m_func_order{registry_memory_resource()};
+
+        std::pmr::vector<std::type_index> m_derived_from{registry_memory_resource()};
+
+        std::type_index m_base_type_index = typeid(void);
+        // interned, see TypeNameInterner.
+        std::string_view m_base_type_name;
+        ValueLayout m_layout = {};
+        // the offset of the DirtySet member, see track_changes.
+        size_t m_dirty_offset = no_dirty_set;
+
+        template <typename ReturnType, typename... ArgTypes>
+        static constexpr SignatureId _method_signature_id(const std::tuple<ArgTypes...>&) noexcept {
+            return method_signature_id<ReturnType, ArgTypes...>();
         }
 
-        ~PhantomDataHelper() {
-            while (!this->phantom_data.empty()) {
-                this->phantom_data.pop();
+        static CallableInfo _parse_callable(const CallableWrapper& func) {
+            if (std::holds_alternative<std::monostate>(func.parent_type)) {
+                FunctionInfo fn_info = std::make_tuple(
+                    func.return_type, std::vector<std::type_index>{
+                        func.arg_types.begin(),
+                        func.arg_types.end()
+                    });
+                return {fn_info};
             }
+            MethodInfo fn_info = std::make_tuple(
+                func.return_type, std::get<std::type_index>(func.parent_type),
+                std::vector<std::type_index>{func.arg_types.begin(), func.arg_types.end()});
+            return {fn_info};
         }
 
-        PhantomDataHelper(const PhantomDataHelper& other) {
-            this->phantom_data = other.phantom_data;
+        [[nodiscard]] ReflectionDescriptor _build_descriptor() const {
+            ReflectionDescriptor descriptor;
+            descriptor.members.reserve(m_member_order.size());
+            descriptor.member_map.reserve(m_member_order.size());
+            for (const auto name: m_member_order) {
+                descriptor.members.emplace_back(name.str(), m_offsets.find(name)->type_info);
+                descriptor.member_map.emplace(name.str(), descriptor.members.back());
+            }
+            descriptor.callables.reserve(m_func_order.size());
+            descriptor.callable_map.reserve(m_func_order.size());
+            for (const auto name: m_func_order) {
+                OverloadedCallableInfo info;
+                for (const auto& func: *m_funcs.find(name)) {
+                    info.emplace_back(_parse_callable(func));
+                }
+                descriptor.callables.emplace_back(name.str(), std::move(info));
+                descriptor.callable_map.emplace(name.str(), descriptor.callables.back());
+            }
+            return descriptor;
         }
 
-        PhantomDataHelper(PhantomDataHelper&& other) noexcept {
-            this->phantom_data = std::move(other.phantom_data);
+        /**
+         * A step of clone_into, equals or hash.
+         * @note Steps without ops are blocks, i.e. runs of adjacent members handled as raw bytes.
+         */
+        struct ValueStep {
+            size_t offset = 0;
+            size_t size = 0;
+            MemberSetter setter = nullptr;
+            MemberEquals equals = nullptr;
+            MemberHash hash = nullptr;
+        };
+
+        /**
+         * The members and methods of this class and all of its bases, merged into single tables.
+         * @note Inherited members carry offsets adjusted by the offset of the base subobject,
+         * @note and inherited methods carry the offset of the subobject they are invoked on.
+         * @note Entries of this class come first, so they shadow the inherited ones.
+         */
+        struct FlatTables {
+            static constexpr size_t overload_cache_size = 64;
+
+            // the registration epoch the tables were last found up to date at, see _rebuild_flat_tables.
+            mutable std::atomic<uint64_t> epoch{0};
+            // the version of the reflection, and the tables of the bases, the tables were built from.
+            uint64_t version = 0;
+            std::vector<const FlatTables*> bases;
+            SymbolMap<Member> members;
+            // the entries of members in the order of declaration, the members of the bases first.
+            std::vector<std::pair<Symbol, const Member*>> declared_members;
+            SymbolMap<std::vector<OverloadRef>> methods;
+            // the offset of the DirtySet of this class, or of the first base which tracks its changes.
+            size_t dirty_offset = no_dirty_set;
+
+            // the members in the order of their offsets, see _build_value_steps.
+            std::vector<ValueStep> copy_steps;
+            std::vector<ValueStep> compare_steps;
+
+            // the descriptor of the class, built on first use, see get_descriptor.
+            mutable std::atomic<const ReflectionDescriptor*> descriptor{nullptr};
+            mutable std::mutex descriptor_mutex;
+            mutable std::shared_ptr<const ReflectionDescriptor> owned_descriptor;
+
+            /**
+             * The overloads resolved so far, see _resolve_overload.
+             * @note Each slot packs the symbol id, a hash of the signature and the index of the chosen overload
+             * @note into one word, so that it can be read and written without locking.
+             * @note Since the tables are rebuilt on every registration on the hierarchy, so is the cache.
+             */
+            mutable std::array<std::atomic<uint64_t>, overload_cache_size> overload_cache{};
+        };
+
+        /**
+         * A reflection looked up while building a plan, and its version at the time, see cached_plan.
+         */
+        struct PlanDependency {
+            const ReflectionBase* reflection;
+            uint64_t version;
+
+            bool operator==(const PlanDependency& other) const noexcept {
+                return reflection == other.reflection && version == other.version;
+            }
+        };
+
+        /**
+         * The lookups made while building a plan, see note_plan_lookup.
+         */
+        struct PlanRecorder {
+            std::vector<PlanDependency> found;
+            std::vector<std::type_index> missing;
+        };
+
+        /**
+         * A cached plan, and what it was built from.
+         * @note The plan is valid as long as the tables are the current ones, the versions of the dependencies
+         * @note did not move, and the missing types are still missing, which is checked again once a type got
+         * @note registered anywhere, i.e. the type registration epoch moved past type_epoch.
+         */
+        struct PlanEntry {
+            const FlatTables* tables = nullptr;
+            std::vector<PlanDependency> found;
+            std::vector<std::type_index> missing;
+            mutable std::atomic<uint64_t> type_epoch{0};
+            std::shared_ptr<const void> plan;
+        };
+
+        /**
+         * The cache of the flattened tables, and of the plans built from them.
+         * @note Tables are checked again once the registration epoch moves, i.e. something got registered anywhere,
+         * @note but only rebuilt if this class or one of its bases registered something since.
+         * @note Tables are published through an atomic pointer, so lookups never lock, and concurrent rebuilds are safe.
+         * @note The replaced tables are kept as long as the reflection, so the references into them never dangle.
+         * @note There are no more of them than registrations on the hierarchy, each of which rebuilds them at most once.
+         */
+        struct FlatCache {
+            std::mutex mutex;
+            std::atomic<const FlatTables*> current{nullptr};
+            // bumped by every registration on this reflection.
+            std::atomic<uint64_t> version{0};
+            std::deque<std::unique_ptr<FlatTables>> history;
+            // the parsed type name, which is only computed when asked for.
+            std::unique_ptr<const ParsedTypeString> type_parsed;
+            // set once the reflection is published to the lock-free readers, see mark_published.
+            std::atomic<bool> published{false};
+            // the plans, see cached_plan, which are held by their users as long as they need them.
+            std::shared_mutex plans_mutex;
+            std::array<std::shared_ptr<const PlanEntry>, 8> plans;
+        };
+
+        struct BaseClass {
+            std::type_index type_index;
+            size_t offset;
+        };
+
+        std::pmr::vector<BaseClass> m_base_offsets{registry_memory_resource()};
+        std::unique_ptr<FlatCache> m_flat_cache = std::make_unique<FlatCache>();
+
+        static size_t _next_plan_slot() noexcept {
+            static std::atomic<size_t> next{0};
+            return next.fetch_add(1, std::memory_order_relaxed);
         }
 
-        PhantomDataHelper& operator=(const PhantomDataHelper& other) = default;
+        template <typename Plan>
+        static size_t _plan_slot() noexcept {
+            static const size_t slot = _next_plan_slot();
+            return slot;
+        }
 
-        PhantomDataHelper& operator=(PhantomDataHelper&& other) noexcept {
-            this->phantom_data = std::move(other.phantom_data);
-            return *this;
+        static PlanRecorder*& _plan_recorder() noexcept {
+            thread_local PlanRecorder* recorder = nullptr;
+            return recorder;
         }
 
-        void push(PhantomData phantom) {
-            this->phantom_data.push(std::move(phantom));
+        [[nodiscard]] uint64_t _version() const noexcept {
+            return m_flat_cache->version.load(std::memory_order_acquire);
         }
 
-        void clear() {
-            while (!this->phantom_data.empty()) {
-                this->phantom_data.pop();
+        [[nodiscard]] static bool _plan_valid(const PlanEntry& entry, const FlatTables& tables) {
+            if (entry.tables != &tables) {
+                return false;
+            }
+            for (const auto& dependency: entry.found) {
+                if (dependency.reflection->_version() != dependency.version) {
+                    return false;
+                }
+            }
+            const uint64_t epoch = type_registration_epoch().load(std::memory_order_acquire);
+            if (entry.type_epoch.load(std::memory_order_acquire) == epoch) {
+                return true;
             }
+            for (const auto& type: entry.missing) {
+                if (try_get_reflection(type) != nullptr) {
+                    return false;
+                }
+            }
+            entry.type_epoch.store(epoch, std::memory_order_release);
+            return true;
         }
 
-        PhantomDataHelper& operator<<(PhantomData rhs) {
-            this->push(std::move(rhs));
-            return *this;
+        static void _push_value_step(std::vector<ValueStep>& steps, const Member& member, const bool as_bytes,
+                                     ValueStep step) {
+            if (as_bytes) {
+                if (!steps.empty() && steps.back().setter == nullptr && steps.back().equals == nullptr
+                    && steps.back().offset + steps.back().size == member.offset) {
+                    steps.back().size += member.size;
+                    return;
+                }
+                step = {};
+            }
+            step.offset = member.offset;
+            step.size = member.size;
+            steps.push_back(step);
         }
 
-        PhantomDataHelper& operator<<(const PhantomDataProvider& rhs) {
-            this->push(std::move(rhs.phantom()));
-            return *this;
+        static void _build_value_steps(FlatTables& tables) {
+            std::vector<const Member*> members;
+            members.reserve(tables.members.size());
+            for (const auto& [name, member]: tables.members) {
+                members.push_back(&member);
+            }
+            std::sort(members.begin(), members.end(), [](const Member* lhs, const Member* rhs) {
+                return lhs->offset < rhs->offset;
+            });
+
+            size_t end = 0;
+            for (const auto member: members) {
+                // members registered twice, under different names, are only visited once.
+                if (member->offset < end) {
+                    continue;
+                }
+                end = member->offset + member->size;
+                if (!member->is_const) {
+                    _push_value_step(tables.copy_steps, *member, member->trivially_copyable,
+                                     {0, 0, member->setter, nullptr, nullptr});
+                }
+                _push_value_step(tables.compare_steps, *member, member->bitwise_comparable,
+                                 {0, 0, nullptr, member->equals, member->hash});
+            }
         }
 
-        friend PhantomDataHelper& operator>>(PhantomData lhs, PhantomDataHelper& rhs) {
-            rhs.push(std::move(lhs));
-            return rhs;
+        /**
+         * Throw if the reflection was published, since the lock-free readers can't see a registration safely.
+         */
+        void _check_unpublished() const {
+            if (m_flat_cache->published.load(std::memory_order_acquire)) {
+                throw std::logic_error("cannot register on " + std::string(m_base_type_name)
+                                       + " after it was published");
+            }
         }
 
-        friend PhantomDataHelper& operator>>(const PhantomDataProvider& lhs, PhantomDataHelper& rhs) {
-            rhs.push(std::move(lhs.phantom()));
-            return rhs;
+        void _bump_version() noexcept {
+            m_flat_cache->version.fetch_add(1, std::memory_order_acq_rel);
+            bump_registration_epoch();
         }
-    };
 
-    // wtf is this!?
-    template <typename ReturnType, typename ClassType, typename... ArgTypes, size_t... Indices>
-    auto wrap_method_impl(ReturnType (ClassType::*method)(ArgTypes...), std::index_sequence<Indices...>) {
-        return std::function<ReturnValueProxy (void*, RawArgList args)>(
-            // here we use a lambda function to wrap the method,
-            // the lambda takes a void* object and a void** args,
-            // the void* is the pointer to the object, whose method is about to be invoked,
-            // while the void** args is the array of arguments.
-            [method](void* object, RawArgList args) -> ReturnValueProxy {
-                // cast the void* object to the correct type.
-                auto cls = static_cast<ClassType *>(object);
-                // invoke the method, and return the result.
-                // return the result in the form of a ReturnValueProxy, which is a wrapper for the return value.
-                // type-erased, and can manage life cycle of the return value.
-                if constexpr (std::is_void_v<ReturnType>) {
-                    (cls->*method)(
-                        std::forward<remove_cvref_t<ArgTypes>>(
-                            *reinterpret_cast<remove_cvref_t<ArgTypes> *>(*(args + Indices)))...);
-                    // if the return type is void, return a zero value, which is a nullptr.
-                    return ReturnValueProxy(0);
-                } else {
-                    auto ret = (cls->*method)(
-                        // use std::forward to forward the arguments to the method.
-                        std::forward<remove_cvref_t<ArgTypes>>(
-                            // cast the void* to the correct type,
-                            // and then dereference it to get the value.
-                            *reinterpret_cast<remove_cvref_t<ArgTypes> *>(
-                                // as mentioned above, the void** args is an array of pointers,
-                                // so here we use an offset to get the pointer to a specific argument.
-                                // and then dereference it to get the value.
-                                *(args + Indices)
-                            )
-                        )... // argument pack.
-                    );
-                    return ReturnValueProxy(std::move(ret));
+        /**
+         * Get the current tables of the bases, nullptr for the bases which aren't registered.
+         */
+        [[nodiscard]] std::vector<const FlatTables*> _base_tables() const {
+            std::vector<const FlatTables*> bases;
+            bases.reserve(m_base_offsets.size());
+            for (const auto& base_class: m_base_offsets) {
+                const auto base = try_get_reflection(base_class.type_index);
+                bases.push_back(base == nullptr ? nullptr : &base->_flat_tables());
+            }
+            return bases;
+        }
+
+        const FlatTables& _rebuild_flat_tables() const {
+            std::lock_guard lock(m_flat_cache->mutex);
+            const uint64_t epoch = registration_epoch().load(std::memory_order_acquire);
+            const uint64_t version = m_flat_cache->version.load(std::memory_order_acquire);
+            auto bases = _base_tables();
+            if (const auto current = m_flat_cache->current.load(std::memory_order_acquire); current != nullptr) {
+                if (current->epoch.load(std::memory_order_acquire) == epoch) {
+                    return *current;
                 }
-            });
-    }
+                // something unrelated got registered.
+                if (current->version == version && current->bases == bases) {
+                    current->epoch.store(epoch, std::memory_order_release);
+                    return *current;
+                }
+            }
 
-    template <typename ReturnType, typename ClassType, typename... ArgTypes>
-    auto wrap_method(ReturnType (ClassType::*method)(ArgTypes...)) {
-        return wrap_method_impl(method, std::make_index_sequence<sizeof...(ArgTypes)>{});
-    }
+            _record_stat(StatKind::table_rebuild, Symbol());
+            auto tables = std::make_unique<FlatTables>();
+            tables->epoch.store(epoch, std::memory_order_relaxed);
+            tables->version = version;
+            tables->bases = bases;
+            tables->members = SymbolMap<Member>(m_offsets);
+            for (const auto& [name, overloads]: m_funcs) {
+                auto& refs = tables->methods[name];
+                refs.reserve(overloads.size());
+                for (const auto& fn: overloads) {
+                    refs.push_back({&fn, 0});
+                }
+            }
 
-    template <typename ReturnType, typename ClassType, typename... ArgTypes, size_t... Indices>
-    auto wrap_method_const_impl(ReturnType (ClassType::*method)(ArgTypes...) const, std::index_sequence<Indices...>) {
-        return std::function<ReturnValueProxy (void*, RawArgList args)>(
-            [method](void* object, RawArgList args) -> ReturnValueProxy {
-                const auto cls = static_cast<ClassType *>(object);
-                constexpr size_t arg_size = sizeof...(ArgTypes);
-                if constexpr (std::is_void_v<ReturnType>) {
-                    if constexpr (arg_size == 0) {
-                        (cls->*method)();
-                        return ReturnValueProxy(0);
+            std::vector<Symbol> declared;
+            tables->dirty_offset = m_dirty_offset;
+            for (size_t i = 0; i < m_base_offsets.size(); ++i) {
+                if (bases[i] == nullptr) {
+                    continue;
+                }
+                const auto& base_tables = *bases[i];
+                const auto base_offset = m_base_offsets[i].offset;
+                if (tables->dirty_offset == no_dirty_set && base_tables.dirty_offset != no_dirty_set) {
+                    tables->dirty_offset = base_tables.dirty_offset + base_offset;
+                }
+                for (const auto& [name, member]: base_tables.declared_members) {
+                    if (tables->members.find(name) != nullptr) {
+                        continue;
                     }
-                    (cls->*method)(
-                        std::forward<remove_cvref_t<ArgTypes>>(
-                            *reinterpret_cast<remove_cvref_t<ArgTypes> *>(*(args + Indices)))...);
-                    return ReturnValueProxy(0);
-                } else {
-                    if constexpr (arg_size == 0) {
-                        return ReturnValueProxy((cls->*method)());
+                    Member inherited = *member;
+                    inherited.offset += base_offset;
+                    tables->members.try_emplace(name, inherited);
+                    declared.push_back(name);
+                }
+                for (const auto& [name, refs]: base_tables.methods) {
+                    auto& merged = tables->methods[name];
+                    for (const auto& ref: refs) {
+                        merged.push_back({ref.wrapper, ref.this_offset + base_offset});
                     }
-                    auto ret = (cls->*method)(
-                        std::forward<remove_cvref_t<ArgTypes>>(
-                            *reinterpret_cast<remove_cvref_t<ArgTypes> *>(
-                                *(args + Indices)))...);
-                    return ReturnValueProxy(std::move(ret));
                 }
-            });
-    }
+            }
 
-    template <typename ReturnType, typename ClassType, typename... ArgTypes>
-    auto wrap_method_const(ReturnType (ClassType::*method)(ArgTypes...) const) {
-        return wrap_method_const_impl(method, std::make_index_sequence<sizeof...(ArgTypes)>{});
-    }
+            declared.insert(declared.end(), m_member_order.begin(), m_member_order.end());
+            tables->declared_members.reserve(declared.size());
+            for (const auto name: declared) {
+                auto* member = tables->members.find(name);
+                member->table_index = static_cast<uint32_t>(tables->declared_members.size());
+                member->dirty_offset = tables->dirty_offset;
+                tables->declared_members.emplace_back(name, member);
+            }
+            _build_value_steps(*tables);
 
-    /**
-     * Wrap a function into a std::function object.
-     * @note Note that the wrapped function takes an additional void pointer as the 1st argument.
-     * @note This is to make the behavior consistent with the wrapped method.
-     * @tparam ReturnType The return type of the function.
-     * @tparam ArgTypes The argument types of the function.
-     * @tparam Indices
-     * @param function The function to be wrapped.
-     * @return A std::function object that wraps the function.
-     */
-    template <typename ReturnType, typename... ArgTypes, size_t... Indices>
-    auto wrap_function_impl(std::function<ReturnType (ArgTypes...)> function, std::index_sequence<Indices...>) {
-        return std::function<ReturnValueProxy (void*, RawArgList args)>(
-            [function](void* placeholder, RawArgList args) -> ReturnValueProxy {
-                constexpr size_t arg_size = sizeof...(ArgTypes);
-                if constexpr (std::is_void_v<ReturnType>) {
-                    if constexpr (arg_size == 0) {
-                        function();
-                        return ReturnValueProxy(0);
-                    }
-                    function(
-                        std::forward<remove_cvref_t<ArgTypes>>(
-                            *reinterpret_cast<remove_cvref_t<ArgTypes> *>(*(args + Indices)))...);
-                    return ReturnValueProxy(0);
-                } else {
-                    if constexpr (arg_size == 0) {
-                        auto ret = function();
-                        return ReturnValueProxy(std::move(ret));
-                    }
-                    auto ret = function(
-                        std::forward<remove_cvref_t<ArgTypes>>(
-                            *reinterpret_cast<remove_cvref_t<ArgTypes> *>(
-                                *(args + Indices)))...);
-                    return ReturnValueProxy(std::move(ret));
+            const auto published = tables.get();
+            m_flat_cache->history.push_back(std::move(tables));
+            m_flat_cache->current.store(published, std::memory_order_release);
+            return *published;
+        }
+
+        std::shared_ptr<const ReflectionDescriptor> _build_shared_descriptor(const FlatTables& tables) const {
+            auto built = std::make_shared<const ReflectionDescriptor>(_build_descriptor());
+            std::lock_guard lock(tables.descriptor_mutex);
+            if (tables.descriptor.load(std::memory_order_acquire) == nullptr) {
+                tables.owned_descriptor = std::move(built);
+                tables.descriptor.store(tables.owned_descriptor.get(), std::memory_order_release);
+            }
+            return tables.owned_descriptor;
+        }
+
+        [[nodiscard]] const FlatTables& _flat_tables() const {
+            if (const auto current = m_flat_cache->current.load(std::memory_order_acquire);
+                current != nullptr && current->epoch.load(std::memory_order_acquire)
+                                      == registration_epoch().load(std::memory_order_acquire)) {
+                return *current;
+            }
+            return _rebuild_flat_tables();
+        }
+
+        template <typename KeyType>
+        static Symbol _stat_symbol(const KeyType& name) noexcept {
+            if constexpr (std::is_same_v<KeyType, Symbol>) {
+                return name;
+            } else {
+                return Symbol::find(name);
+            }
+        }
+
+        template <typename KeyType>
+        void _record_stat(const StatKind kind, const KeyType& name) const {
+            if constexpr (stats_enabled) {
+                ReflectionStats::record(kind, m_base_type_name, _stat_symbol(name));
+            }
+        }
+
+        template <typename Exception, typename KeyType>
+        [[noreturn]] void _throw_not_found(const KeyType& name) const {
+            _record_stat(StatKind::exception, name);
+            throw Exception(std::string(name));
+        }
+
+        template <typename KeyType>
+        [[nodiscard]] const Member* _find_member(const KeyType& name) const {
+            const auto member = _flat_tables().members.find(name);
+            if constexpr (stats_enabled) {
+                _record_stat(StatKind::member_access, name);
+                if (member != nullptr && m_offsets.find(name) == nullptr) {
+                    _record_stat(StatKind::base_class_hit, name);
                 }
-            });
-    }
+            }
+            return member;
+        }
 
-    template <typename ReturnType, typename... ArgTypes>
-    auto wrap_function(std::function<ReturnType (ArgTypes...)> function) {
-        return wrap_function_impl(function, std::make_index_sequence<sizeof...(ArgTypes)>{});
-    }
+        template <typename KeyType>
+        [[nodiscard]] const std::vector<OverloadRef>* _find_methods(const KeyType& name) const {
+            const auto overloads = _flat_tables().methods.find(name);
+            if constexpr (stats_enabled) {
+                _record_stat(StatKind::method_lookup, name);
+                if (overloads != nullptr && m_funcs.find(name) == nullptr) {
+                    _record_stat(StatKind::base_class_hit, name);
+                }
+            }
+            return overloads;
+        }
 
-    ReflectionBase& get_reflection(std::type_index index);
+        template <typename KeyType>
+        [[nodiscard]] const OverloadList* _find_functions(const KeyType& name) const {
+            _record_stat(StatKind::method_lookup, name);
+            return m_funcs.find(name);
+        }
 
-    using NameTypeInfo = std::pair<std::string, std::type_index>;
+        template <typename MemberType>
+        static FieldHandle<MemberType> _field_handle(const Member* member) {
+            if (member != nullptr) {
+                if (member->type_info != typeid(remove_const_t<MemberType>)) {
+                    return {};
+                }
+                if (member->is_const && !std::is_const_v<MemberType>) {
+                    return {};
+                }
+                return FieldHandle<MemberType>(member->offset, member->table_index, member->dirty_offset);
+            }
+            return {};
+        }
 
-    using NameTypeInfoList = std::vector<NameTypeInfo>;
-    using NameTypeInfoMap = std::unordered_map<std::string, NameTypeInfo>;
+        static uint16_t _signature_hash(const TypeIndexSpan signature) noexcept {
+            // the addresses of the names are hashed instead of the names, a mismatch only costs a cache miss.
+            uint64_t hash = 0xcbf29ce484222325ull ^ signature.size();
+            for (const auto& type: signature) {
+                hash = (hash ^ reinterpret_cast<uintptr_t>(type.name())) * 0x100000001b3ull;
+            }
+            return static_cast<uint16_t>(hash ^ hash >> 16 ^ hash >> 32 ^ hash >> 48);
+        }
 
-    // Return type, class type, argument types.
-    using MethodInfo = std::tuple<std::type_index, std::type_index, std::vector<std::type_index>>;
-    // Return type, argument types.
-    using FunctionInfo = std::tuple<std::type_index, std::vector<std::type_index>>;
+        void _record_inherited_overload(const Symbol name, const OverloadRef& overload) const {
+            if constexpr (stats_enabled) {
+                const auto own = m_funcs.find(name);
+                if (own == nullptr || std::none_of(own->begin(), own->end(), [&](const CallableWrapper& fn) {
+                    return &fn == overload.wrapper;
+                })) {
+                    _record_stat(StatKind::base_class_hit, name);
+                }
+            }
+        }
 
-    using CallableInfo = std::variant<MethodInfo, FunctionInfo>;
-    using OverloadedCallableInfo = std::vector<CallableInfo>;
+        /**
+         * Find the overload of a method that matches the signature, remembering the choice.
+         * @note A cached choice is verified with is_parameter_match, so hash collisions only cost a scan.
+         */
+        OverloadRef _resolve_overload(const Symbol name, const TypeIndexSpan signature) const {
+            if (!name) {
+                return {};
+            }
+            const auto& tables = _flat_tables();
+            const auto overloads = tables.methods.find(name);
+            _record_stat(StatKind::method_lookup, name);
+            if (overloads == nullptr) {
+                return {};
+            }
 
-    using NameCallableInfo = std::pair<std::string, OverloadedCallableInfo>;
+            const uint16_t hash = _signature_hash(signature);
+            const uint64_t tag = (static_cast<uint64_t>(name.id()) + 1) << 32 | static_cast<uint64_t>(hash) << 16;
+            auto& slot = tables.overload_cache[(name.id() * 0x9e3779b1u ^ hash) % FlatTables::overload_cache_size];
+            if (const uint64_t cached = slot.load(std::memory_order_relaxed); (cached & ~0xffffull) == tag) {
+                const size_t index = cached & 0xffff;
+                if (index < overloads->size() && is_parameter_match((*overloads)[index]->arg_types, signature)) {
+                    _record_inherited_overload(name, (*overloads)[index]);
+                    return (*overloads)[index];
+                }
+            }
 
-    using NameCallableInfoList = std::vector<NameCallableInfo>;
-    using NameCallableInfoMap = std::unordered_map<std::string, NameCallableInfo>;
+            _record_stat(StatKind::overload_miss, name);
+            for (size_t i = 0; i < overloads->size(); ++i) {
+                if (is_parameter_match((*overloads)[i]->arg_types, signature)) {
+                    if (i < 0xffff) {
+                        slot.store(tag | i, std::memory_order_relaxed);
+                    }
+                    _record_inherited_overload(name, (*overloads)[i]);
+                    return (*overloads)[i];
+                }
+            }
+            return {};
+        }
+
+        OverloadList& _overloads(const std::string_view name) {
+            const Symbol symbol(name);
+            const auto [overloads, inserted] = m_funcs.try_emplace(symbol, registry_memory_resource());
+            if (inserted) {
+                m_func_order.push_back(symbol);
+            }
+            return *overloads;
+        }
+
+        static ReturnValueProxy _invoke_in_arena(const CallableWrapper& fn, void* object, const ArgList& args,
+                                                 ReflectionArena& arena) {
+            if (!fn.into || fn.return_layout.size == 0) {
+                return fn.callable(object, args.get(), args.rvalue_flags());
+            }
+            const auto storage = arena.allocate(fn.return_layout.size, fn.return_layout.align);
+            fn.into(object, args.get(), storage, args.rvalue_flags());
+            arena.adopt(storage, fn.return_layout.destroy);
+            return ReturnValueProxy::borrowed(storage, fn.return_layout.size, fn.return_type);
+        }
+
+    public:
+        ReflectionBase() = delete;
+
+        ReflectionBase(const ReflectionBase&) = delete;
+
+        ReflectionBase& operator=(const ReflectionBase&) = delete;
 
-    /**
-     * A class for reflection.
-     */
-    class ReflectionBase {
-        std::unordered_map<std::string, Member> m_offsets = {};
-        std::unordered_map<std::string, std::pmr::vector<CallableWrapper>> m_funcs = {};
-        std::unordered_map<std::string, Metadata> m_metadata = {};
+        ReflectionBase(ReflectionBase&&) noexcept = default;
 
-        std::pmr::vector<std::type_index> m_derived_from;
+        ReflectionBase& operator=(ReflectionBase&&) noexcept = default;
 
-        std::type_index m_base_type_index = typeid(void);
-        std::string m_base_type_name;
-        ParsedTypeString m_type_parsed;
-
-        template <typename ClassType, typename ReturnType, typename... ArgTypes>
-        std::any _parse_method(ReturnType (ClassType::*Method)(ArgTypes...)) {
-            std::function<ReturnType(void*, remove_cvref_t<ArgTypes>&&...)> fn =
-                    [Method](void* object, remove_cvref_t<ArgTypes>&&... args) {
-                return (static_cast<ClassType *>(object)->*Method)(std::forward<remove_cvref_t<ArgTypes>>(args)...);
-            };
-            return std::any(std::move(fn));
+        explicit ReflectionBase(std::type_index base_type_index, const std::string_view base_type_name,
+                                const ValueLayout layout = {})
+            : m_base_type_index(base_type_index),
+              m_base_type_name(TypeNameInterner::instance().intern(base_type_name)),
+              m_layout(layout) {
         }
 
-        template <typename ClassType, typename ReturnType, typename... ArgTypes>
-        std::any _parse_method_const(ReturnType (ClassType::*Method)(ArgTypes...) const) {
-            std::function<ReturnType(void*, remove_cvref_t<ArgTypes>&&...)> fn =
-                    [Method](void* object, remove_cvref_t<ArgTypes>&&... args) {
-                return (static_cast<ClassType *>(object)->*Method)(std::forward<remove_cvref_t<ArgTypes>>(args)...);
-            };
-            return std::any(std::move(fn));
+        /**
+         * Get the size, the alignment, the destructor and the copyability of the reflected type.
+         * @note Only known for reflections created by make_reflection<ClassType>(), the size is 0 otherwise.
+         */
+        [[nodiscard]] const ValueLayout& get_layout() const noexcept {
+            return m_layout;
         }
 
-        static CallableInfo _parse_callable(const CallableWrapper& func) {
-            if (std::holds_alternative<std::monostate>(func.parent_type)) {
-                FunctionInfo fn_info = std::make_tuple(
-                    func.return_type, std::vector<std::type_index>{
-                        func.arg_types.begin(),
-                        func.arg_types.end()
-                    });
-                return {fn_info};
-            }
-            MethodInfo fn_info = std::make_tuple(
-                func.return_type, std::get<std::type_index>(func.parent_type),
-                std::vector<std::type_index>{func.arg_types.begin(), func.arg_types.end()});
-            return {fn_info};
+        /**
+         * Get the counters of the pool the values of the reflected type returned by value are allocated from.
+         * @note All zero for reflections not created by make_reflection<ClassType>(), see ObjectPool.
+         */
+        [[nodiscard]] PoolStats pool_stats() const {
+            return m_layout.pool_stats != nullptr ? m_layout.pool_stats() : PoolStats{};
         }
 
-        template <typename ReturnType, typename... ArgTypes>
-        ReturnType _propagate(ReflectionBase& base,
-                              ReturnType (ReflectionBase::*method)(ArgTypes...),
-                              ArgTypes&&... args) {
-            return (base.*method)(std::forward<ArgTypes>(args)...);
+        std::type_index get_type() const {
+            return m_base_type_index;
         }
 
-        static std::optional<std::type_index> _search_method_in_base_classes(
-            ReflectionBase& current, const std::string& name) {
-            for (auto& base: current.m_derived_from) {
-                auto reflection = get_reflection(base);
-                if (!reflection.has_method(name)) {
-                    return _search_method_in_base_classes(reflection, name);
+        /**
+         * Copy the registered members, including the inherited ones, of source into target.
+         * @note Runs of adjacent trivially copyable members are copied with a single memcpy,
+         * @note the other members are copy assigned, so nested objects and containers are copied deeply.
+         * @note Const members are skipped, since they can't be assigned.
+         * @param source The pointer to the object to copy from.
+         * @param target The pointer to the object to copy into, of the same type.
+         */
+        void clone_into(const void* source, void* target) const {
+            const auto from = static_cast<const char *>(source);
+            const auto to = static_cast<char *>(target);
+            for (const auto& step: _flat_tables().copy_steps) {
+                if (step.setter == nullptr) {
+                    std::memcpy(to + step.offset, from + step.offset, step.size);
+                } else {
+                    step.setter(to + step.offset, const_cast<char *>(from) + step.offset);
                 }
-                return {base};
             }
-            return std::nullopt;
         }
 
-    public:
-        ReflectionBase() = delete;
+        /**
+         * Copy construct a new object of the reflected type from source.
+         * @note Unlike clone_into, this copies the unregistered members as well.
+         * @exception std::runtime_error If the reflected type is not known to be copy constructible.
+         */
+        [[nodiscard]] ReturnValueProxy clone(const void* source) const {
+            const auto layout = m_layout;
+            if (layout.copy_construct == nullptr) {
+                throw std::runtime_error("type " + get_type_string() + " can't be copy constructed");
+            }
+            record_stat(StatKind::allocation, m_base_type_name);
+            const auto storage = ::operator new(layout.size, std::align_val_t(layout.align));
+            try {
+                layout.copy_construct(storage, source);
+            } catch (...) {
+                ::operator delete(storage, std::align_val_t(layout.align));
+                throw;
+            }
+            std::shared_ptr<void> ptr(storage, [layout](void* object) {
+                if (layout.destroy != nullptr) {
+                    layout.destroy(object);
+                }
+                ::operator delete(object, std::align_val_t(layout.align));
+            });
+            return {std::move(ptr), layout.size, m_base_type_index};
+        }
 
-        explicit ReflectionBase(std::type_index base_type_index, std::string&& base_type_name)
-            : m_base_type_index(base_type_index) {
-            m_base_type_name = std::move(base_type_name);
-            m_type_parsed = parse_type_string(m_base_type_name);
+        /**
+         * Compare the registered members, including the inherited ones, of two objects of the reflected type.
+         * @note Runs of adjacent members whose bytes define their value, e.g. integers, are compared with memcmp.
+         * @note The other members are compared with value_equals,
+         * @note which recurses into containers and registered nested types.
+         */
+        [[nodiscard]] bool equals(const void* lhs, const void* rhs) const {
+            if (lhs == rhs) {
+                return true;
+            }
+            const auto left = static_cast<const char *>(lhs);
+            const auto right = static_cast<const char *>(rhs);
+            for (const auto& step: _flat_tables().compare_steps) {
+                if (step.equals == nullptr) {
+                    if (std::memcmp(left + step.offset, right + step.offset, step.size) != 0) {
+                        return false;
+                    }
+                } else if (!step.equals(left + step.offset, right + step.offset)) {
+                    return false;
+                }
+            }
+            return true;
         }
 
-        std::type_index get_type() const {
-            return m_base_type_index;
+        /**
+         * Hash the registered members, including the inherited ones, of an object of the reflected type.
+         * @note Objects which are equal by equals have the same hash.
+         */
+        [[nodiscard]] size_t hash(const void* object) const {
+            const auto bytes = static_cast<const char *>(object);
+            size_t hash = 0;
+            for (const auto& step: _flat_tables().compare_steps) {
+                hash = hash_combine(hash, step.hash == nullptr
+                                              ? hash_bytes(bytes + step.offset, step.size)
+                                              : step.hash(bytes + step.offset));
+            }
+            return hash;
         }
 
         std::string get_type_string() const {
+            return std::string(m_base_type_name);
+        }
+
+        /**
+         * Get the interned type name.
+         * @note Reflections of the same type name share the same data pointer.
+         */
+        [[nodiscard]] std::string_view get_type_name() const noexcept {
             return m_base_type_name;
         }
 
+        /**
+         * Get the parsed type name.
+         * @note The name is parsed on the first call, rather than on registration.
+         */
         ParsedTypeString get_type_parsed() const {
-            return m_type_parsed;
+            std::lock_guard lock(m_flat_cache->mutex);
+            if (m_flat_cache->type_parsed == nullptr) {
+                m_flat_cache->type_parsed = std::make_unique<const ParsedTypeString>(
+                    parse_type_string(std::string(m_base_type_name)));
+            }
+            return *m_flat_cache->type_parsed;
         }
 
         /**
@@ -1218,7 +4986,8 @@ namespace simple_reflection {
          * @param name The name of the member.
          */
         template <auto MemberPtr>
-        ReflectionBase& register_member(std::string&& name) {
+        ReflectionBase& register_member(const std::string_view name) {
+            _check_unpublished();
             using ClassType = extract_member_parent_t<decltype(MemberPtr)>;
             using MemberType = extract_member_type_t<decltype(MemberPtr)>;
             const auto offset = reinterpret_cast<size_t>(
@@ -1228,21 +4997,142 @@ namespace simple_reflection {
                 )
             );
             constexpr bool is_const = std::is_const_v<extract_member_type_t<decltype(MemberPtr)>>;
-            m_offsets.emplace(std::move(name),
-                              Member(offset, sizeof(MemberType), is_const, typeid(MemberType))
-                              .init_setter<MemberType>());
+            const Symbol symbol(name);
+            if (m_offsets.try_emplace(symbol, Member(offset, sizeof(MemberType), is_const, typeid(MemberType))
+                                              .init_setter<MemberType>()).second) {
+                m_member_order.push_back(symbol);
+            }
+            _bump_version();
+
+            return *this;
+        }
+
+        /**
+         * Register the members and methods listed in the compile-time description of a class.
+         * @note This keeps the runtime reflection in sync with describe<ClassType>.
+         * @tparam ClassType The described class.
+         */
+        template <typename ClassType>
+        ReflectionBase& register_descriptor() {
+            static_assert(is_described_v<ClassType>, "describe<ClassType> is not specialized");
+            for_each_field<ClassType>([this](const auto& field) {
+                register_member<remove_cvref_t<decltype(field)>::pointer>(std::string(field.name));
+            });
+            for_each_method<ClassType>([this](const auto& method) {
+                register_method<remove_cvref_t<decltype(method)>::pointer>(std::string(method.name));
+            });
+            return *this;
+        }
 
+        /**
+         * Opt in to change tracking, recording the members written through this reflection in a DirtySet member.
+         * @note Writes through set_member, move_member, Member::assign and FieldHandle::set are recorded,
+         * @note writes through raw pointers (get_member_ref, FieldHandle::get) are not, see mark_changed.
+         * @note Derived classes inherit the tracking, but their writes have to go through their own reflection,
+         * @note since the bits are positions in the member table of the reflection written through.
+         * @param offset The offset of the DirtySet in the class.
+         */
+        ReflectionBase& track_changes(const size_t offset) {
+            _check_unpublished();
+            m_dirty_offset = offset;
+            _bump_version();
             return *this;
         }
 
-        ReflectionBase& derives_from(std::type_index parent) {
+        template <auto DirtySetPtr>
+        ReflectionBase& track_changes() {
+            using ClassType = extract_member_parent_t<decltype(DirtySetPtr)>;
+            static_assert(std::is_same_v<extract_member_type_t<decltype(DirtySetPtr)>, DirtySet>,
+                          "the change tracking member must be a DirtySet");
+            return track_changes(reinterpret_cast<size_t>(&(static_cast<ClassType *>(nullptr)->*DirtySetPtr)));
+        }
+
+        [[nodiscard]] bool tracks_changes() const {
+            return _flat_tables().dirty_offset != no_dirty_set;
+        }
+
+        /**
+         * Get the DirtySet of an object, or nullptr if the type doesn't track its changes.
+         */
+        [[nodiscard]] DirtySet* get_dirty_set(void* object) const {
+            const auto offset = _flat_tables().dirty_offset;
+            return offset == no_dirty_set ? nullptr : reinterpret_cast<DirtySet *>(static_cast<char *>(object) + offset);
+        }
+
+        [[nodiscard]] const DirtySet* get_dirty_set(const void* object) const {
+            return get_dirty_set(const_cast<void *>(object));
+        }
+
+        /**
+         * Record a write made through a raw pointer to a member.
+         * @return False if the member is not found.
+         */
+        bool mark_changed(void* object, const std::string_view name) const {
+            if (const auto member = _find_member(name)) {
+                mark_dirty(object, member->dirty_offset, member->table_index);
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * Forget the recorded writes of an object, e.g. once its changes are sent.
+         */
+        void clear_changes(void* object) const {
+            if (const auto dirty = get_dirty_set(object)) {
+                dirty->clear();
+            }
+        }
+
+        /**
+         * Declare a base class.
+         * @note The members and methods of the base class become accessible through this reflection.
+         * @param parent The type of the base class.
+         * @param offset The offset of the base subobject, 0 for the first (or only) non-virtual base.
+         */
+        ReflectionBase& derives_from(std::type_index parent, const size_t offset = 0) {
+            _check_unpublished();
             m_derived_from.emplace_back(parent);
+            m_base_offsets.push_back({parent, offset});
+            _bump_version();
             return *this;
         }
 
+        /**
+         * Declare a base class, which is assumed to be at offset 0.
+         * @note Use derives_from<Parent, Derived>() for multiple inheritance.
+         */
         template <typename Parent>
         ReflectionBase& derives_from() {
-            m_derived_from.emplace_back(typeid(Parent));
+            return derives_from(typeid(Parent));
+        }
+
+        /**
+         * Declare a base class, with the offset of its subobject computed from the derived type.
+         */
+        template <typename Parent, typename Derived>
+        ReflectionBase& derives_from() {
+            return derives_from(typeid(Parent), base_offset_of<Parent, Derived>());
+        }
+
+        /**
+         * Mark the reflection as published to lock-free readers, see ReflectionRegistryBase::publish.
+         * @note Registering on it afterwards throws std::logic_error, since the readers don't lock.
+         */
+        void mark_published() noexcept {
+            m_flat_cache->published.store(true, std::memory_order_release);
+        }
+
+        [[nodiscard]] bool is_published() const noexcept {
+            return m_flat_cache->published.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Build the flattened member and method tables now, instead of on the first lookup.
+         * @note The registry does this for every type when it is frozen.
+         */
+        const ReflectionBase& flatten() const {
+            static_cast<void>(_flat_tables());
             return *this;
         }
 
@@ -1250,60 +5140,176 @@ namespace simple_reflection {
             return m_derived_from;
         }
 
-        NameTypeInfoList get_member_list() {
-            NameTypeInfoList list;
-            for (const auto& [name, member]: m_offsets) {
-                list.emplace_back(name, member.type_info);
+        /**
+         * Visit every member, including those inherited from the base classes, without building a list.
+         * @param visitor Called with the name and the Member of each member, in the order of declaration,
+         * the members of the bases first.
+         */
+        template <typename Visitor>
+        void for_each_member(Visitor&& visitor) const {
+            for (const auto& [name, member]: _flat_tables().declared_members) {
+                visitor(name.str(), *member);
             }
-            return list;
         }
 
-        NameTypeInfoMap get_member_map() {
-            NameTypeInfoMap map;
-            for (const auto& [name, member]: m_offsets) {
-                map.emplace(name, NameTypeInfo(name, member.type_info));
+        /**
+         * Visit every method overload, including those inherited from the base classes.
+         * @param visitor Called with the name and the CallableWrapper of each overload, in no particular order.
+         */
+        template <typename Visitor>
+        void for_each_overload(Visitor&& visitor) const {
+            for (const auto& [name, refs]: _flat_tables().methods) {
+                for (const auto& ref: refs) {
+                    visitor(name.str(), *ref.wrapper);
+                }
             }
-            return map;
         }
 
-        NameCallableInfoList get_callable_list() {
-            NameCallableInfoList list;
-            for (const auto& [name, callable]: m_funcs) {
-                OverloadedCallableInfo info;
-                for (const auto& func: callable) {
-                    info.emplace_back(_parse_callable(func));
-                }
-                list.emplace_back(name, std::move(info));
+        /**
+         * The number of plan types which can be cached per reflection, see cached_plan.
+         */
+        static constexpr size_t plan_slot_count = 8;
+
+        /**
+         * Get the plan of this reflection, e.g. the codec of a serializer, building it on first use.
+         * @note The plan is built by calling build(*this), and only rebuilt once this class or one of its bases
+         * @note registered something, or one of the reflections looked up by the build did, or one of the types
+         * @note it looked up but didn't find got registered. Lookups by type name are not tracked.
+         * @note Concurrent first calls may build the plan more than once, but all of them get the same one.
+         * @note The plan lives as long as the returned pointer is held, even if it got rebuilt meanwhile.
+         * @note A plan must not point into the plans of other reflections, which are rebuilt independently:
+         * @note keep the other ReflectionBase, and ask it for its plan when needed.
+         * @tparam Plan The type of the plan, each of which takes a slot, up to plan_slot_count.
+         */
+        template <typename Plan, typename Builder>
+        std::shared_ptr<const Plan> cached_plan(Builder&& build) const {
+            static_assert(std::tuple_size_v<decltype(FlatCache::plans)> == plan_slot_count);
+            const size_t slot = _plan_slot<Plan>();
+            if (slot >= plan_slot_count) {
+                throw std::logic_error("too many plan types cached on reflections");
             }
-            return list;
+            const auto& tables = _flat_tables();
+            auto& cache = *m_flat_cache;
+            std::shared_ptr<const PlanEntry> entry;
+            {
+                std::shared_lock lock(cache.plans_mutex);
+                entry = cache.plans[slot];
+            }
+            if (entry != nullptr && _plan_valid(*entry, tables)) {
+                return {entry, static_cast<const Plan*>(entry->plan.get())};
+            }
+
+            auto built = std::make_shared<PlanEntry>();
+            built->tables = &tables;
+            built->type_epoch.store(type_registration_epoch().load(std::memory_order_acquire),
+                                    std::memory_order_relaxed);
+            PlanRecorder recorder;
+            {
+                const auto outer = std::exchange(_plan_recorder(), &recorder);
+                struct Restore {
+                    PlanRecorder* outer;
+
+                    ~Restore() {
+                        _plan_recorder() = outer;
+                    }
+                } restore{outer};
+                built->plan = std::make_shared<const Plan>(build(*this));
+            }
+            built->found = std::move(recorder.found);
+            built->missing = std::move(recorder.missing);
+
+            std::unique_lock lock(cache.plans_mutex);
+            if (const auto& cached = cache.plans[slot];
+                cached != nullptr && cached->tables == built->tables && cached->found == built->found
+                && cached->type_epoch.load(std::memory_order_acquire)
+                   == built->type_epoch.load(std::memory_order_relaxed)) {
+                return {cached, static_cast<const Plan*>(cached->plan.get())};
+            }
+            cache.plans[slot] = built;
+            return {built, static_cast<const Plan*>(built->plan.get())};
         }
 
-        NameCallableInfoMap get_callable_map() {
-            NameCallableInfoMap map;
-            for (const auto& [name, callable]: m_funcs) {
-                OverloadedCallableInfo info;
-                for (const auto& func: callable) {
-                    info.emplace_back(_parse_callable(func));
+        /**
+         * Note a lookup of a reflection, which the plan being built on this thread depends on, see cached_plan.
+         * @note Called by the registry, it does nothing outside of a build.
+         */
+        static void note_plan_lookup(const std::type_index type_index, const ReflectionBase* reflection) {
+            if (const auto recorder = _plan_recorder()) {
+                if (reflection == nullptr) {
+                    recorder->missing.push_back(type_index);
+                } else {
+                    recorder->found.push_back({reflection, reflection->_version()});
                 }
-                map.emplace(name, NameCallableInfo(name, std::move(info)));
             }
-            return map;
+        }
+
+        /**
+         * Get the descriptor of the members and callables registered on this class, not including the inherited ones.
+         * @note It is built once after the registrations and shared by all the callers, see ReflectionDescriptor.
+         * @note The reference stays valid as long as the reflection, since the replaced tables are kept,
+         * @note but later registrations on this class are only seen by calling it again.
+         */
+        [[nodiscard]] const ReflectionDescriptor& get_descriptor() const {
+            const auto& tables = _flat_tables();
+            if (const auto descriptor = tables.descriptor.load(std::memory_order_acquire)) {
+                return *descriptor;
+            }
+            return *_build_shared_descriptor(tables);
+        }
+
+        /**
+         * Get the descriptor of the members and callables registered on this class, see get_descriptor.
+         * @note The descriptor stays valid as long as the pointer is kept, whatever gets registered since.
+         */
+        [[nodiscard]] std::shared_ptr<const ReflectionDescriptor> get_shared_descriptor() const {
+            const auto& tables = _flat_tables();
+            if (tables.descriptor.load(std::memory_order_acquire) != nullptr) {
+                return tables.owned_descriptor;
+            }
+            return _build_shared_descriptor(tables);
+        }
+
+        /**
+         * Get the members registered on this class, in the order of their registration.
+         * @note The list is owned by the reflection and never freed before it, like the maps and lists below,
+         * @note but a registration on this class or its bases is only seen by calling it again, see get_descriptor.
+         */
+        [[nodiscard]] const NameTypeInfoList& get_member_list() const {
+            return get_descriptor().members;
+        }
+
+        [[nodiscard]] const NameTypeInfoMap& get_member_map() const {
+            return get_descriptor().member_map;
+        }
+
+        [[nodiscard]] const NameCallableInfoList& get_callable_list() const {
+            return get_descriptor().callables;
+        }
+
+        [[nodiscard]] const NameCallableInfoMap& get_callable_map() const {
+            return get_descriptor().callable_map;
         }
 
         template <
             typename ReturnType, typename... ArgTypes, typename CallableType,
             std::enable_if_t<std::is_convertible_v<CallableType, std::function<ReturnType(ArgTypes...)>>, bool>  = false
         >
-        ReflectionBase& register_function(std::string&& name, CallableType callable) {
-            auto fn = static_cast<std::function<ReturnType(remove_cvref_t<ArgTypes>&&...)>>(std::move(callable));
-            auto wrapped_fn = wrap_function(fn);
-            m_funcs[name].emplace_back(
-                std::move(fn),
-                wrapped_fn,
+        ReflectionBase& register_function(const std::string_view name, CallableType callable) {
+            _check_unpublished();
+            using FunctionType = std::function<ReturnType(remove_cvref_t<ArgTypes>&&...)>;
+            using Thunk = FunctionThunk<FunctionType, ReturnType, ArgTypes...>;
+            auto fn = std::make_shared<const FunctionType>(std::move(callable));
+            _overloads(name).emplace_back(
+                function_signature_id<ReturnType, ArgTypes...>(),
+                CommonCallable{&Thunk::call, fn.get()},
                 typeid(ReturnType),
                 std::pmr::vector<std::type_index>{typeid(ArgTypes)...},
                 std::monostate(),
-                false);
+                false,
+                IntoCallable{&Thunk::into, fn.get()},
+                ValueLayout::of<ReturnType>(),
+                fn);
+            _bump_version();
             return *this;
         }
 
@@ -1319,15 +5325,7 @@ namespace simple_reflection {
             typename MemberType, typename ClassType,
             std::enable_if_t<!std::is_pointer_v<ClassType>, bool>  = false
         >
-        MemberType* get_member_ref(ClassType& object, std::string&& name) noexcept {
-            return get_member_ref<MemberType, ClassType>(&object, std::move(name));
-        }
-
-        template <
-            typename MemberType, typename ClassType,
-            std::enable_if_t<!std::is_pointer_v<ClassType>, bool>  = false
-        >
-        MemberType* get_member_ref(ClassType& object, std::string& name) noexcept {
+        MemberType* get_member_ref(ClassType& object, const std::string_view name) noexcept {
             return get_member_ref<MemberType, ClassType>(&object, name);
         }
 
@@ -1341,12 +5339,7 @@ namespace simple_reflection {
          * @return The pointer to the member.
          */
         template <typename MemberType, typename ClassType>
-        const MemberType* get_const_member_ref(ClassType& object, std::string&& name) noexcept {
-            return get_const_member_ref<MemberType, ClassType>(&object, name);
-        }
-
-        template <typename MemberType, typename ClassType>
-        const MemberType* get_const_member_ref(ClassType& object, std::string& name) noexcept {
+        const MemberType* get_const_member_ref(ClassType& object, const std::string_view name) noexcept {
             return get_const_member_ref<MemberType, ClassType>(&object, name);
         }
 
@@ -1357,21 +5350,19 @@ namespace simple_reflection {
          * @return True if the member is const, false otherwise.
          */
         template <typename MemberType>
-        bool is_member_const(std::string&& name) noexcept {
-            if (const auto find = m_offsets.find(name); find != m_offsets.end()) {
-                const Member& member = find->second;
-                if (member.type_info != typeid(MemberType)) {
+        bool is_member_const(const std::string_view name) noexcept {
+            if (const auto member = _find_member(name)) {
+                if (member->type_info != typeid(MemberType)) {
                     return false;
                 }
-                return member.is_const;
+                return member->is_const;
             }
             return false;
         }
 
-        bool is_member_const(std::string&& name) noexcept {
-            if (const auto find = m_offsets.find(name); find != m_offsets.end()) {
-                const Member& member = find->second;
-                return member.is_const;
+        bool is_member_const(const std::string_view name) noexcept {
+            if (const auto member = _find_member(name)) {
+                return member->is_const;
             }
             return false;
         }
@@ -1386,30 +5377,101 @@ namespace simple_reflection {
          * @return The pointer to the member.
          */
         template <typename MemberType, typename ClassType>
-        MemberType* get_member_ref(ClassType* object, std::string&& name) noexcept {
-            if (const auto find = m_offsets.find(name); find != m_offsets.end()) {
-                const auto& member = find->second;
-                if (member.type_info != typeid(MemberType)) {
+        MemberType* get_member_ref(ClassType* object, const std::string_view name) noexcept {
+            if (const auto member = _find_member(name)) {
+                if (member->type_info != typeid(MemberType)) {
                     return nullptr;
                 }
-                return static_cast<MemberType *>(reinterpret_cast<void *>(object) + member.offset);
+                return static_cast<MemberType *>(reinterpret_cast<void *>(object) + member->offset);
             }
+            return nullptr;
+        }
 
-            for (auto base: m_derived_from) {
-                auto reflection = get_reflection(base);
-                if (auto propagated = _propagate<MemberType *, ClassType *, std::string&&>(
-                        reflection,
-                        get_member_ref<MemberType, ClassType>, std::move(object), std::move(std::string(name)));
-                    propagated != nullptr) {
-                    return propagated;
-                }
+        /**
+         * Find the description of a member without throwing.
+         * @note Base classes are searched if the member is not found in this class.
+         * @param name The name of the member.
+         * @return The pointer to the member, or nullptr if the member is not found.
+         */
+        [[nodiscard]] const Member* find_member(const std::string_view name) const {
+            return _find_member(name);
+        }
+
+        [[nodiscard]] const Member* find_member(const Symbol name) const {
+            return _find_member(name);
+        }
+
+        /**
+         * Resolve a member into a FieldHandle, which caches the offset and the type check.
+         * @note Base classes are searched if the member is not found in this class.
+         * @note Returns an invalid handle if the member is not found, there's a type mismatch,
+         * @note or a non-const handle is requested for a const member.
+         * @tparam MemberType The type of the member.
+         * @param name The name of the member.
+         * @return The handle.
+         */
+        template <typename MemberType>
+        FieldHandle<MemberType> resolve_member(const std::string_view name) {
+            return _field_handle<MemberType>(_find_member(name));
+        }
+
+        template <typename MemberType>
+        FieldHandle<MemberType> resolve_member(const Symbol name) {
+            return _field_handle<MemberType>(_find_member(name));
+        }
+
+        /**
+         * Copy a member out of each object in an array, resolving the member only once.
+         * @see FieldHandle::gather
+         * @tparam MemberType The type of the member.
+         * @param name The name of the member.
+         * @param objects The pointer to the first object.
+         * @param count The number of objects.
+         * @param stride The distance between two adjacent objects, in bytes.
+         * @param out The array of at least `count` elements to receive the values.
+         * @return False if the member is not found or the type mismatched, in which case nothing is copied.
+         */
+        template <typename MemberType>
+        bool gather(const std::string_view name, const void* objects, const size_t count, const size_t stride,
+                    MemberType* out) {
+            const auto handle = resolve_member<const MemberType>(name);
+            if (!handle) {
+                return false;
             }
-            return nullptr;
+            handle.gather(objects, count, stride, out);
+            return true;
+        }
+
+        template <typename MemberType, typename ClassType>
+        bool gather(const std::string_view name, const ClassType* objects, const size_t count, MemberType* out) {
+            return gather(name, static_cast<const void *>(objects), count, sizeof(ClassType), out);
+        }
+
+        /**
+         * Assign the values of an array to a member of each object in an array, resolving the member only once.
+         * @see FieldHandle::scatter
+         * @tparam MemberType The type of the member.
+         * @param name The name of the member.
+         * @param objects The pointer to the first object.
+         * @param count The number of objects.
+         * @param stride The distance between two adjacent objects, in bytes.
+         * @param in The array of at least `count` values.
+         * @return False if the member is not found, is const, or the type mismatched.
+         */
+        template <typename MemberType>
+        bool scatter(const std::string_view name, void* objects, const size_t count, const size_t stride,
+                     const MemberType* in) {
+            const auto handle = resolve_member<MemberType>(name);
+            if (!handle) {
+                return false;
+            }
+            handle.scatter(objects, count, stride, in);
+            return true;
         }
 
         template <typename MemberType, typename ClassType>
-        MemberType* get_member_ref(ClassType* object, std::string& name) noexcept {
-            return get_member_ref<MemberType, ClassType>(object, std::move(name));
+        bool scatter(const std::string_view name, ClassType* objects, const size_t count, const MemberType* in) {
+            return scatter(name, static_cast<void *>(objects), count, sizeof(ClassType), in);
         }
 
         /**
@@ -1418,21 +5480,10 @@ namespace simple_reflection {
          * @param name The name of the member.
          * @return The pointer to the member.
          */
-        void* get_member_ref(void* object, std::string&& name) {
-            if (const auto find = m_offsets.find(name); find != m_offsets.end()) {
-                const auto& member = find->second;
-                return object + member.offset;
-            }
-
-            for (auto base: m_derived_from) {
-                auto reflection = get_reflection(base);
-                if (auto propagated = _propagate<void *, void *, std::string&&>(reflection,
-                        get_member_ref, std::move(object), std::move(std::string(name)));
-                    propagated != nullptr) {
-                    return propagated;
-                }
+        void* get_member_ref(void* object, const std::string_view name) {
+            if (const auto member = _find_member(name)) {
+                return object + member->offset;
             }
-
             return nullptr;
         }
 
@@ -1446,25 +5497,14 @@ namespace simple_reflection {
          * @return The pointer to the member.
          */
         template <typename MemberType, typename ClassType>
-        const MemberType* get_const_member_ref(ClassType* object, std::string& name) noexcept {
+        const MemberType* get_const_member_ref(ClassType* object, const std::string_view name) noexcept {
             using type = typename remove_const<MemberType>::type;
-            if (const auto find = m_offsets.find(name); find != m_offsets.end()) {
-                const auto& member = find->second;
-                if (member.type_info != typeid(type)) {
+            if (const auto member = _find_member(name)) {
+                if (member->type_info != typeid(type)) {
                     return nullptr;
                 }
-                return static_cast<const type *>(reinterpret_cast<void *>(object) + member.offset);
-            }
-
-            for (auto base: m_derived_from) {
-                auto reflection = get_reflection(base);
-                if (auto propagated = _propagate<const MemberType *, ClassType *, std::string&>(
-                    reflection,
-                    get_const_member_ref<MemberType, ClassType>, std::move(object), name); propagated != nullptr) {
-                    return propagated;
-                }
+                return static_cast<const type *>(reinterpret_cast<const void *>(object) + member->offset);
             }
-
             return nullptr;
         }
 
@@ -1474,38 +5514,17 @@ namespace simple_reflection {
          * @param name The name of the member.
          * @return The pointer to the member.
          */
-        const void* get_const_member_ref(const void* object, const std::string& name) {
-            if (const auto find = m_offsets.find(name); find != m_offsets.end()) {
-                const auto& member = find->second;
-                return object + member.offset;
-            }
-
-            for (auto base: m_derived_from) {
-                auto reflection = get_reflection(base);
-                if (auto propagated = _propagate<const void *, const void *, const std::string&>(reflection,
-                    get_const_member_ref, std::move(object), name); propagated != nullptr) {
-                    return propagated;
-                }
+        const void* get_const_member_ref(const void* object, const std::string_view name) {
+            if (const auto member = _find_member(name)) {
+                return object + member->offset;
             }
-
             return nullptr;
         }
 
-        RawObjectWrapper get_member_wrapped(void* object, const std::string& name) {
-            if (const auto find = m_offsets.find(name); find != m_offsets.end()) {
-                const auto& member = find->second;
-                return RawObjectWrapper(object + member.offset, member.type_info);
-            }
-
-            for (auto base: m_derived_from) {
-                auto reflection = get_reflection(base);
-                if (auto propagated =
-                        _propagate<RawObjectWrapper, void *, const std::string&>(reflection,
-                            get_member_wrapped, std::move(object), name); !propagated.is_none_type()) {
-                    return propagated;
-                }
+        RawObjectWrapper get_member_wrapped(void* object, const std::string_view name) {
+            if (const auto member = _find_member(name)) {
+                return RawObjectWrapper(object + member->offset, member->type_info);
             }
-
             return RawObjectWrapper::none();
         }
 
@@ -1522,23 +5541,11 @@ namespace simple_reflection {
             typename ValueType,
             std::enable_if_t<std::is_same_v<ValueType, void *>, bool>  = false
         >
-        bool set_member(void* object, const std::string& name, ValueType value) {
-            if (const auto find = m_offsets.find(name); find != m_offsets.end()) {
-                const auto& member = find->second;
-                member.setter(object, value);
+        bool set_member(void* object, const std::string_view name, ValueType value) {
+            if (const auto member = _find_member(name)) {
+                member->assign(object, value);
                 return true;
             }
-
-            for (auto base: m_derived_from) {
-                auto reflection = get_reflection(base);
-                if (auto propagated =
-                        _propagate<bool, void *, const std::string&, void *>(
-                            reflection,
-                            set_member<ValueType>, std::move(object), name,
-                            std::move(value)); propagated) {
-                    return true;
-                }
-            }
             return false;
         }
 
@@ -1546,55 +5553,33 @@ namespace simple_reflection {
             typename WrapperType,
             std::enable_if_t<std::is_same_v<remove_cvref_t<WrapperType>, RawObjectWrapper>, bool>  = false
         >
-        bool set_member(void* object, std::string&& name, WrapperType value) {
-            if (const auto find = m_offsets.find(name); find != m_offsets.end()) {
-                const auto& member = find->second;
-                if (value.type_index != member.type_info) {
+        bool set_member(void* object, const std::string_view name, WrapperType value) {
+            if (const auto member = _find_member(name)) {
+                if (value.type_index != member->type_info) {
                     return false;
                 }
-                member.setter(object, value.object);
-                return true;
-            }
-
-            for (auto base: m_derived_from) {
-                auto reflection = get_reflection(base);
-                if (auto propagated =
-                        _propagate<bool, void *, std::string&&, RawObjectWrapper>(
-                            reflection,
-                            set_member<WrapperType>, std::move(object), std::move(std::string(name)),
-                            std::move(value)); propagated) {
-                    return true;
+                if (value.is_rvalue) {
+                    member->move_assign(object, value.object);
+                } else {
+                    member->assign(object, value.object);
                 }
+                return true;
             }
-
             return false;
         }
 
-        template <
-            typename WrapperType,
-            std::enable_if_t<std::is_same_v<remove_cvref_t<WrapperType>, RawObjectWrapper>, bool>  = false
-        >
-        bool set_member(void* object, std::string& name, WrapperType value) {
-            if (const auto find = m_offsets.find(name); find != m_offsets.end()) {
-                const auto& member = find->second;
-                if (value.type_index != member.type_info) {
-                    return false;
-                }
-                member.setter(object, value.object);
+        /**
+         * Move a value into a member, leaving the value moved-from.
+         * @note Like set_member with a void pointer, the type is @b NOT checked.
+         * @param object The pointer to the object.
+         * @param name The name of the member.
+         * @param value The pointer to the value.
+         */
+        bool move_member(void* object, const std::string_view name, void* value) {
+            if (const auto member = _find_member(name)) {
+                member->move_assign(object, value);
                 return true;
             }
-
-            for (auto base: m_derived_from) {
-                auto reflection = get_reflection(base);
-                if (auto propagated =
-                        _propagate<bool, void *, std::string&, WrapperType>(
-                            reflection,
-                            set_member<WrapperType>, std::move(object), name,
-                            std::move(value)); propagated) {
-                    return true;
-                }
-            }
-
             return false;
         }
 
@@ -1605,7 +5590,8 @@ namespace simple_reflection {
          * @param name The name of the method.
          */
         template <auto Method>
-        ReflectionBase& register_method(std::string&& name) {
+        ReflectionBase& register_method(const std::string_view name) {
+            _check_unpublished();
             constexpr bool is_const = method_has_const_suffix<decltype(Method)>::value;
             using ReturnType = typename extract_method_types<decltype(Method)>::return_type;
             using ArgTypes = typename extract_method_types<decltype(Method)>::arg_types;
@@ -1615,29 +5601,17 @@ namespace simple_reflection {
             ArgTypes arg_types_tuple;
             extract_type_indices(arg_types_tuple, arg_types);
 
-            if (m_funcs.find(name) == m_funcs.end()) {
-                m_funcs[name] = std::pmr::vector<CallableWrapper>();
-            }
-
-            CommonCallable parsed;
-            std::any old_parsed;
-
-            if constexpr (is_const) {
-                parsed = wrap_method_const(Method);
-                old_parsed = _parse_method_const(Method);
-            } else {
-                parsed = wrap_method(Method);
-                old_parsed = _parse_method(Method);
-            }
-
-            m_funcs[name].emplace_back(
-                old_parsed,
-                parsed,
+            _overloads(name).emplace_back(
+                _method_signature_id<ReturnType>(arg_types_tuple),
+                MethodThunk<Method>::callable(),
                 std::type_index(typeid(ReturnType)),
                 std::move(arg_types),
                 std::type_index(typeid(ClassType)),
-                is_const
+                is_const,
+                MethodThunk<Method>::into_callable(),
+                ValueLayout::of<ReturnType>()
             );
+            _bump_version();
 
             return *this;
         }
@@ -1659,38 +5633,119 @@ namespace simple_reflection {
             typename... ArgTypes,
             std::enable_if_t<!std::is_void_v<ClassType>, bool>  = false
         >
-        ReflectionBase& register_method(std::string&& name, ReturnType (ClassType::*Method)(ArgTypes...)) {
-            constexpr bool is_const = method_has_const_suffix<decltype(Method)>::value;
-            if (m_funcs.find(name) == m_funcs.end()) {
-                m_funcs[name] = std::pmr::vector<CallableWrapper>();
-            }
-
-            CommonCallable parsed;
-            std::any old_parsed;
-
-            if constexpr (is_const) {
-                parsed = wrap_method_const(Method);
-                old_parsed = _parse_method_const(Method);
-            } else {
-                parsed = wrap_method(Method);
-                old_parsed = _parse_method(Method);
-            }
+        ReflectionBase& register_method(const std::string_view name, ReturnType (ClassType::*Method)(ArgTypes...)) {
+            _check_unpublished();
+            using MethodType = decltype(Method);
+            using Thunk = MemberPointerThunk<MethodType>;
+            constexpr bool is_const = method_has_const_suffix<MethodType>::value;
+            const auto method = std::make_shared<const MethodType>(Method);
 
             std::pmr::vector<std::type_index> arg_types;
             std::tuple<remove_cvref_t<ArgTypes>...> arg_types_tuple;
             extract_type_indices(arg_types_tuple, arg_types);
 
-            m_funcs[name].emplace_back(
-                old_parsed,
-                parsed,
+            _overloads(name).emplace_back(
+                method_signature_id<ReturnType, ArgTypes...>(),
+                CommonCallable{&Thunk::call, method.get()},
                 std::type_index(typeid(ReturnType)),
                 std::move(arg_types),
                 std::type_index(typeid(ClassType)),
-                is_const
+                is_const,
+                IntoCallable{&Thunk::into, method.get()},
+                ValueLayout::of<ReturnType>(),
+                method
             );
+            _bump_version();
             return *this;
         }
 
+        /**
+         * Invoke a method (or a function), constructing the return value in caller-provided storage.
+         * @exception method_not_found_exception If no overload matches the arguments and the return type.
+         * @note The storage must be uninitialized, and suitable in size and alignment for ReturnType.
+         * @note The caller owns the constructed object, and is responsible for destroying it.
+         * @tparam ReturnType The return type of the method.
+         * @param object The pointer to the object, or nullptr for functions.
+         * @param name The name of the method.
+         * @param storage The uninitialized storage.
+         * @param args The arguments of the method.
+         * @return The pointer to the constructed value.
+         */
+        template <typename ReturnType, typename ClassType>
+        ReturnType* invoke_emplace(ClassType* object, const std::string_view name, void* storage,
+                                   const ArgList& args = empty_arg_list()) {
+            if (const auto result = try_invoke_emplace<ReturnType>(object, name, storage, args)) {
+                return result;
+            }
+            _throw_not_found<method_not_found_exception>(name);
+        }
+
+        /**
+         * The non-throwing counterpart of invoke_emplace.
+         * @return The pointer to the constructed value, or nullptr if no overload matches,
+         * @note in which case the storage is left untouched.
+         */
+        template <typename ReturnType, typename ClassType>
+        ReturnType* try_invoke_emplace(ClassType* object, const std::string_view name, void* storage,
+                                       const ArgList& args = empty_arg_list()) {
+            const auto overload = find_overload(name, args.type_indices());
+            if (!overload || !overload->into || overload->return_type != typeid(ReturnType)) {
+                return nullptr;
+            }
+            overload->into(overload.adjust(const_cast<remove_cvref_t<ClassType> *>(object)), args.get(), storage,
+                           args.rvalue_flags());
+            return std::launder(static_cast<ReturnType *>(storage));
+        }
+
+        /**
+         * Invoke a method (or a function), and assign the return value to the given object.
+         * @exception method_not_found_exception If no overload matches the arguments and the return type.
+         * @note Unlike invoke_method, no ReturnValueProxy, and thus no heap allocation, is involved.
+         * @code
+         * size_t size;
+         * reflection.invoke_into(&vec, "size", size);
+         * @endcode
+         * @tparam ReturnType The return type of the method.
+         * @param object The pointer to the object, or nullptr for functions.
+         * @param name The name of the method.
+         * @param out The object to receive the return value.
+         * @param args The arguments of the method.
+         * @return The reference to the output object.
+         */
+        template <typename ReturnType, typename ClassType>
+        ReturnType& invoke_into(ClassType* object, const std::string_view name, ReturnType& out,
+                                const ArgList& args = empty_arg_list()) {
+            if (!try_invoke_into(object, name, out, args)) {
+                _throw_not_found<method_not_found_exception>(name);
+            }
+            return out;
+        }
+
+        /**
+         * The non-throwing counterpart of invoke_into.
+         * @code
+         * size_t size;
+         * if (reflection.try_invoke_into(&vec, "size", size)) { ... }
+         * @endcode
+         * @return True if the method was invoked, false if no overload matches, in which case `out` is untouched.
+         */
+        template <typename ReturnType, typename ClassType>
+        bool try_invoke_into(ClassType* object, const std::string_view name, ReturnType& out,
+                             const ArgList& args = empty_arg_list()) {
+            if constexpr (std::is_trivially_copyable_v<ReturnType>) {
+                return try_invoke_emplace<ReturnType>(object, name, std::addressof(out), args) != nullptr;
+            } else {
+                alignas(ReturnType) unsigned char storage[sizeof(ReturnType)];
+                const auto result = try_invoke_emplace<ReturnType>(object, name, storage, args);
+                if (result == nullptr) {
+                    return false;
+                }
+                out = std::move(*result);
+                result->~ReturnType();
+                return true;
+            }
+        }
+
         /**
          * Invoke a method of a class.
          * @exception method_not_found_exception If the method is not found.
@@ -1709,14 +5764,9 @@ namespace simple_reflection {
             std::enable_if_t<!std::is_void_v<ReturnType>, bool>  = false,
             std::enable_if_t<!std::is_pointer_v<ClassType>, bool>  = false
         >
-        ReturnType invoke_method(ClassType& object, std::string&& name, ArgTypes&&... args) {
-            try {
-                return invoke_method<ReturnType, remove_cvref_t<ArgTypes>...>(
-                    static_cast<void *>(&object), std::forward<std::string>(name),
-                    std::forward<remove_cvref_t<ArgTypes>>(args)...);
-            } catch (const method_not_found_exception&) {
-                throw method_not_found_exception(name);
-            }
+        ReturnType invoke_method(ClassType& object, const std::string_view name, ArgTypes&&... args) {
+            return invoke_method<ReturnType, ArgTypes...>(
+                static_cast<void *>(&object), name, std::forward<ArgTypes>(args)...);
         }
 
         /**
@@ -1729,12 +5779,8 @@ namespace simple_reflection {
          * @return The return value of the method.
          */
         template <typename ReturnType, typename ClassType, std::enable_if_t<!std::is_void_v<ReturnType>, bool>  = false>
-        ReturnType invoke_method(ClassType& object, std::string&& name) {
-            try {
-                return invoke_method<ReturnType>(static_cast<void *>(&object), std::forward<std::string>(name));
-            } catch (const method_not_found_exception&) {
-                throw method_not_found_exception(name);
-            }
+        ReturnType invoke_method(ClassType& object, const std::string_view name) {
+            return invoke_method<ReturnType>(static_cast<void *>(&object), name);
         }
 
         /**
@@ -1746,12 +5792,8 @@ namespace simple_reflection {
          * @return The return value of the method.
          */
         template <typename ClassType>
-        void invoke_method(ClassType& object, std::string&& name) {
-            try {
-                invoke_method(static_cast<void *>(&object), std::forward<std::string>(name));
-            } catch (const method_not_found_exception&) {
-                throw method_not_found_exception(name);
-            }
+        void invoke_method(ClassType& object, const std::string_view name) {
+            invoke_method(static_cast<void *>(&object), name);
         }
 
         /**
@@ -1770,17 +5812,75 @@ namespace simple_reflection {
             std::enable_if_t<!std::is_pointer_v<ClassType>, bool>  = false,
             std::enable_if_t<(sizeof ...(ArgTypes) > 0), bool>  = false
         >
-        void invoke_method(ClassType& object, std::string&& name, ArgTypes&&... args) {
-            try {
-                invoke_method<void, ArgTypes...>(static_cast<void *>(&object), std::forward<std::string>(name),
-                                                 std::forward<remove_cvref_t<ArgTypes>>(args)...);
-            } catch (const method_not_found_exception&) {
-                throw method_not_found_exception(name);
+        void invoke_method(ClassType& object, const std::string_view name, ArgTypes&&... args) {
+            invoke_method<void, ArgTypes...>(static_cast<void *>(&object), name,
+                                             std::forward<ArgTypes>(args)...);
+        }
+
+        bool has_method(const std::string_view name) const {
+            return m_funcs.contains(name);
+        }
+
+        /**
+         * Resolve one overload of a method (or a function) into a MethodHandle.
+         * @note Base classes are searched if the method is not found in this class.
+         * @note The handle stays valid as long as the ReflectionBase does.
+         * @param name The name of the method.
+         * @param signature The argument types of the desired overload, with cvref qualifiers removed.
+         * @return The handle, which is invalid if no overload matches.
+         */
+        MethodHandle resolve_method(const std::string_view name, const TypeIndexSpan signature) {
+            if (const auto overload = find_overload(name, signature)) {
+                return MethodHandle(overload);
             }
+            return {};
+        }
+
+        MethodHandle resolve_method(const Symbol name, const TypeIndexSpan signature) {
+            if (const auto overload = find_overload(name, signature)) {
+                return MethodHandle(overload);
+            }
+            return {};
+        }
+
+        /**
+         * Find the overload of a method (or a function) that matches the signature.
+         * @note The base classes are searched as well.
+         * @note The reference stays valid as long as the reflection owning the overload, which is a base class for
+         * @note inherited ones, since later registrations never move nor free the registered overloads.
+         * @note Overloads registered after the call are not taken into account, find the overload again to see them.
+         * @param name The name of the method.
+         * @param signature The argument types. The cvref qualifiers are ignored.
+         * @return The reference to the overload, which is empty if no overload matches.
+         */
+        OverloadRef find_overload(const std::string_view name, const TypeIndexSpan signature) const {
+            return _resolve_overload(Symbol::find(name), signature);
         }
 
-        bool has_method(const std::string& name) {
-            return m_funcs.find(name) != m_funcs.end();
+        OverloadRef find_overload(const Symbol name, const TypeIndexSpan signature) const {
+            return _resolve_overload(name, signature);
+        }
+
+        /**
+         * Resolve one overload of a method (or a function) into a MethodHandle,
+         * using the signature of the given arguments.
+         * @param name The name of the method.
+         * @param args The sample arguments.
+         * @return The handle, which is invalid if no overload matches.
+         */
+        MethodHandle resolve_method(const std::string_view name, const ArgList& args) {
+            return resolve_method(name, args.type_indices());
+        }
+
+        /**
+         * Resolve one overload of a method (or a function) into a MethodHandle.
+         * @tparam ArgTypes The argument types of the desired overload. The cvref qualifiers are ignored.
+         * @param name The name of the method.
+         * @return The handle, which is invalid if no overload matches.
+         */
+        template <typename... ArgTypes>
+        MethodHandle resolve_method(const std::string_view name) {
+            return resolve_method(name, StaticSignature<remove_cvref_t<ArgTypes>...>::span());
         }
 
         /**
@@ -1798,26 +5898,17 @@ namespace simple_reflection {
             typename... ArgTypes,
             std::enable_if_t<!std::is_void_v<ReturnType>, bool>  = false
         >
-        ReturnType invoke_method(void* object, std::string&& name, ArgTypes&&... args) {
-            if (const auto find = m_funcs.find(name); find != m_funcs.end()) {
-                auto fn_overloads = find->second;
-                for (auto& fn: fn_overloads) {
-                    if (can_cast_to<std::function<ReturnType(void*, remove_cvref_t<ArgTypes>&&...)>>(fn.method)) {
-                        const auto method = std::any_cast<std::function<ReturnType
-                            (void*, remove_cvref_t<ArgTypes>&&...)>>(fn.method);
-                        return method(object, std::forward<remove_cvref_t<ArgTypes>>(args)...);
+        ReturnType invoke_method(void* object, const std::string_view name, ArgTypes&&... args) {
+            constexpr auto signature = method_signature_id<ReturnType, ArgTypes...>();
+            if (const auto overloads = _find_methods(name)) {
+                for (const auto& overload: *overloads) {
+                    if (overload->signature_id == signature) {
+                        return invoke_typed<ReturnType>(overload->callable, overload->into, overload.adjust(object),
+                                                        std::forward<ArgTypes>(args)...);
                     }
                 }
             }
-
-            auto search = _search_method_in_base_classes(*this, name);
-            if (search.has_value()) {
-                auto reflection = get_reflection(search.value());
-                return reflection.invoke_method<ReturnType, ArgTypes...>(object, std::forward<std::string>(name),
-                                                                         std::forward<remove_cvref_t<ArgTypes>>(args)
-                                                                         ...);
-            }
-            throw method_not_found_exception(name);
+            _throw_not_found<method_not_found_exception>(name);
         }
 
         /**
@@ -1829,23 +5920,16 @@ namespace simple_reflection {
          * @return The return value of the method.
          */
         template <typename ReturnType, std::enable_if_t<!std::is_void_v<ReturnType>, bool>  = false>
-        ReturnType invoke_method(void* object, std::string&& name) {
-            if (auto find = m_funcs.find(name); find != m_funcs.end()) {
-                auto fn_overloads = find->second;
-                for (auto& fn: fn_overloads) {
-                    if (can_cast_to<std::function<ReturnType(void*)>>(fn.method)) {
-                        const auto method = std::any_cast<std::function<ReturnType(void*)>>(fn.method);
-                        return method(object);
+        ReturnType invoke_method(void* object, const std::string_view name) {
+            constexpr auto signature = method_signature_id<ReturnType>();
+            if (const auto overloads = _find_methods(name)) {
+                for (const auto& overload: *overloads) {
+                    if (overload->signature_id == signature) {
+                        return invoke_typed<ReturnType>(overload->callable, overload->into, overload.adjust(object));
                     }
                 }
             }
-
-            auto search = _search_method_in_base_classes(*this, name);
-            if (search.has_value()) {
-                auto reflection = get_reflection(search.value());
-                return reflection.invoke_method<ReturnType>(object, std::forward<std::string>(name));
-            }
-            throw method_not_found_exception(name);
+            _throw_not_found<method_not_found_exception>(name);
         }
 
         /**
@@ -1856,23 +5940,17 @@ namespace simple_reflection {
          * @return The return value of the method.
          */
         template <typename ReturnType, std::enable_if_t<std::is_void_v<ReturnType>, bool>  = false>
-        ReturnType invoke_method(void* object, std::string&& name) {
-            if (const auto find = m_funcs.find(name); find != m_funcs.end()) {
-                auto fn_overloads = find->second;
-                for (auto& fn: fn_overloads) {
-                    if (can_cast_to<std::function<void(void*)>>(fn.method)) {
-                        const auto method = std::any_cast<std::function<void(void*)>>(fn.method);
-                        method(object);
+        ReturnType invoke_method(void* object, const std::string_view name) {
+            constexpr auto signature = method_signature_id<void>();
+            if (const auto overloads = _find_methods(name)) {
+                for (const auto& overload: *overloads) {
+                    if (overload->signature_id == signature) {
+                        overload->callable(overload.adjust(object), nullptr);
+                        return;
                     }
                 }
             }
-
-            auto search = _search_method_in_base_classes(*this, name);
-            if (search.has_value()) {
-                auto reflection = get_reflection(search.value());
-                return reflection.invoke_method<ReturnType>(object, std::forward<std::string>(name));
-            }
-            throw method_not_found_exception(name);
+            _throw_not_found<method_not_found_exception>(name);
         }
 
         /**
@@ -1889,27 +5967,18 @@ namespace simple_reflection {
             std::enable_if_t<std::is_void_v<ReturnType>, bool>  = false,
             std::enable_if_t<std::is_same_v<ClassType, void *>, bool>  = false
         >
-        void invoke_method(ClassType object, std::string&& name, ArgTypes&&... args) {
-            if (const auto find = m_funcs.find(name); find != m_funcs.end()) {
-                auto fn_overloads = find->second;
-                for (auto& fn: fn_overloads) {
-                    if (can_cast_to<std::function<void(void*, remove_cvref_t<ArgTypes>&&...)>>(fn.method)) {
-                        const auto method = std::any_cast<std::function<void(void*, remove_cvref_t<ArgTypes>&&...)>>(
-                            fn.method);
-                        method(object, std::forward<remove_cvref_t<ArgTypes>>(args)...);
+        void invoke_method(ClassType object, const std::string_view name, ArgTypes&&... args) {
+            constexpr auto signature = method_signature_id<void, ArgTypes...>();
+            if (const auto overloads = _find_methods(name)) {
+                for (const auto& overload: *overloads) {
+                    if (overload->signature_id == signature) {
+                        invoke_typed<void>(overload->callable, overload->into, overload.adjust(object),
+                                           std::forward<ArgTypes>(args)...);
                         return;
                     }
                 }
             }
-
-            const auto search = _search_method_in_base_classes(*this, name);
-            if (search.has_value()) {
-                auto reflection = get_reflection(search.value());
-                reflection.invoke_method<ReturnType, ArgTypes...>(static_cast<void *>(object), std::move(name),
-                                                                  std::forward<remove_cvref_t<ArgTypes>>(args)...);
-                return;
-            }
-            throw method_not_found_exception(name);
+            _throw_not_found<method_not_found_exception>(name);
         }
 
         /**
@@ -1917,10 +5986,10 @@ namespace simple_reflection {
          * @param name The name of the method.
          * @return True if the method is const, false otherwise.
          */
-        bool is_method_const(std::string&& name) noexcept {
-            if (const auto find = m_funcs.find(name); find != m_funcs.end()) {
+        bool is_method_const(const std::string_view name) noexcept {
+            if (const auto find = _find_functions(name)) {
                 try {
-                    const auto overloads = find->second;
+                    const auto& overloads = *find;
                     for (auto& fn: overloads) {
                         if (fn.is_const) {
                             return true;
@@ -1951,37 +6020,30 @@ namespace simple_reflection {
             typename ReturnType, typename... ArgTypes,
             std::enable_if_t<!std::is_void_v<ReturnType>, bool>  = false
         >
-        ReturnType invoke_function(std::string&& name, ArgTypes... args) {
-            if (const auto find = m_funcs.find(name); find != m_funcs.end()) {
-                auto fn_overloads = find->second;
+        ReturnType invoke_function(const std::string_view name, ArgTypes... args) {
+            if (const auto find = _find_functions(name)) {
+                const auto& fn_overloads = *find;
+                constexpr auto signature = function_signature_id<ReturnType, ArgTypes...>();
                 for (auto& fn: fn_overloads) {
-                    if (can_cast_to<std::function<ReturnType(remove_cvref_t<ArgTypes>&&...)>>(fn.method)) {
-                        const auto function = std::any_cast<std::function<ReturnType(remove_cvref_t<ArgTypes>&&...)>>(
-                            fn.method);
-                        return function(std::forward<ArgTypes>(args)...);
+                    if (fn.signature_id == signature) {
+                        return invoke_typed<ReturnType>(fn.callable, fn.into, nullptr, args...);
                     }
                 }
             }
-            throw method_not_found_exception(name);
+            _throw_not_found<method_not_found_exception>(name);
         }
 
-        ReturnValueProxy invoke_function(std::string&& name, const ArgList& args) {
-            if (const auto find = m_funcs.find(name); find != m_funcs.end()) {
-                auto fn_overloads = find->second;
-                for (auto& fn: fn_overloads) {
-                    if (is_parameter_match(fn.arg_types, args.type_indices)) {
-                        // the nullptr here serves as a placeholder, since we don't need to pass the object to the function.
-                        ReturnValueProxy proxy = fn.callable(nullptr, args.get());
-                        return proxy;
-                    }
-                }
+        ReturnValueProxy invoke_function(const std::string_view name, const ArgList& args) {
+            if (const auto overload = find_overload(name, args.type_indices())) {
+                // the nullptr here serves as a placeholder, since we don't need to pass the object to the function.
+                return overload->callable(nullptr, args.get(), args.rvalue_flags());
             }
-            throw method_not_found_exception(name);
+            _throw_not_found<method_not_found_exception>(name);
         }
 
-        ReturnValueProxy invoke_function(std::string&& name) {
-            if (const auto find = m_funcs.find(name); find != m_funcs.end()) {
-                auto fn_overloads = find->second;
+        ReturnValueProxy invoke_function(const std::string_view name) {
+            if (const auto find = _find_functions(name)) {
+                const auto& fn_overloads = *find;
                 for (auto& fn: fn_overloads) {
                     if (fn.arg_types.empty()) {
                         ReturnValueProxy proxy = fn.callable(nullptr, nullptr);
@@ -1989,12 +6051,10 @@ namespace simple_reflection {
                     }
                 }
             }
-            throw method_not_found_exception(name);
+            _throw_not_found<method_not_found_exception>(name);
         }
 
-        static bool is_parameter_match(
-            const std::pmr::vector<std::type_index>& parameters,
-            const std::pmr::vector<std::type_index>& actual_args) {
+        static bool is_parameter_match(const TypeIndexSpan parameters, const TypeIndexSpan actual_args) {
             if (parameters.size() != actual_args.size()) {
                 return false;
             }
@@ -2008,101 +6068,224 @@ namespace simple_reflection {
         }
 
         template <typename ClassType, std::enable_if_t<!std::is_void_v<ClassType>, bool>  = false>
-        ReturnValueProxy invoke_method(ClassType& object, std::string&& name, const ArgList& args) {
-            try {
-                return invoke_method(&object, std::move(name), std::move(args));
-            } catch (const method_not_found_exception&) {
-                throw method_not_found_exception(name);
-            }
+        ReturnValueProxy invoke_method(ClassType& object, const std::string_view name, const ArgList& args) {
+            return invoke_method(&object, name, args);
         }
 
         template <typename ClassType, std::enable_if_t<!std::is_void_v<ClassType>, bool>  = false>
-        ReturnValueProxy invoke_method(ClassType* object, std::string&& name, const ArgList& args) {
-            try {
-                return invoke_method(static_cast<void *>(object), std::move(name), args);
-            } catch (const method_not_found_exception&) {
-                throw method_not_found_exception(name);
-            }
+        ReturnValueProxy invoke_method(ClassType* object, const std::string_view name, const ArgList& args) {
+            return invoke_method(static_cast<void *>(object), name, args);
         }
 
         template <typename ClassType, std::enable_if_t<std::is_void_v<ClassType>, bool>  = false>
-        ReturnValueProxy invoke_method(ClassType* object, std::string&& name, const ArgList& args) {
-            if (const auto find = m_funcs.find(name); find != m_funcs.end()) {
-                auto fn_overloads = find->second;
-                for (auto& fn: fn_overloads) {
-                    const std::pmr::vector<std::type_index>& arg_types = args.type_indices;
-                    if (is_parameter_match(fn.arg_types, arg_types)) {
-                        ReturnValueProxy proxy = fn.callable(object, args.get());
-                        return proxy;
-                    }
-                }
+        ReturnValueProxy invoke_method(ClassType* object, const std::string_view name, const ArgList& args) {
+            if (const auto overload = find_overload(name, args.type_indices())) {
+                return overload->callable(overload.adjust(object), args.get(), args.rvalue_flags());
             }
+            return ReturnValueProxy::none();
+        }
 
-            auto search = _search_method_in_base_classes(*this, name);
-            if (search.has_value()) {
-                auto reflection = get_reflection(search.value());
-                return reflection.invoke_method<ClassType>(object, std::move(name), args);
+        template <typename ClassType>
+        ReturnValueProxy invoke_method(ClassType* object, const std::string_view name) {
+            if (const auto overloads = _find_methods(name); overloads != nullptr && !overloads->empty()) {
+                const auto& overload = overloads->front();
+                return overload->callable(overload.adjust(const_cast<remove_cvref_t<ClassType> *>(object)), nullptr);
             }
+            _throw_not_found<method_not_found_exception>(name);
+        }
 
-            return ReturnValueProxy::none();
+        /**
+         * Invoke a method of a class on a pool, without waiting for it.
+         * @note The overload is resolved by the caller, from the types of the arguments,
+         * @note which are then copied (or moved) into the task, so they may go out of scope right away.
+         * @note The object must outlive the call, and must not be used by other threads until it finished.
+         * @exception method_not_found_exception If no overload matches the arguments.
+         * @param pool The pool to run the method on.
+         * @param object The pointer to the object, or nullptr for functions.
+         * @param name The name of the method.
+         * @param args The arguments of the method.
+         * @return The future of the return value.
+         */
+        template <typename ClassType, typename... ArgTypes>
+        InvocationFuture invoke_async(ThreadPool& pool, ClassType* object, const std::string_view name,
+                                      ArgTypes&&... args) const {
+            const auto overload = find_overload(name, StaticSignature<remove_cvref_t<ArgTypes>...>::span());
+            if (!overload) {
+                _throw_not_found<method_not_found_exception>(name);
+            }
+            auto* raw = const_cast<void *>(static_cast<const void *>(object));
+            return InvocationFuture::submit(pool, [handle = MethodHandle(overload), raw,
+                                                   values = std::make_tuple(std::decay_t<ArgTypes>(
+                                                       std::forward<ArgTypes>(args))...)]() mutable {
+                return std::apply([&handle, raw](auto&... arguments) {
+                    return handle.invoke(raw, refl_args(std::move(arguments)...));
+                }, values);
+            });
         }
 
+        /**
+         * Invoke a method of a class on the shared pool, see ThreadPool::shared.
+         */
+        template <typename ClassType, typename... ArgTypes>
+        InvocationFuture invoke_async(ClassType* object, const std::string_view name, ArgTypes&&... args) const {
+            return invoke_async(ThreadPool::shared(), object, name, std::forward<ArgTypes>(args)...);
+        }
+
+        /**
+         * Invoke a function of a class on the shared pool, see invoke_async.
+         */
+        template <typename... ArgTypes>
+        InvocationFuture invoke_function_async(const std::string_view name, ArgTypes&&... args) const {
+            return invoke_async(ThreadPool::shared(), static_cast<void *>(nullptr), name,
+                                std::forward<ArgTypes>(args)...);
+        }
+
+        /**
+         * Invoke a method of a class, without throwing if the method is not found.
+         * @note Exceptions thrown by the method itself are still propagated.
+         * @param object The pointer to the object.
+         * @param name The name of the method.
+         * @param args The arguments of the method.
+         * @return The return value of the method, or std::nullopt if no overload matches the arguments.
+         */
         template <typename ClassType>
-        ReturnValueProxy invoke_method(ClassType* object, std::string&& name) {
-            if (const auto find = m_funcs.find(name); find != m_funcs.end()) {
-                auto fn_overloads = find->second;
-                for (auto& fn: fn_overloads) {
-                    ReturnValueProxy proxy = fn.callable(object, nullptr);
-                    return proxy;
-                }
+        std::optional<ReturnValueProxy> try_invoke_method(ClassType* object, const std::string_view name,
+                                                          const ArgList& args = empty_arg_list()) {
+            if (const auto overload = find_overload(name, args.type_indices())) {
+                return overload->callable(overload.adjust(const_cast<remove_cvref_t<ClassType> *>(object)), args.get(),
+                                          args.rvalue_flags());
             }
+            return std::nullopt;
+        }
+
+        /**
+         * Invoke a function, without throwing if the function is not found.
+         * @note Exceptions thrown by the function itself are still propagated.
+         * @param name The name of the function.
+         * @param args The arguments of the function.
+         * @return The return value of the function, or std::nullopt if no overload matches the arguments.
+         */
+        std::optional<ReturnValueProxy> try_invoke_function(const std::string_view name,
+                                                            const ArgList& args = empty_arg_list()) {
+            return try_invoke_method(static_cast<void *>(nullptr), name, args);
+        }
+
+        /**
+         * Invoke a function, constructing the return value in the given arena.
+         * @exception method_not_found_exception If the function is not found, or the function signature mismatched.
+         * @note The returned proxy does not own the value, which lives until the arena is released.
+         * @param name The name of the function.
+         * @param args The arguments of the function.
+         * @param arena The arena for the return value.
+         * @return The return value of the function.
+         */
+        ReturnValueProxy invoke_function(const std::string_view name, const ArgList& args, ReflectionArena& arena) {
+            const auto overload = find_overload(name, args.type_indices());
+            if (!overload) {
+                _throw_not_found<method_not_found_exception>(name);
+            }
+            return _invoke_in_arena(*overload.wrapper, nullptr, args, arena);
+        }
+
+        ReturnValueProxy invoke_function(const std::string_view name, ReflectionArena& arena) {
+            return invoke_function(name, empty_arg_list(), arena);
+        }
 
-            auto search = _search_method_in_base_classes(*this, name);
-            if (search.has_value()) {
-                auto reflection = get_reflection(search.value());
-                ReturnValueProxy proxy = reflection.invoke_method(object, std::move(name));
-                return proxy;
+        /**
+         * Invoke a method of a class, constructing the return value in the given arena.
+         * @exception method_not_found_exception If no overload matches the arguments.
+         * @note The returned proxy does not own the value, which lives until the arena is released.
+         * @param object The pointer to the object.
+         * @param name The name of the method.
+         * @param args The arguments of the method.
+         * @param arena The arena for the return value.
+         * @return The return value of the method.
+         */
+        template <typename ClassType>
+        ReturnValueProxy invoke_method(ClassType* object, const std::string_view name, const ArgList& args,
+                                       ReflectionArena& arena) {
+            const auto overload = find_overload(name, args.type_indices());
+            if (!overload) {
+                _throw_not_found<method_not_found_exception>(name);
             }
+            return _invoke_in_arena(*overload.wrapper, overload.adjust(const_cast<remove_cvref_t<ClassType> *>(object)),
+                                    args, arena);
+        }
 
-            throw method_not_found_exception(name);
+        template <typename ClassType>
+        ReturnValueProxy invoke_method(ClassType* object, const std::string_view name, ReflectionArena& arena) {
+            return invoke_method(object, name, empty_arg_list(), arena);
         }
 
-        ReflectionBase& attach_metadata(std::string name, Metadata metadata) {
-            m_metadata.emplace(std::move(name), std::move(metadata));
+        /**
+         * Attach metadata to the class, e.g. how a serializer encodes it.
+         * @note Like a registration, it bumps the version, since the plans built from the class may read it.
+         */
+        ReflectionBase& attach_metadata(const std::string_view name, Metadata metadata) {
+            _check_unpublished();
+            m_metadata.try_emplace(Symbol(name), std::move(metadata));
+            _bump_version();
             return *this;
         }
 
         template <typename MetadataType>
-        ReflectionBase& attach_metadata(std::string name, MetadataType metadata) {
+        ReflectionBase& attach_metadata(const std::string_view name, MetadataType metadata) {
+            _check_unpublished();
             if constexpr (std::is_convertible_v<MetadataType, std::string>) {
-                m_metadata.emplace(std::move(name), make_metadata(std::move(std::string(metadata))));
-                return *this;
+                m_metadata.try_emplace(Symbol(name), make_metadata(std::move(std::string(metadata))));
+            } else {
+                m_metadata.try_emplace(Symbol(name), make_metadata(std::move(metadata)));
             }
-            m_metadata.emplace(std::move(name), make_metadata(std::move(metadata)));
+            _bump_version();
             return *this;
         }
 
-        Metadata get_metadata(const std::string& name) {
-            if (const auto find = m_metadata.find(name); find != m_metadata.end()) {
-                return find->second;
+        Metadata get_metadata(const std::string_view name) {
+            if (const auto find = m_metadata.find(name)) {
+                return *find;
             }
-            throw metadata_not_found_exception(name);
+            _throw_not_found<metadata_not_found_exception>(name);
         }
 
         template <typename MetadataType>
-        MetadataType get_metadata_as(const std::string& name) {
-            if (const auto find = m_metadata.find(name); find != m_metadata.end()) {
-                if (find->second.type_index != typeid(MetadataType)) {
+        MetadataType get_metadata_as(const std::string_view name) {
+            if (const auto find = m_metadata.find(name)) {
+                if (find->type_index != typeid(MetadataType)) {
                     throw std::runtime_error("Type mismatch");
                 }
-                std::any any = find->second.data;
+                std::any any = find->data;
                 return std::any_cast<MetadataType>(any);
             }
-            throw metadata_not_found_exception(name);
+            _throw_not_found<metadata_not_found_exception>(name);
         }
 
-        bool has_metadata(const std::string& name) {
-            return m_metadata.find(name) != m_metadata.end();
+        /**
+         * Find a metadata without throwing.
+         * @return The pointer to the metadata, or nullptr if it is not attached.
+         */
+        [[nodiscard]] const Metadata* find_metadata(const std::string_view name) const {
+            return m_metadata.find(name);
+        }
+
+        [[nodiscard]] const Metadata* find_metadata(const Symbol name) const {
+            return m_metadata.find(name);
+        }
+
+        /**
+         * The non-throwing counterpart of get_metadata_as.
+         * @return The pointer to the metadata value, or nullptr if it is not attached or the type mismatched.
+         */
+        template <typename MetadataType>
+        [[nodiscard]] const MetadataType* try_get_metadata_as(const std::string_view name) const {
+            if (const auto metadata = find_metadata(name); metadata != nullptr &&
+                                                           metadata->type_index == typeid(MetadataType)) {
+                return std::any_cast<MetadataType>(&metadata->data);
+            }
+            return nullptr;
+        }
+
+        bool has_metadata(const std::string_view name) const {
+            return m_metadata.contains(name);
         }
 
         template <typename ClassType, std::enable_if_t<std::is_default_constructible_v<ClassType>, bool>  = false>
@@ -2118,18 +6301,152 @@ namespace simple_reflection {
 
     class reflection_registry_not_found_exception : public std::runtime_error {
     public:
-        [[nodiscard]] const char* what() const noexcept override {
-            return "ReflectionRegistryBase not found.";
-        }
-
         explicit reflection_registry_not_found_exception(const std::string& what) : std::runtime_error(what) {
-            std::cerr << what << std::endl;
         }
     };
 
+    /**
+     * The registry of all the reflections.
+     * @note Registration is expected to happen during startup (e.g. from static initializers),
+     * @note after which the registry can be frozen: lookups then go to an immutable sorted snapshot,
+     * @note which any number of threads can read lock-free.
+     * @note Types registered after the freeze are invisible to lookups until publish() is called,
+     * @note which copies the snapshot, adds the new types and swaps it in atomically (copy-on-write).
+     * @note Retired snapshots are kept until the registry is destroyed, so readers never see a dangling one.
+     * @code
+     * // in main, after all the static registrations:
+     * ReflectionRegistryBase::instance().freeze();
+     * // later, on a worker thread, without locking:
+     * auto& reflection = get_reflection(typeid(MyType));
+     * @endcode
+     */
     class ReflectionRegistryBase {
-        std::pmr::unordered_map<std::type_index, ReflectionBase> m_reflections;
-        std::unordered_map<std::string, std::type_index> m_type_index_map = {};
+        struct TypeEntry {
+            size_t hash;
+            std::type_index type_index;
+            ReflectionBase* reflection;
+        };
+
+        // keyed by the data pointer of the interned name.
+        struct NameEntry {
+            const char* name;
+            ReflectionBase* reflection;
+        };
+
+        /**
+         * An immutable, sorted index of the registered reflections.
+         */
+        struct Snapshot {
+            std::vector<TypeEntry> by_type;
+            std::vector<NameEntry> by_name;
+
+            [[nodiscard]] ReflectionBase* find(const std::type_index type_index) const noexcept {
+                const size_t hash = type_index.hash_code();
+                auto it = std::lower_bound(by_type.begin(), by_type.end(), hash,
+                                           [](const TypeEntry& entry, const size_t value) {
+                                               return entry.hash < value;
+                                           });
+                for (; it != by_type.end() && it->hash == hash; ++it) {
+                    if (it->type_index == type_index) {
+                        return it->reflection;
+                    }
+                }
+                return nullptr;
+            }
+
+            [[nodiscard]] ReflectionBase* find(const char* interned_name) const noexcept {
+                const auto it = std::lower_bound(by_name.begin(), by_name.end(), interned_name,
+                                                 [](const NameEntry& entry, const char* value) {
+                                                     return std::less<const char*>()(entry.name, value);
+                                                 });
+                if (it != by_name.end() && it->name == interned_name) {
+                    return it->reflection;
+                }
+                return nullptr;
+            }
+        };
+
+        // the nodes of the maps are never erased, so the pointers in the snapshots stay valid.
+        std::pmr::unordered_map<std::type_index, ReflectionBase> m_reflections{registry_memory_resource()};
+        std::unordered_map<const char*, std::type_index> m_type_index_map = {};
+
+        mutable std::shared_mutex m_mutex;
+        std::atomic<const Snapshot*> m_snapshot{nullptr};
+        std::vector<std::unique_ptr<Snapshot>> m_snapshots;
+
+
+        /**
+         * Build a snapshot of the current maps and publish it.
+         * @note The caller must hold the unique lock.
+         */
+        void _publish_locked() {
+            auto snapshot = std::make_unique<Snapshot>();
+            snapshot->by_type.reserve(m_reflections.size());
+            for (auto& [type_index, reflection]: m_reflections) {
+                reflection.mark_published();
+                snapshot->by_type.push_back({type_index.hash_code(), type_index, &reflection});
+            }
+            std::sort(snapshot->by_type.begin(), snapshot->by_type.end(),
+                      [](const TypeEntry& lhs, const TypeEntry& rhs) {
+                          return lhs.hash < rhs.hash;
+                      });
+
+            snapshot->by_name.reserve(m_type_index_map.size());
+            for (const auto& [name, type_index]: m_type_index_map) {
+                if (const auto find = m_reflections.find(type_index); find != m_reflections.end()) {
+                    snapshot->by_name.push_back({name, &find->second});
+                }
+            }
+            std::sort(snapshot->by_name.begin(), snapshot->by_name.end(),
+                      [](const NameEntry& lhs, const NameEntry& rhs) {
+                          return std::less<const char*>()(lhs.name, rhs.name);
+                      });
+
+            m_snapshot.store(snapshot.get(), std::memory_order_release);
+            m_snapshots.push_back(std::move(snapshot));
+        }
+
+        template <typename KeyType>
+        ReflectionBase* _find(const KeyType& key) const {
+            ReflectionBase* found;
+            if (const auto snapshot = m_snapshot.load(std::memory_order_acquire)) {
+                found = snapshot->find(key);
+            } else {
+                std::shared_lock lock(m_mutex);
+                found = _find_locked(key);
+            }
+            if constexpr (std::is_same_v<KeyType, std::type_index>) {
+                ReflectionBase::note_plan_lookup(key, found);
+            } else if (found != nullptr) {
+                ReflectionBase::note_plan_lookup(found->get_type(), found);
+            }
+            return found;
+        }
+
+        ReflectionBase* _find_locked(const std::type_index type_index) const {
+            if (const auto find = m_reflections.find(type_index); find != m_reflections.end()) {
+                return const_cast<ReflectionBase *>(&find->second);
+            }
+            return nullptr;
+        }
+
+        ReflectionBase* _find_locked(const char* interned_name) const {
+            if (const auto find = m_type_index_map.find(interned_name); find != m_type_index_map.end()) {
+                return _find_locked(find->second);
+            }
+            return nullptr;
+        }
+
+        /**
+         * Find a reflection by name, which only hashes the name once, in the interner.
+         */
+        ReflectionBase* _find_by_name(const std::string_view name) const {
+            const auto interned = TypeNameInterner::instance().find(name);
+            if (interned.data() == nullptr) {
+                return nullptr;
+            }
+            return _find(interned.data());
+        }
 
     public:
         ReflectionRegistryBase() = default;
@@ -2144,49 +6461,115 @@ namespace simple_reflection {
         }
 
         ReflectionBase& register_base(std::type_index type_index, ReflectionBase reflection) {
+            std::unique_lock lock(m_mutex);
             m_reflections.insert({type_index, std::move(reflection)});
+            bump_registration_epoch();
+            type_registration_epoch().fetch_add(1, std::memory_order_acq_rel);
             return m_reflections.at(type_index);
         }
 
         template <typename ClassType>
         ReflectionBase& register_base() {
-            m_type_index_map.emplace(extract_type_name<ClassType>(), typeid(ClassType));
-            return register_base(typeid(ClassType), ReflectionBase(typeid(ClassType),
-                                                                   extract_type_name<ClassType>()));
+            const auto layout = ValueLayout::of_class<ClassType>();
+            ObjectPool<ClassType>::enable();
+            std::unique_lock lock(m_mutex);
+            if (const auto find = m_reflections.find(typeid(ClassType)); find != m_reflections.end()) {
+                return find->second;
+            }
+
+#if SIMPLE_REFL_CONSTEXPR_TYPE_NAME
+            const auto type_name = TypeNameInterner::instance().intern_static(type_name_v<ClassType>);
+#else
+            const auto type_name = TypeNameInterner::instance().intern(extract_type_name<ClassType>());
+#endif
+            m_type_index_map.emplace(type_name.data(), typeid(ClassType));
+            const auto it = m_reflections.emplace(typeid(ClassType), ReflectionBase(typeid(ClassType), type_name, layout))
+                                         .first;
+            bump_registration_epoch();
+            type_registration_epoch().fetch_add(1, std::memory_order_acq_rel);
+            return it->second;
         }
 
-        ReflectionBase& get_reflection(const std::string& type_name) {
-            try {
-                return m_reflections.at(m_type_index_map.at(type_name));
-            } catch (const std::out_of_range&) {
-                std::stringstream ss;
-                ss << "ReflectionRegistryBase not found for type with name. " <<
-                        "Perhaps you forgot to register it, " <<
-                        "or you did not register it with the override which supports this function: " <<
-                        type_name;
-                throw reflection_registry_not_found_exception(ss.str());
+        /**
+         * Freeze the registry, after which lookups are lock-free.
+         * @note Call it once the startup registrations are done. Calling it again is the same as publish().
+         */
+        void freeze() {
+            publish();
+        }
+
+        /**
+         * Publish the types registered since the last publish to the lock-free readers.
+         * @note This also freezes the registry, if it's not frozen yet.
+         * @note The published types can't be registered on anymore, see ReflectionBase::mark_published.
+         */
+        void publish() {
+            const Snapshot* snapshot;
+            {
+                std::unique_lock lock(m_mutex);
+                _publish_locked();
+                snapshot = m_snapshot.load(std::memory_order_relaxed);
+            }
+            // build the flattened tables ahead of time, so that no reader has to.
+            for (const auto& entry: snapshot->by_type) {
+                entry.reflection->flatten();
+            }
+        }
+
+        /**
+         * Find a reflection, returning nullptr instead of throwing if the type is not registered.
+         * @note Before the registry is frozen, taking the lock may still throw std::system_error.
+         * @return The pointer to the reflection, or nullptr if the type is not registered.
+         */
+        ReflectionBase* try_get_reflection(const std::type_index type_index) {
+            return _find(type_index);
+        }
+
+        ReflectionBase* try_get_reflection(const std::string_view type_name) {
+            return _find_by_name(type_name);
+        }
+
+        template <typename ClassType>
+        ReflectionBase* try_get_reflection() {
+            return _find(std::type_index(typeid(ClassType)));
+        }
+
+        [[nodiscard]] bool is_frozen() const noexcept {
+            return m_snapshot.load(std::memory_order_acquire) != nullptr;
+        }
+
+        ReflectionBase& get_reflection(const std::string_view type_name) {
+            if (const auto reflection = _find_by_name(type_name)) {
+                return *reflection;
             }
+            std::stringstream ss;
+            ss << "ReflectionRegistryBase not found for type with name. " <<
+                    "Perhaps you forgot to register it, " <<
+                    "or you did not register it with the override which supports this function: " <<
+                    type_name;
+            record_stat(StatKind::exception);
+            throw reflection_registry_not_found_exception(ss.str());
         }
 
         template <typename ClassType>
         ReflectionBase& get_reflection() {
-            try {
-                return m_reflections.at(typeid(ClassType));
-            } catch (const std::out_of_range&) {
-                std::stringstream ss;
-                ss << "ReflectionRegistryBase not found for type with typeid: " << typeid(ClassType).name();
-                throw reflection_registry_not_found_exception(ss.str());
+            if (const auto reflection = _find(std::type_index(typeid(ClassType)))) {
+                return *reflection;
             }
+            std::stringstream ss;
+            ss << "ReflectionRegistryBase not found for type with typeid: " << typeid(ClassType).name();
+            record_stat(StatKind::exception);
+            throw reflection_registry_not_found_exception(ss.str());
         }
 
         ReflectionBase& get_reflection(const std::type_index type_index) {
-            try {
-                return m_reflections.at(type_index);
-            } catch (const std::out_of_range&) {
-                std::stringstream ss;
-                ss << "ReflectionRegistryBase not found for type with typeid: " << type_index.name();
-                throw reflection_registry_not_found_exception(ss.str());
+            if (const auto reflection = _find(type_index)) {
+                return *reflection;
             }
+            std::stringstream ss;
+            ss << "ReflectionRegistryBase not found for type with typeid: " << type_index.name();
+            record_stat(StatKind::exception);
+            throw reflection_registry_not_found_exception(ss.str());
         }
     };
 
@@ -2202,6 +6585,18 @@ namespace simple_reflection {
     inline ReflectionBase& get_reflection(std::type_index index) {
         return ReflectionRegistryBase::instance().get_reflection(index);
     }
+
+    inline ReflectionBase* try_get_reflection(std::type_index index) {
+        return ReflectionRegistryBase::instance().try_get_reflection(index);
+    }
+
+    inline bool reflected_equals(const ReflectionBase& reflection, const void* lhs, const void* rhs) {
+        return reflection.equals(lhs, rhs);
+    }
+
+    inline size_t reflected_hash(const ReflectionBase& reflection, const void* object) {
+        return reflection.hash(object);
+    }
 }
 
 #endif //SIMPLE_REFL_H
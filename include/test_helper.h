@@ -8,7 +8,10 @@
 #include <cassert>
 #include <chrono>
 
+// define TEST_HELPER_QUIET before including to silence dbg_print, e.g. in the benchmarks.
+#ifndef TEST_HELPER_QUIET
 #define DEBUG
+#endif
 
 namespace test_helper {
     class StopWatch {
@@ -44,7 +47,7 @@ namespace test_helper {
     }
 #else
     template <typename... Args>
-    void dbg_print(Args&&... args) {}
+    void dbg_print(Args&&...) {}
 #endif
 
 #define begin_test(test_name) \
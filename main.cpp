@@ -9,11 +9,16 @@
 #include "test/generic_tests.h"
 #include "test/function_tests.h"
 #include "test/derive_test.h"
+#include "test/handle_tests.h"
+#include "test/memory_tests.h"
+#include "test/registry_tests.h"
+#include "test/descriptor_tests.h"
 #endif
 
 #ifdef EXAMPLE
 #include "example/basic_usage.h"
 #include "example/json_parser.h"
+#include "example/binary_serializer.h"
 #endif
 
 int main() {
@@ -23,11 +28,23 @@ int main() {
     generic_tests::run_tests();
     function_tests::run_tests();
     derive_test::run_tests();
+    handle_tests::run_tests();
+    memory_tests::run_tests();
+    registry_tests::run_tests();
+    descriptor_tests::run_tests();
 #endif
 #ifdef EXAMPLE
     basic_usage::demonstrate();
     basic_usage::demonstrate_type_erasure();
     json_parser_test::test_parse_json();
+    json_parser_test::test_structural_scan();
+    json_parser_test::test_parse_batch();
+    json_parser_test::test_codec_plan();
+    json_parser_test::test_delta();
+    binary_serializer_test::test_binary_round_trip();
+    binary_serializer_test::test_binary_delta();
+    binary_serializer_test::test_binary_cycle();
+    binary_serializer_test::test_binary_bool();
 #endif
     return 0;
 }
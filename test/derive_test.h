@@ -6,6 +6,10 @@
 #define DERIVE_TEST_H
 
 #include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "simple_refl.h"
 #include "test_helper.h"
@@ -24,7 +28,7 @@ namespace derive_test {
         }
     };
 
-    static auto base_refl = simple_reflection::make_reflection<Base>()
+    static auto& base_refl = simple_reflection::make_reflection<Base>()
         .register_method<&Base::get_x>("get_x")
         .register_member<&Base::x>("x")
         .register_function<Base>("ctor", []() { return Base(); });
@@ -42,7 +46,7 @@ namespace derive_test {
         }
     };
 
-    static auto derived_refl = simple_reflection::make_reflection<Derived>()
+    static auto& derived_refl = simple_reflection::make_reflection<Derived>()
         .derives_from<Base>()
         .register_method<&Derived::get_y>("get_y")
         .register_member<&Derived::y>("y")
@@ -56,9 +60,241 @@ namespace derive_test {
             << derived_refl.invoke_method<int>(derived.get_raw(), "get_x") << std::endl;
     }
 
+    class Tagged {
+    public:
+        int tag = 7;
+
+        int get_tag() const {
+            return tag;
+        }
+    };
+
+    class Multi : public Derived, public Tagged {
+    public:
+        int z = 0;
+    };
+
+    static auto& tagged_refl = simple_reflection::make_reflection<Tagged>()
+        .register_member<&Tagged::tag>("tag")
+        .register_method<&Tagged::get_tag>("get_tag");
+
+    static auto& multi_refl = simple_reflection::make_reflection<Multi>()
+        .derives_from<Derived>()
+        .derives_from<Tagged, Multi>()
+        .register_member<&Multi::z>("z");
+
+    inline void flattened_lookup_test() {
+        Multi multi;
+        multi.x = 1;
+        multi.y = 2;
+        multi.z = 3;
+        // members from two levels up, and from a base which isn't at offset 0.
+        assert(multi_refl.get_member_ref<int>(&multi, "x") == &multi.x);
+        assert(multi_refl.get_member_ref<int>(&multi, "y") == &multi.y);
+        assert(multi_refl.get_member_ref<int>(&multi, "tag") == &multi.tag);
+        assert(multi_refl.resolve_member<int>("tag").get(&multi) == &multi.tag);
+
+        // methods are invoked on the right subobject.
+        assert(multi_refl.invoke_method<int>(static_cast<void *>(&multi), "get_x") == 1);
+        assert(multi_refl.invoke_method<int>(static_cast<void *>(&multi), "get_tag") == 7);
+        assert(multi_refl.invoke_method(&multi, "get_tag").get<int>() == 7);
+        assert(multi_refl.resolve_method("get_tag").call<int>(&multi) == 7);
+    }
+
+    inline void flattened_invalidation_test() {
+        Multi multi;
+        multi.tag = 9;
+        assert(multi_refl.get_member_ref<int>(&multi, "tag_alias") == nullptr);
+        // registering on a base invalidates the flattened tables of the derived types.
+        tagged_refl.register_member<&Tagged::tag>("tag_alias");
+        assert(multi_refl.get_member_ref<int>(&multi, "tag_alias") == &multi.tag);
+
+        // registering on an unrelated type keeps them.
+        const auto tag_member = multi_refl.find_member("tag_alias");
+        struct Unrelated {
+            int value = 0;
+        };
+        simple_reflection::make_reflection<Unrelated>().register_member<&Unrelated::value>("value");
+        assert(multi_refl.find_member("tag_alias") == tag_member);
+    }
+
+    // no operator== and no std::hash, so it's compared and hashed by its members.
+    struct Point {
+        int x = 0;
+        int y = 0;
+    };
+
+    static auto& point_refl = simple_reflection::make_reflection<Point>()
+        .register_member<&Point::x>("x")
+        .register_member<&Point::y>("y");
+
+    struct LatePoint {
+        int z = 0;
+    };
+
+    // the number of members of the types a shape refers to, as a plan which depends on other reflections.
+    struct ShapePlan {
+        size_t point_members = 0;
+        bool has_late_point = false;
+    };
+
+    inline ShapePlan build_shape_plan(const simple_reflection::ReflectionBase&) {
+        ShapePlan plan;
+        plan.point_members = simple_reflection::get_reflection(typeid(Point)).get_member_list().size();
+        plan.has_late_point = simple_reflection::try_get_reflection(typeid(LatePoint)) != nullptr;
+        return plan;
+    }
+
+    class Shape : public Base {
+    public:
+        std::string name;
+        double weight = 0;
+        Point origin;
+        std::vector<Point> points;
+        int unregistered = 0;
+    };
+
+    static auto& shape_refl = simple_reflection::make_reflection<Shape>()
+        .derives_from<Base>()
+        .register_member<&Shape::name>("name")
+        .register_member<&Shape::weight>("weight")
+        .register_member<&Shape::origin>("origin")
+        .register_member<&Shape::points>("points");
+
+    inline void cached_plan_test() {
+        const auto plan = shape_refl.cached_plan<ShapePlan>(&build_shape_plan);
+        assert(plan->point_members == 2 && !plan->has_late_point);
+        assert(shape_refl.cached_plan<ShapePlan>(&build_shape_plan) == plan);
+
+        // registering on a type the plan didn't look up keeps it.
+        struct Unrelated {
+            int value = 0;
+        };
+        simple_reflection::make_reflection<Unrelated>().register_member<&Unrelated::value>("value");
+        assert(shape_refl.cached_plan<ShapePlan>(&build_shape_plan) == plan);
+
+        // registering a type the plan didn't find builds it anew.
+        simple_reflection::make_reflection<LatePoint>();
+        const auto found = shape_refl.cached_plan<ShapePlan>(&build_shape_plan);
+        assert(found != plan && found->has_late_point);
+
+        // so does registering on a type it looked up, but the held plans stay valid.
+        point_refl.register_member<&Point::x>("x_alias");
+        const auto rebuilt = shape_refl.cached_plan<ShapePlan>(&build_shape_plan);
+        assert(rebuilt != found && rebuilt->point_members == 3);
+        assert(plan->point_members == 2 && found->point_members == 2);
+    }
+
+    inline void value_ops_test() {
+        Shape shape;
+        shape.x = 1;
+        shape.name = "triangle";
+        shape.weight = 2.5;
+        shape.origin = {3, 4};
+        shape.points = {{0, 0}, {1, 0}, {0, 1}};
+        shape.unregistered = 5;
+
+        Shape copy;
+        shape_refl.clone_into(&shape, &copy);
+        assert(copy.x == 1 && copy.name == "triangle" && copy.weight == 2.5);
+        assert(copy.origin.y == 4 && copy.points.size() == 3 && copy.points[2].y == 1);
+        assert(copy.unregistered == 0);
+        assert(shape_refl.equals(&shape, &copy));
+        assert(shape_refl.hash(&shape) == shape_refl.hash(&copy));
+
+        copy.points[1].x = 2;
+        assert(!shape_refl.equals(&shape, &copy));
+        copy.points[1].x = 1;
+        copy.origin.x = 0;
+        assert(!shape_refl.equals(&shape, &copy));
+        copy.origin.x = 3;
+        copy.x = 0;
+        assert(!shape_refl.equals(&shape, &copy));
+        copy.x = 1;
+        copy.weight = -0.0;
+        shape.weight = 0.0;
+        assert(shape_refl.equals(&shape, &copy) && shape_refl.hash(&shape) == shape_refl.hash(&copy));
+
+        auto cloned = shape_refl.clone(&shape);
+        assert(cloned.get_type_index() == typeid(Shape));
+        const auto& clone = *static_cast<Shape *>(cloned.get_raw());
+        assert(clone.unregistered == 5 && clone.points.size() == 3);
+        assert(shape_refl.equals(&shape, &clone));
+
+        // unordered containers are equal whatever the order of their elements.
+        std::unordered_set<std::string> lhs_set, rhs_set;
+        for (int i = 0; i < 32; ++i) {
+            lhs_set.insert(std::to_string(i));
+            rhs_set.insert(std::to_string(31 - i));
+        }
+        rhs_set.rehash(256);
+        assert(simple_reflection::value_equals(lhs_set, rhs_set));
+        assert(simple_reflection::value_hash(lhs_set) == simple_reflection::value_hash(rhs_set));
+        // the same without an operator== for the values, which are then compared by their members.
+        std::unordered_map<int, Point> lhs_map, rhs_map;
+        for (int i = 0; i < 32; ++i) {
+            lhs_map[i] = {i, -i};
+            rhs_map[31 - i] = {31 - i, i - 31};
+        }
+        rhs_map.rehash(256);
+        assert(simple_reflection::value_equals(lhs_map, rhs_map));
+        assert(simple_reflection::value_hash(lhs_map) == simple_reflection::value_hash(rhs_map));
+        rhs_map[3].y = 0;
+        assert(!simple_reflection::value_equals(lhs_map, rhs_map));
+
+        // unreflected types without an operator== can't be compared.
+        struct Opaque {
+            int value = 0;
+        };
+        bool thrown = false;
+        try {
+            std::ignore = simple_reflection::value_equals(Opaque(), Opaque());
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    inline void descriptor_test() {
+        const auto& members = shape_refl.get_member_list();
+        assert(&members == &shape_refl.get_member_list());
+        std::vector<std::string> names;
+        for (const auto& [name, type]: members) {
+            names.push_back(name);
+        }
+        assert((names == std::vector<std::string>{"name", "weight", "origin", "points"}));
+        assert(shape_refl.get_member_map().at("origin").second == typeid(Point));
+
+        // the inherited members come first.
+        names.clear();
+        shape_refl.for_each_member([&names](const std::string& name, const simple_reflection::Member&) {
+            names.push_back(name);
+        });
+        assert((names == std::vector<std::string>{"x", "name", "weight", "origin", "points"}));
+
+        const auto& callables = derived_refl.get_callable_list();
+        assert(callables.size() == 2 && callables[0].first == "get_y" && callables[1].first == "ctor");
+        assert(std::holds_alternative<simple_reflection::MethodInfo>(callables[0].second[0]));
+        assert(derived_refl.get_callable_map().at("ctor").second.size() == 1);
+
+        // a registration builds a new descriptor, the earlier references and the shared one outlive it.
+        const auto shared = shape_refl.get_shared_descriptor();
+        assert(&shared->members == &members);
+        shape_refl.register_member<&Shape::unregistered>("unregistered");
+        const auto& updated = shape_refl.get_member_list();
+        assert(updated.size() == 5 && updated.back().first == "unregistered");
+        assert(shared->members.size() == 4 && shape_refl.get_shared_descriptor()->members.size() == 5);
+        assert(&updated != &members && members.size() == 4 && members.back().first == "points");
+    }
+
     inline void run_tests() {
         begin_test("derive_test") {
             test(base_derive_test)
+            test(flattened_lookup_test)
+            test(flattened_invalidation_test)
+            test(cached_plan_test)
+            test(value_ops_test)
+            test(descriptor_test)
         } end_test()
     }
 }
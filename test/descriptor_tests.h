@@ -0,0 +1,105 @@
+//
+// Created on 2025/3/28.
+//
+
+#ifndef DESCRIPTOR_TESTS_H
+#define DESCRIPTOR_TESTS_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "simple_refl.h"
+#include "test_helper.h"
+
+namespace descriptor_tests {
+    class Point {
+    public:
+        int x = 0;
+        int y = 0;
+        std::string label;
+
+        [[nodiscard]] int sum() const {
+            return x + y;
+        }
+    };
+}
+
+template <>
+struct simple_reflection::describe<descriptor_tests::Point> {
+    static constexpr auto fields = std::make_tuple(
+        field<&descriptor_tests::Point::x>("x"),
+        field<&descriptor_tests::Point::y>("y"),
+        field<&descriptor_tests::Point::label>("label")
+    );
+
+    static constexpr auto methods = std::make_tuple(
+        method<&descriptor_tests::Point::sum>("sum")
+    );
+};
+
+namespace descriptor_tests {
+    static auto& point_refl = simple_reflection::make_reflection<Point>()
+            .register_descriptor<Point>();
+
+    static_assert(simple_reflection::is_described_v<Point>);
+    static_assert(!simple_reflection::is_described_v<std::string>);
+    static_assert(simple_reflection::field_count_v<Point> == 3);
+    static_assert(std::get<1>(simple_reflection::describe<Point>::fields).name == "y");
+
+    /**
+     * A comparator generated from the description, with no runtime lookup involved.
+     */
+    template <typename ClassType>
+    bool described_equals(const ClassType& lhs, const ClassType& rhs) {
+        bool equal = true;
+        simple_reflection::for_each_field<ClassType>([&](const auto& field) {
+            equal = equal && field.get(lhs) == field.get(rhs);
+        });
+        return equal;
+    }
+
+    inline void test_for_each_field() {
+        Point point;
+        point.x = 1;
+        point.y = 2;
+        point.label = "p";
+
+        std::string names;
+        size_t hash = 0;
+        simple_reflection::for_each_field(point, [&](const std::string_view name, const auto& value) {
+            names.append(name);
+            hash ^= std::hash<std::remove_cv_t<std::remove_reference_t<decltype(value)>>>()(value);
+        });
+        assert(names == "xylabel");
+        assert(hash != 0);
+
+        Point other = point;
+        assert(described_equals(point, other));
+        other.label = "q";
+        assert(!described_equals(point, other));
+
+        simple_reflection::for_each_field(other, [](std::string_view, auto& value) {
+            value = {};
+        });
+        assert(other.x == 0 && other.label.empty());
+    }
+
+    inline void test_register_descriptor() {
+        Point point;
+        point.x = 3;
+        point.y = 4;
+        assert(point_refl.find_member("x") != nullptr && point_refl.find_member("label") != nullptr);
+        assert(*point_refl.get_member_ref<int>(&point, "y") == 4);
+        assert(point_refl.invoke_method<int>(point, "sum") == 7);
+    }
+
+    inline void run_tests() {
+        begin_test("descriptor") {
+            test(test_for_each_field);
+            test(test_register_descriptor);
+        } end_test()
+    }
+}
+
+#endif //DESCRIPTOR_TESTS_H
@@ -0,0 +1,768 @@
+//
+// Created on 2025/3/24.
+//
+
+#ifndef HANDLE_TESTS_H
+#define HANDLE_TESTS_H
+
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simple_refl.h"
+#include "test_helper.h"
+
+namespace handle_tests {
+    class Counter {
+    public:
+        int value = 0;
+
+        Counter() = default;
+
+        void add(int x) {
+            value += x;
+        }
+
+        int add(int x, int y) {
+            value += x + y;
+            return value;
+        }
+
+        int get() const {
+            return value;
+        }
+    };
+
+    class DerivedCounter : public Counter {
+    public:
+        int extra = 0;
+    };
+
+    static auto& counter_refl = simple_reflection::make_reflection<Counter>()
+            .register_member<&Counter::value>("value")
+            .register_method<Counter, void, int>("add", &Counter::add)
+            .register_method<Counter, int, int, int>("add", &Counter::add)
+            .register_method<&Counter::get>("get")
+            .register_function<Counter>("ctor", []() { return Counter(); });
+
+    class Sink {
+    public:
+        std::string last;
+
+        void put(int) {
+            last = "int";
+        }
+
+        void put(double) {
+            last = "double";
+        }
+
+        void put(const std::string&) {
+            last = "string";
+        }
+    };
+
+    class DerivedSink : public Sink {
+    };
+
+    static auto& sink_refl = simple_reflection::make_reflection<Sink>()
+            .register_method<Sink, void, int>("put", &Sink::put)
+            .register_method<Sink, void, double>("put", &Sink::put)
+            .register_method<Sink, void, const std::string&>("put", &Sink::put);
+
+    static auto& derived_sink_refl = simple_reflection::make_reflection<DerivedSink>()
+            .derives_from<Sink>();
+
+    static auto& derived_counter_refl = simple_reflection::make_reflection<DerivedCounter>()
+            .derives_from<Counter>()
+            .register_member<&DerivedCounter::extra>("extra");
+
+    /**
+     * Counts its copies, to tell them apart from moves.
+     */
+    class Payload {
+    public:
+        static inline int copies = 0;
+
+        std::string text;
+
+        Payload() = default;
+
+        explicit Payload(std::string text): text(std::move(text)) {
+        }
+
+        Payload(const Payload& other): text(other.text) {
+            ++copies;
+        }
+
+        Payload(Payload&&) noexcept = default;
+
+        Payload& operator=(const Payload& other) {
+            text = other.text;
+            ++copies;
+            return *this;
+        }
+
+        Payload& operator=(Payload&&) noexcept = default;
+    };
+
+    class Holder {
+    public:
+        Payload payload;
+
+        void take(Payload value) {
+            payload = std::move(value);
+        }
+    };
+
+    static auto& holder_refl = simple_reflection::make_reflection<Holder>()
+            .register_member<&Holder::payload>("payload")
+            .register_method<&Holder::take>("take");
+
+    inline void test_resolve_method() {
+        Counter counter;
+        const auto add = counter_refl.resolve_method<int>("add");
+        assert(add.valid() && add.arity() == 1);
+        for (int i = 0; i < 10; ++i) {
+            add.invoke(&counter, make_args(i));
+        }
+        assert(counter.value == 45);
+
+        const auto add2 = counter_refl.resolve_method<int, int>("add");
+        assert(add2.valid() && add2.arity() == 2 && add2.get_return_type() == typeid(int));
+        assert(add2.call<int>(&counter, 1, 2) == 48);
+
+        const auto get = counter_refl.resolve_method("get");
+        assert(get.valid() && get.is_const());
+        assert(get.invoke(&counter).get<int>() == 48);
+    }
+
+    inline void test_resolve_method_mismatch() {
+        Counter counter;
+        assert(!counter_refl.resolve_method<float>("add").valid());
+        assert(!counter_refl.resolve_method("no_such_method").valid());
+
+        // invalid handles and mismatched argument counts are no-ops.
+        const auto invalid = counter_refl.resolve_method<float>("add");
+        assert(invalid.invoke(&counter, make_args(1.0f)).is_none());
+        const auto add = counter_refl.resolve_method<int>("add");
+        assert(add.invoke(&counter, make_args(1, 2)).is_none());
+        assert(counter.value == 0);
+    }
+
+    inline void test_resolve_function() {
+        const auto ctor = counter_refl.resolve_method("ctor");
+        assert(ctor.valid() && ctor.get_return_type() == typeid(Counter));
+        auto proxy = ctor.invoke(nullptr);
+        assert(proxy.get<Counter>().value == 0);
+    }
+
+    inline void test_resolve_method_in_base() {
+        DerivedCounter counter;
+        const auto add = derived_counter_refl.resolve_method<int>("add");
+        assert(add.valid());
+        add.invoke(&counter, make_args(5));
+        assert(counter.value == 5);
+    }
+
+    inline void test_resolve_member() {
+        Counter counter;
+        const auto value = counter_refl.resolve_member<int>("value");
+        assert(value.valid());
+        value.set(&counter, 42);
+        assert(counter.value == 42 && *value.get(&counter) == 42);
+
+        assert(!counter_refl.resolve_member<float>("value").valid());
+        assert(!counter_refl.resolve_member<int>("no_such_member").valid());
+    }
+
+    inline void test_resolve_member_in_base() {
+        DerivedCounter counter;
+        const auto value = derived_counter_refl.resolve_member<int>("value");
+        const auto extra = derived_counter_refl.resolve_member<int>("extra");
+        assert(value.valid() && extra.valid());
+        value.set(&counter, 1);
+        extra.set(&counter, 2);
+        assert(counter.value == 1 && counter.extra == 2);
+    }
+
+    inline void test_resolve_const_member() {
+        struct WithConst {
+            const int constant = 7;
+        };
+        auto& refl = simple_reflection::make_reflection<WithConst>()
+                .register_member<&WithConst::constant>("constant");
+
+        WithConst object;
+        assert(!refl.resolve_member<int>("constant").valid());
+        const auto constant = refl.resolve_member<const int>("constant");
+        assert(constant.valid() && *constant.get(&object) == 7);
+    }
+
+    inline void test_inline_return_value() {
+        Counter counter;
+        counter.value = 7;
+        auto proxy = counter_refl.invoke_method(&counter, "get");
+        assert(proxy.is_inline() && proxy.get<int>() == 7);
+        // inline values own no heap memory, get_ptr() hands out a detached copy.
+        assert(proxy.phantom() == nullptr);
+        const auto copy = proxy.get_ptr();
+        assert(copy != nullptr && *static_cast<int *>(copy.get()) == 7);
+
+        auto instance = counter_refl.invoke_function("ctor");
+        assert(instance.is_inline() && instance.get<Counter>().value == 0);
+
+        auto str = simple_reflection::ReturnValueProxy(std::string("heap"));
+        assert(!str.is_inline() && str.phantom() != nullptr);
+        simple_reflection::PhantomDataHelper phantom;
+        str >> phantom;
+        const auto raw = static_cast<std::string *>(str.get_raw());
+        str = simple_reflection::ReturnValueProxy(std::string("other"));
+        assert(*raw == "heap");
+    }
+
+    inline void test_invoke_into() {
+        Counter counter;
+        int result = 0;
+        counter_refl.invoke_into(&counter, "add", result, make_args(1, 2));
+        assert(result == 3 && counter.value == 3);
+        counter_refl.invoke_into(&counter, "get", result);
+        assert(result == 3);
+
+        bool thrown = false;
+        try {
+            float mismatched;
+            counter_refl.invoke_into(&counter, "get", mismatched);
+        } catch (const simple_reflection::method_not_found_exception&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        alignas(Counter) unsigned char storage[sizeof(Counter)];
+        const auto constructed = counter_refl.invoke_emplace<Counter>(
+            static_cast<void *>(nullptr), "ctor", storage);
+        assert(constructed->value == 0);
+        constructed->~Counter();
+
+        const auto get = counter_refl.resolve_method("get");
+        int out = 0;
+        assert(get.invoke_into(&counter, out) && out == 3);
+        float wrong = 0;
+        assert(!get.invoke_into(&counter, wrong));
+    }
+
+    inline void test_try_lookup() {
+        DerivedCounter counter;
+        auto sum = derived_counter_refl.try_invoke_method(&counter, "add", make_args(1, 2));
+        assert(sum.has_value() && sum->get<int>() == 3);
+        assert(!derived_counter_refl.try_invoke_method(&counter, "add", make_args(1.0)).has_value());
+        assert(!derived_counter_refl.try_invoke_method(&counter, "missing").has_value());
+
+        const auto instance = counter_refl.try_invoke_function("ctor");
+        assert(instance.has_value() && instance->get_type_index() == typeid(Counter));
+        assert(!counter_refl.try_invoke_function("missing").has_value());
+
+        int out = -1;
+        assert(derived_counter_refl.try_invoke_into(&counter, "get", out) && out == 3);
+        out = -1;
+        float mismatched = 0;
+        assert(!derived_counter_refl.try_invoke_into(&counter, "get", mismatched));
+        assert(!derived_counter_refl.try_invoke_into(&counter, "missing", out) && out == -1);
+
+        const auto member = derived_counter_refl.find_member("value");
+        assert(member != nullptr && member->type_info == typeid(int));
+        assert(derived_counter_refl.find_member("missing") == nullptr);
+
+        assert(simple_reflection::try_get_reflection(typeid(DerivedCounter)) == &derived_counter_refl);
+        assert(simple_reflection::try_get_reflection(typeid(std::string)) == nullptr);
+        assert(simple_reflection::ReflectionRegistryBase::instance().try_get_reflection<Counter>() == &counter_refl);
+
+        assert(counter_refl.find_metadata("missing") == nullptr);
+        assert(counter_refl.try_get_metadata_as<std::string>("missing") == nullptr);
+
+        // the message is built eagerly, and stays valid as long as the exception does.
+        const simple_reflection::method_not_found_exception e("missing");
+        assert(std::string(e.what()) == "Method \"missing\" not found, or the signature mismatched.");
+    }
+
+    inline void test_gather_scatter() {
+        std::vector<DerivedCounter> counters(5);
+        for (int i = 0; i < 5; ++i) {
+            counters[i].value = i;
+            counters[i].extra = i * 10;
+        }
+
+        int values[5] = {};
+        assert(derived_counter_refl.gather("value", counters.data(), counters.size(), values));
+        for (int i = 0; i < 5; ++i) {
+            assert(values[i] == i);
+        }
+
+        const int extras[5] = {5, 4, 3, 2, 1};
+        assert(derived_counter_refl.scatter("extra", counters.data(), counters.size(), extras));
+        for (int i = 0; i < 5; ++i) {
+            assert(counters[i].extra == 5 - i && counters[i].value == i);
+        }
+
+        // a custom stride: every other object.
+        int every_other[3] = {};
+        assert(derived_counter_refl.gather("extra", counters.data(), 3, 2 * sizeof(DerivedCounter), every_other));
+        assert(every_other[0] == 5 && every_other[1] == 3 && every_other[2] == 1);
+
+        double mismatched[5];
+        assert(!derived_counter_refl.gather("value", counters.data(), counters.size(), mismatched));
+        assert(!derived_counter_refl.scatter("missing", counters.data(), counters.size(), extras));
+
+        // non-trivially copyable members are copied element by element.
+        struct Named {
+            std::string name;
+            int id = 0;
+        };
+        static auto& named_refl = simple_reflection::make_reflection<Named>()
+                .register_member<&Named::name>("name");
+        std::vector<Named> named(3);
+        const std::string names[3] = {"a", "b", "c"};
+        assert(named_refl.scatter("name", named.data(), named.size(), names));
+        std::string out[3];
+        assert(named_refl.gather("name", named.data(), named.size(), out));
+        assert(out[0] == "a" && out[2] == "c" && named[1].name == "b");
+    }
+
+    inline void test_symbol_lookup() {
+        const simple_reflection::Symbol value("value");
+        assert(value == simple_reflection::Symbol::find("value") && value.view() == "value");
+        // looking a name up does not intern it.
+        assert(derived_counter_refl.find_member("handle_tests::never_interned") == nullptr);
+        assert(!simple_reflection::Symbol::find("handle_tests::never_interned"));
+
+        DerivedCounter counter;
+        counter.value = 3;
+        assert(derived_counter_refl.find_member(value) == derived_counter_refl.find_member("value"));
+        assert(*derived_counter_refl.resolve_member<int>(value).get(&counter) == 3);
+
+        // names don't have to be null-terminated.
+        const std::string_view names = "extra,value";
+        assert(derived_counter_refl.find_member(names.substr(0, 5)) != nullptr);
+        assert(derived_counter_refl.find_member(names.substr(0, 4)) == nullptr);
+
+        const auto add = derived_counter_refl.resolve_method(simple_reflection::Symbol("add"),
+                                                             simple_reflection::StaticSignature<int, int>::span());
+        assert(add.valid() && add.call<int>(&counter, 1, 2) == 6);
+
+        simple_reflection::SymbolMap<int> map;
+        for (const auto name: {"c", "a", "b", "a"}) {
+            map.try_emplace(simple_reflection::Symbol(name), static_cast<int>(map.size()));
+        }
+        assert(map.size() == 3 && *map.find("a") == 1 && *map.find("b") == 2 && map.find("d") == nullptr);
+        for (auto it = map.begin(); it + 1 != map.end(); ++it) {
+            assert(it->first < (it + 1)->first);
+        }
+
+        // lookups don't lock, and keep finding the interned names while the table grows.
+        std::atomic<bool> done{false};
+        std::thread reader([&done]() {
+            while (!done.load(std::memory_order_acquire)) {
+                assert(simple_reflection::Symbol::find("value").view() == "value");
+            }
+        });
+        std::vector<simple_reflection::Symbol> interned;
+        for (int i = 0; i < 1000; ++i) {
+            interned.emplace_back("handle_tests::symbol_" + std::to_string(i));
+        }
+        done.store(true, std::memory_order_release);
+        reader.join();
+        for (int i = 0; i < 1000; ++i) {
+            assert(simple_reflection::Symbol::find("handle_tests::symbol_" + std::to_string(i)) == interned[i]);
+        }
+
+        // names are taken as views, so neither temporaries nor mutable strings are needed.
+        const std::string get_name = "get";
+        const std::string_view value_name = names.substr(6);
+        assert(derived_counter_refl.invoke_method<int>(counter, get_name) == 6);
+        assert(*derived_counter_refl.get_member_ref<int>(counter, value_name) == 6);
+    }
+
+    inline void test_thunks() {
+        // methods registered by pointer bake it into the thunk, those given at runtime pass it as the context.
+        const auto get = counter_refl.find_overload("get", {});
+        assert(get && get->callable.context == nullptr);
+        assert(get->callable.thunk == &simple_reflection::MethodThunk<&Counter::get>::call);
+        const auto add = counter_refl.find_overload("add", simple_reflection::StaticSignature<int>::span());
+        assert(add && add->callable.context != nullptr);
+        using simple_reflection::method_signature_id;
+        assert((add->signature_id == method_signature_id<void, const int&>()));
+        assert((add->signature_id != method_signature_id<int, int>()));
+
+        Counter counter;
+        counter_refl.invoke_method<void>(counter, "add", 2);
+        assert(counter_refl.invoke_method<int>(counter, "add", 1, 1) == 4);
+        assert(counter_refl.invoke_method<int>(counter, "get") == 4);
+        bool thrown = false;
+        try {
+            std::ignore = counter_refl.invoke_method<long>(counter, "get");
+        } catch (const simple_reflection::method_not_found_exception&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    inline void test_overload_cache() {
+        DerivedSink sink;
+        std::string text = "text";
+        for (int i = 0; i < 3; ++i) {
+            derived_sink_refl.invoke_method(&sink, "put", make_args(1.0));
+            assert(sink.last == "double");
+            derived_sink_refl.invoke_method(&sink, "put", make_args(text));
+            assert(sink.last == "string");
+            derived_sink_refl.invoke_method(&sink, "put", make_args(1));
+            assert(sink.last == "int");
+        }
+        const auto cached = derived_sink_refl.find_overload("put", simple_reflection::StaticSignature<double>::span());
+        assert(cached && cached.wrapper == derived_sink_refl.find_overload(
+            "put", simple_reflection::StaticSignature<double>::span()).wrapper);
+        assert(!derived_sink_refl.find_overload("put", simple_reflection::StaticSignature<float>::span()));
+
+        // a registration anywhere drops the cache, so the new overload is found, even through the base class.
+        sink_refl.register_function<void, float>("put", [](float) {
+        });
+        assert(derived_sink_refl.find_overload("put", simple_reflection::StaticSignature<float>::span()));
+        derived_sink_refl.invoke_method(&sink, "put", make_args(2.0));
+        assert(sink.last == "double");
+    }
+
+    class Tally {
+    };
+
+    static auto& tally_refl = simple_reflection::make_reflection<Tally>()
+            .register_function<int>("first", []() { return 1; });
+
+    inline void test_overload_ref_lifetime() {
+        const auto first = tally_refl.find_overload("first", simple_reflection::TypeIndexSpan());
+        assert(first);
+        // new names grow the table of overloads, which must not move the registered ones.
+        for (int i = 0; i < 64; ++i) {
+            tally_refl.register_function<int>("extra_" + std::to_string(i), [i]() { return i; });
+        }
+        assert(first.wrapper == tally_refl.find_overload("first", simple_reflection::TypeIndexSpan()).wrapper);
+    }
+
+    inline void test_rvalue_args() {
+        Holder holder;
+        Payload payload("payload");
+
+        // lvalues are copied into by-value parameters, rvalues are moved.
+        Payload::copies = 0;
+        holder_refl.invoke_method(&holder, "take", make_args(payload));
+        assert(Payload::copies == 1 && payload.text == "payload" && holder.payload.text == "payload");
+        holder_refl.invoke_method<void>(holder, "take", payload);
+        assert(Payload::copies == 2 && payload.text == "payload");
+        holder_refl.invoke_method(&holder, "take", make_args(Payload("moved")));
+        assert(Payload::copies == 2 && holder.payload.text == "moved");
+        holder_refl.invoke_method(&holder, "take", simple_reflection::empty_arg_list()
+                                                   | simple_reflection::wrap_object(Payload("wrapped")));
+        assert(Payload::copies == 2 && holder.payload.text == "wrapped");
+
+        const auto args = make_args(payload, Payload("second"));
+        assert(!args.is_rvalue(0) && args.is_rvalue(1));
+        // only 64 arguments have a bit, the ones past them are copied.
+        assert(simple_reflection::is_rvalue_arg(simple_reflection::all_rvalues, 63));
+        assert(!simple_reflection::is_rvalue_arg(simple_reflection::all_rvalues, 64));
+
+        // set_member copies unless the wrapper is marked as an rvalue.
+        assert(holder_refl.set_member(&holder, "payload", simple_reflection::wrap_object(payload)));
+        assert(Payload::copies == 3 && payload.text == "payload");
+        auto proxy = simple_reflection::ReturnValueProxy(Payload("proxied"));
+        assert(holder_refl.set_member(&holder, "payload", proxy.to_moved()));
+        assert(Payload::copies == 3 && holder.payload.text == "proxied");
+        Payload other("other");
+        assert(holder_refl.move_member(&holder, "payload", &other));
+        assert(Payload::copies == 3 && holder.payload.text == "other");
+        assert(!holder_refl.move_member(&holder, "missing", &other));
+    }
+
+    class Tracked {
+    public:
+        int x = 0;
+        int y = 0;
+        std::string label;
+        simple_reflection::DirtySet changes;
+    };
+
+    static auto& tracked_refl = simple_reflection::make_reflection<Tracked>()
+            .register_member<&Tracked::x>("x")
+            .register_member<&Tracked::y>("y")
+            .register_member<&Tracked::label>("label")
+            .track_changes<&Tracked::changes>();
+
+    class TrackedChild : public Tracked {
+    public:
+        int z = 0;
+    };
+
+    static auto& tracked_child_refl = simple_reflection::make_reflection<TrackedChild>()
+            .derives_from<Tracked>()
+            .register_member<&TrackedChild::z>("z");
+
+    inline void test_change_tracking() {
+        Tracked tracked;
+        assert(tracked_refl.tracks_changes() && tracked_refl.get_dirty_set(&tracked) == &tracked.changes);
+        assert(!tracked.changes.any());
+
+        const auto index_of = [](const simple_reflection::ReflectionBase& reflection, const std::string_view name) {
+            return reflection.find_member(name)->table_index;
+        };
+        int value = 3;
+        assert(tracked_refl.set_member(&tracked, "y", simple_reflection::wrap_object(value)));
+        assert(tracked.y == 3 && tracked.changes.count() == 1 && tracked.changes.contains(index_of(tracked_refl, "y")));
+
+        tracked_refl.resolve_member<std::string>("label").set(&tracked, "changed");
+        assert(tracked.changes.count() == 2 && tracked.changes.contains(index_of(tracked_refl, "label")));
+        assert(!tracked.changes.contains(index_of(tracked_refl, "x")));
+
+        // writes through raw pointers have to be marked by hand.
+        *tracked_refl.get_member_ref<int>(&tracked, "x") = 1;
+        assert(!tracked.changes.contains(index_of(tracked_refl, "x")));
+        assert(tracked_refl.mark_changed(&tracked, "x") && tracked.changes.count() == 3);
+        tracked_refl.clear_changes(&tracked);
+        assert(!tracked.changes.any());
+
+        // the tracking is inherited, with the bits of the derived table.
+        TrackedChild child;
+        assert(tracked_child_refl.tracks_changes() && tracked_child_refl.get_dirty_set(&child) == &child.changes);
+        assert(tracked_child_refl.set_member(&child, "z", simple_reflection::wrap_object(value)));
+        assert(child.changes.count() == 1 && child.changes.contains(index_of(tracked_child_refl, "z")));
+
+        simple_reflection::DirtySet wide;
+        wide.mark(3);
+        wide.mark(200);
+        std::vector<size_t> marked;
+        wide.for_each([&marked](const size_t index) {
+            marked.push_back(index);
+        });
+        assert((marked == std::vector<size_t>{3, 200}) && wide.contains(200) && !wide.contains(199));
+        wide.clear();
+        assert(!wide.any() && !handle_tests::holder_refl.tracks_changes());
+    }
+
+    class Account {
+    public:
+        int balance = 0;
+
+        int deposit(const int amount) {
+            if (amount < 0) {
+                throw std::invalid_argument("negative deposit");
+            }
+            balance += amount;
+            return balance;
+        }
+    };
+
+    static auto& account_refl = simple_reflection::make_reflection<Account>()
+            .register_member<&Account::balance>("balance")
+            .register_method<&Account::deposit>("deposit");
+
+    inline void test_invocation_batch() {
+        const auto deposit = account_refl.resolve_method<int>("deposit");
+        std::vector<Account> accounts(8);
+        simple_reflection::InvocationBatch batch;
+        for (int round = 1; round <= 50; ++round) {
+            for (auto& account: accounts) {
+                batch.add(&account, deposit, round);
+            }
+        }
+        const auto failing = batch.add(&accounts[0], deposit, -1);
+        const auto last = batch.add(&accounts[0], deposit, 1);
+
+        batch.run();
+        assert(accounts[0].balance == 1276 && accounts[7].balance == 1275);
+        assert(batch.result(0).get<int>() == 1 && batch.result(last).get<int>() == 1276);
+        assert(batch.failures() == 1 && batch.error(failing) != nullptr && batch.result(failing).is_none());
+
+        // the calls on one object keep their order across the workers.
+        simple_reflection::ThreadPool pool(4);
+        batch.run(pool, 1);
+        assert(accounts[0].balance == 2552 && accounts[7].balance == 2550);
+        assert(batch.result(last).get<int>() == 2552 && batch.result(1).get<int>() == 1276);
+        bool thrown = false;
+        try {
+            batch.rethrow();
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        const auto get = counter_refl.resolve_method("get");
+        Counter counter;
+        counter.value = 5;
+        simple_reflection::InvocationBatch grouped;
+        grouped.add(&accounts[1], deposit, 1);
+        grouped.add(&counter, get);
+        grouped.add(&accounts[2], deposit, 1);
+        grouped.run(simple_reflection::BatchOrder::by_method);
+        assert(grouped.results().size() == 3 && grouped.result(1).get<int>() == 5);
+        assert(grouped.result(2).get<int>() == 2551);
+
+        // the batch keeps its own copies of the handles and of the arguments, and can be run again.
+        Holder holder;
+        simple_reflection::InvocationBatch owning;
+        owning.add(&holder, holder_refl.resolve_method<Payload>("take"), Payload(std::string(64, 'x')));
+        owning.add(&accounts[3], account_refl.resolve_method<int>("deposit"), 1);
+        owning.add(&accounts[3], account_refl.resolve_method<int>("deposit"), 2);
+        owning.run(simple_reflection::BatchOrder::by_method);
+        owning.run();
+        assert(holder.payload.text == std::string(64, 'x') && accounts[3].balance == 2556);
+        assert(owning.result(2).get<int>() == 2556);
+
+        thrown = false;
+        try {
+            owning.add(&accounts[3], deposit, 1.0);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown && owning.size() == 3);
+    }
+
+#if SIMPLE_REFL_HAS_COROUTINES
+    // a coroutine which starts right away, and which nobody awaits.
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() noexcept {
+                return {};
+            }
+
+            std::suspend_never initial_suspend() noexcept {
+                return {};
+            }
+
+            std::suspend_never final_suspend() noexcept {
+                return {};
+            }
+
+            void return_void() noexcept {
+            }
+
+            void unhandled_exception() noexcept {
+                std::terminate();
+            }
+        };
+    };
+
+    inline Detached deposit_twice(Account& account, std::atomic<int>& balance) {
+        auto first = co_await account_refl.invoke_async(&account, "deposit", 1);
+        auto second = co_await account_refl.invoke_async(&account, "deposit", first.get<int>());
+        balance = second.get<int>();
+    }
+#endif
+
+    inline void test_invoke_async() {
+        Account account;
+        auto future = account_refl.invoke_async(&account, "deposit", 5);
+        assert(future.get().get<int>() == 5 && future.ready());
+
+        simple_reflection::ThreadPool pool(1);
+        std::atomic<bool> continued = false;
+        auto chained = account_refl.invoke_async(pool, &account, "deposit", 2);
+        chained.then([&continued]() {
+            continued = true;
+        });
+        assert(chained.get().get<int>() == 7);
+        while (!continued) {
+            std::this_thread::yield();
+        }
+
+        auto failed = account_refl.invoke_async(pool, &account, "deposit", -1);
+        bool thrown = false;
+        try {
+            std::ignore = failed.get();
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown && account.balance == 7);
+
+        thrown = false;
+        try {
+            std::ignore = account_refl.invoke_async(&account, "withdraw", 1);
+        } catch (const simple_reflection::method_not_found_exception&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        auto built = counter_refl.invoke_function_async("ctor");
+        assert(built.get().get<Counter>().value == 0);
+
+#if SIMPLE_REFL_HAS_COROUTINES
+        Account awaited;
+        std::atomic<int> balance = 0;
+        deposit_twice(awaited, balance);
+        while (balance == 0) {
+            std::this_thread::yield();
+        }
+        assert(balance == 2);
+#endif
+    }
+
+    inline void test_parallel_for() {
+        simple_reflection::ThreadPool pool(2);
+        std::vector<std::atomic<int>> hits(1000);
+        pool.parallel_for(hits.size(), [&hits](const size_t i) {
+            hits[i].fetch_add(1, std::memory_order_relaxed);
+        });
+        for (const auto& hit: hits) {
+            assert(hit.load() == 1);
+        }
+        pool.parallel_for(0, [](size_t) {
+            assert(false);
+        });
+
+        // nested batches finish even when every worker is inside one.
+        std::atomic<int> inner = 0;
+        pool.parallel_for(4, [&pool, &inner](size_t) {
+            pool.parallel_for(8, [&inner](size_t) {
+                inner.fetch_add(1, std::memory_order_relaxed);
+            });
+        });
+        assert(inner == 32);
+
+        bool thrown = false;
+        try {
+            pool.parallel_for(16, [](const size_t i) {
+                if (i % 5 == 3) {
+                    throw std::invalid_argument("chunk");
+                }
+            });
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    inline void run_tests() {
+        begin_test("handle") {
+            test(test_resolve_method);
+            test(test_resolve_method_mismatch);
+            test(test_resolve_function);
+            test(test_resolve_method_in_base);
+            test(test_resolve_member);
+            test(test_resolve_member_in_base);
+            test(test_resolve_const_member);
+            test(test_inline_return_value);
+            test(test_invoke_into);
+            test(test_try_lookup);
+            test(test_gather_scatter);
+            test(test_symbol_lookup);
+            test(test_thunks);
+            test(test_overload_cache);
+            test(test_overload_ref_lifetime);
+            test(test_rvalue_args);
+            test(test_change_tracking);
+            test(test_invocation_batch);
+            test(test_invoke_async);
+            test(test_parallel_for);
+        } end_test()
+    }
+}
+
+#endif //HANDLE_TESTS_H
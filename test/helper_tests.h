@@ -74,11 +74,81 @@ namespace helper_tests {
         assert(std::type_index(typeid(typeof(*pa))) == invoke_result.get_type_index());
     }
 
+    void test_arg_list_merge() {
+        float a = 1.0f;
+        auto args = (simple_reflection::refl_args(a), simple_reflection::refl_args(2, 3.0));
+        assert(args.size == 3);
+        assert(args.type_indices()[0] == typeid(float));
+        assert(args.type_indices()[1] == typeid(int));
+        assert(args.type_indices()[2] == typeid(double));
+        assert(*static_cast<float *>(args.get()[0]) == 1.0f);
+        assert(*static_cast<int *>(args.get()[1]) == 2);
+        assert(*static_cast<double *>(args.get()[2]) == 3.0);
+
+        // the rvalues are kept inline, so they survive both the merge and the move.
+        auto moved = std::move(args);
+        assert(*static_cast<int *>(moved.get()[1]) == 2);
+    }
+
+    void test_arg_list_spill() {
+        auto args = simple_reflection::refl_args(0, 1, 2, 3, 4)
+                    | simple_reflection::refl_args(5, 6, 7, 8, 9);
+        assert(args.size == 10);
+        for (int i = 0; i < 10; ++i) {
+            assert(*static_cast<int *>(args.get()[i]) == i);
+        }
+        for (auto type: args.type_indices()) {
+            assert(type == typeid(int));
+        }
+
+        // the values past the inline ones survive the lists they came from, and a second merge.
+        auto moved = std::move(args) | simple_reflection::refl_args(10, 11);
+        assert(moved.size == 12);
+        for (int i = 0; i < 12; ++i) {
+            assert(*static_cast<int *>(moved.get()[i]) == i);
+        }
+    }
+
+    void test_static_arg_list() {
+        TestClass test_class(0.0f, 0.0f);
+        float x = 1.0f, y = 2.0f;
+        auto args = simple_reflection::StaticArgList<float, float>(x, y);
+        using Signature = simple_reflection::StaticSignature<float, float>;
+        assert(args.type_indices().data() == Signature::span().data());
+
+        auto fn = simple_reflection::wrap_method(&TestClass::test_void_function);
+        fn(&test_class, args.get());
+        assert(test_class.x == 1.0f && test_class.y == 2.0f);
+
+        simple_reflection::ArgList list = args;
+        assert(list.size == 2 && list.type_indices().data() == args.type_indices().data());
+    }
+
+    void test_arg_list_ownership() {
+        int a = 1, b = 2;
+        using Signature = simple_reflection::StaticSignature<int, int>;
+        // an array on the stack is copied, never taken over.
+        simple_reflection::RawArg raw[] = {&a, &b};
+        simple_reflection::ArgList borrowed(raw, Signature::span(), simple_reflection::ArgFlags{0});
+        assert(borrowed.size == 2 && borrowed.get() != raw && !borrowed.is_rvalue(0));
+        assert(*static_cast<int *>(borrowed.get()[1]) == 2);
+
+        auto owned_args = std::make_unique<simple_reflection::RawArg[]>(2);
+        owned_args[0] = &a;
+        owned_args[1] = &b;
+        simple_reflection::ArgList owned(std::move(owned_args), Signature::span(), 2);
+        assert(owned.size == 2 && owned.is_rvalue(1) && *static_cast<int *>(owned.get()[0]) == 1);
+    }
+
     void run_tests() {
         begin_test("helpers") {
             test(helper_tests::test_can_cast_to);
             // test(helper_tests::test_function_cast);
             test(helper_tests::any_wrapper_test);
+            test(helper_tests::test_arg_list_merge);
+            test(helper_tests::test_arg_list_spill);
+            test(helper_tests::test_static_arg_list);
+            test(helper_tests::test_arg_list_ownership);
         } end_test()
     }
 }
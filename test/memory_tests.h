@@ -0,0 +1,133 @@
+//
+// Created on 2025/3/26.
+//
+
+#ifndef MEMORY_TESTS_H
+#define MEMORY_TESTS_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "simple_refl.h"
+#include "test_helper.h"
+
+namespace memory_tests {
+    /**
+     * An upstream resource which counts the allocations passing through it.
+     */
+    class CountingResource final : public std::pmr::memory_resource {
+    public:
+        size_t allocations = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        [[nodiscard]] bool do_is_equal(const memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    class Tracked {
+    public:
+        std::string name;
+        int id = 0;
+
+        static std::vector<int>& destroyed() {
+            static std::vector<int> order;
+            return order;
+        }
+
+        Tracked() = default;
+
+        Tracked(const Tracked&) = default;
+
+        Tracked(Tracked&&) = default;
+
+        ~Tracked() {
+            destroyed().push_back(id);
+        }
+
+        [[nodiscard]] Tracked rename(std::string new_name) const {
+            Tracked copy = *this;
+            copy.name = std::move(new_name);
+            return copy;
+        }
+    };
+
+    static auto& tracked_refl = simple_reflection::make_reflection<Tracked>()
+            .register_member<&Tracked::name>("name")
+            .register_member<&Tracked::id>("id")
+            .register_method<&Tracked::rename>("rename")
+            .register_function<Tracked>("ctor", []() { return Tracked(); });
+
+    inline void test_arena_create() {
+        Tracked::destroyed().clear();
+        {
+            simple_reflection::ReflectionArena arena;
+            arena.create<Tracked>()->id = 1;
+            arena.create<Tracked>()->id = 2;
+            const auto value = arena.create<int>(42);
+            assert(*value == 42);
+            assert(Tracked::destroyed().empty());
+        }
+        // destroyed in bulk, in reverse order of creation.
+        assert((Tracked::destroyed() == std::vector<int>{2, 1}));
+    }
+
+    inline void test_arena_invoke() {
+        Tracked::destroyed().clear();
+        CountingResource upstream;
+        {
+            simple_reflection::ReflectionArena arena(4096, &upstream);
+            auto instance = tracked_refl.invoke_function("ctor", arena);
+            assert(instance.get_type_index() == typeid(Tracked));
+            assert(instance.phantom().use_count() == 0);
+            const auto tracked = static_cast<Tracked *>(instance.get_raw());
+            tracked->id = 3;
+
+            auto renamed = tracked_refl.invoke_method(tracked, "rename", make_args(std::string("arena")), arena);
+            const auto renamed_ptr = static_cast<Tracked *>(renamed.get_raw());
+            assert(renamed_ptr->name == "arena");
+            renamed_ptr->id = 4;
+
+            // both results live in the initial block of the arena.
+            assert(upstream.allocations == 1);
+            assert(tracked->id == 3);
+            Tracked::destroyed().clear();
+        }
+        assert((Tracked::destroyed() == std::vector<int>{4, 3}));
+    }
+
+    inline void test_arena_release() {
+        Tracked::destroyed().clear();
+        simple_reflection::ReflectionArena arena;
+        for (int i = 0; i < 16; ++i) {
+            auto instance = tracked_refl.invoke_function("ctor", arena);
+            static_cast<Tracked *>(instance.get_raw())->id = i;
+        }
+        arena.release();
+        assert(Tracked::destroyed().size() == 16 && Tracked::destroyed().front() == 15);
+
+        // the arena is reusable after being released.
+        auto instance = tracked_refl.invoke_function("ctor", arena);
+        assert(static_cast<Tracked *>(instance.get_raw())->id == 0);
+    }
+
+    inline void run_tests() {
+        begin_test("memory") {
+            test(test_arena_create);
+            test(test_arena_invoke);
+            test(test_arena_release);
+        } end_test()
+    }
+}
+
+#endif //MEMORY_TESTS_H
@@ -0,0 +1,247 @@
+//
+// Created on 2025/3/27.
+//
+
+#ifndef REGISTRY_TESTS_H
+#define REGISTRY_TESTS_H
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "simple_refl.h"
+#include "test_helper.h"
+
+namespace registry_tests {
+    class Frozen {
+    public:
+        int value = 0;
+
+        [[nodiscard]] int scaled(const int factor) const {
+            return value * factor;
+        }
+    };
+
+    class LateRegistered {
+    public:
+        int value = 0;
+    };
+
+    static auto& frozen_refl = simple_reflection::make_reflection<Frozen>()
+            .register_member<&Frozen::value>("value")
+            .register_method<&Frozen::scaled>("scaled");
+
+    class FrozenChild : public Frozen {
+    public:
+        int extra = 0;
+    };
+
+    class Pooled {
+    public:
+        std::string label = "pooled";
+    };
+
+    static auto& pooled_refl = simple_reflection::make_reflection<Pooled>()
+            .register_member<&Pooled::label>("label")
+            .register_function<Pooled>("ctor", []() { return Pooled(); });
+
+    static auto& frozen_child_refl = simple_reflection::make_reflection<FrozenChild>()
+            .derives_from<Frozen>()
+            .register_member<&FrozenChild::extra>("extra");
+
+    // a registry of its own, so that freezing it leaves the global one alone.
+    inline simple_reflection::ReflectionRegistryBase& frozen_registry() {
+        static simple_reflection::ReflectionRegistryBase registry;
+        return registry;
+    }
+
+    inline void test_freeze() {
+        auto& registry = frozen_registry();
+        auto& frozen = registry.register_base<Frozen>();
+        assert(!registry.is_frozen());
+        registry.freeze();
+        assert(registry.is_frozen());
+        assert(!simple_reflection::ReflectionRegistryBase::instance().is_frozen());
+        assert(&registry.get_reflection<Frozen>() == &frozen);
+        assert(&registry.get_reflection(typeid(Frozen)) == &frozen);
+        assert(&registry.get_reflection("registry_tests::Frozen") == &frozen);
+        assert(&frozen != &frozen_refl);
+
+        // the published types can't be registered on, since their readers don't lock.
+        assert(frozen.is_published() && !frozen_refl.is_published());
+        bool thrown = false;
+        try {
+            frozen.register_member<&Frozen::value>("value_alias");
+        } catch (const std::logic_error&) {
+            thrown = true;
+        }
+        assert(thrown && frozen.find_member("value_alias") == nullptr);
+    }
+
+    inline void test_concurrent_lookup() {
+        auto& registry = frozen_registry();
+        const auto frozen = registry.try_get_reflection<Frozen>();
+        std::atomic<int> found = 0;
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&registry, &found, frozen]() {
+                for (int j = 0; j < 1000; ++j) {
+                    if (&registry.get_reflection(typeid(Frozen)) == frozen
+                        && &simple_reflection::get_reflection(typeid(Frozen)) == &frozen_refl) {
+                        found.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+        for (auto& reader: readers) {
+            reader.join();
+        }
+        assert(found == 4000);
+    }
+
+    inline void test_publish_after_freeze() {
+        auto& registry = frozen_registry();
+        auto& late = registry.register_base<LateRegistered>();
+        late.register_member<&LateRegistered::value>("value");
+
+        // invisible to the readers until published.
+        bool thrown = false;
+        try {
+            std::ignore = registry.get_reflection<LateRegistered>();
+        } catch (const simple_reflection::reflection_registry_not_found_exception&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        registry.publish();
+        assert(&registry.get_reflection<LateRegistered>() == &late && late.is_published());
+        assert(late.find_member("value") != nullptr);
+        assert(registry.get_reflection<Frozen>().get_type() == typeid(Frozen));
+    }
+
+#if SIMPLE_REFL_CONSTEXPR_TYPE_NAME && defined (__GNUC__)
+    static_assert(simple_reflection::type_name_v<Frozen> == "registry_tests::Frozen");
+    static_assert(simple_reflection::type_name_v<std::vector<std::string>> == "std::vector<std::string>");
+#endif
+
+    inline void test_type_names() {
+        auto& interner = simple_reflection::TypeNameInterner::instance();
+        assert(simple_reflection::extract_type_name<Frozen>() == "registry_tests::Frozen");
+        assert(frozen_refl.get_type_name().data() == interner.find("registry_tests::Frozen").data());
+        assert(interner.find("registry_tests::NeverRegistered").data() == nullptr);
+
+        const std::string copy = "registry_tests::Interned";
+        const auto interned = interner.intern(copy);
+        assert(interned == copy && interned.data() != copy.data());
+        assert(interner.intern(std::string(copy)).data() == interned.data());
+        assert(interner.find(copy).data() == interned.data());
+    }
+
+    inline void test_fresh_registry() {
+        // a registry of its own derives the names itself, and only parses them when asked for.
+        simple_reflection::ReflectionRegistryBase fresh;
+        auto& reflection = fresh.register_base<Frozen>();
+        assert(reflection.get_type_string() == "registry_tests::Frozen");
+        const auto parsed = reflection.get_type_parsed();
+        assert(parsed.type_name == "Frozen" && parsed.namespaces == std::vector<std::string>{"registry_tests"});
+        assert(fresh.try_get_reflection("registry_tests::Frozen") == &reflection);
+    }
+
+    inline void test_stats() {
+        using simple_reflection::StatKind;
+        auto& stats = simple_reflection::ReflectionStats::instance();
+        stats.reset();
+
+        FrozenChild child;
+        child.value = 3;
+        assert(*frozen_child_refl.get_member_ref<int>(&child, "value") == 3);
+        assert(*frozen_child_refl.get_member_ref<int>(&child, "extra") == 0);
+        assert(frozen_child_refl.invoke_method<int>(static_cast<void *>(&child), "scaled", 2) == 6);
+        bool thrown = false;
+        try {
+            std::ignore = frozen_child_refl.invoke_method<int>(static_cast<void *>(&child), "scaled");
+        } catch (const simple_reflection::method_not_found_exception&) {
+            thrown = true;
+        }
+        assert(thrown);
+        // the counters of a thread survive its exit.
+        std::thread([]() {
+            Frozen frozen;
+            frozen.value = 1;
+            std::ignore = frozen_refl.invoke_method<int>(static_cast<void *>(&frozen), "scaled", 1);
+        }).join();
+
+        const auto snapshot = stats.snapshot();
+        if constexpr (simple_reflection::stats_enabled) {
+            using simple_reflection::ReflectionStats;
+            const auto value = ReflectionStats::find(snapshot, "registry_tests::FrozenChild", "value");
+            assert(value[StatKind::member_access] == 1 && value[StatKind::base_class_hit] == 1);
+            const auto extra = ReflectionStats::find(snapshot, "registry_tests::FrozenChild", "extra");
+            assert(extra[StatKind::member_access] == 1 && extra[StatKind::base_class_hit] == 0);
+            const auto scaled = ReflectionStats::find(snapshot, "registry_tests::FrozenChild", "scaled");
+            assert(scaled[StatKind::method_lookup] == 2 && scaled[StatKind::base_class_hit] == 2);
+            assert(scaled[StatKind::exception] == 1);
+            const auto parent = ReflectionStats::find(snapshot, "registry_tests::Frozen", "scaled");
+            assert(parent[StatKind::method_lookup] == 1 && parent[StatKind::base_class_hit] == 0);
+
+            stats.reset();
+            assert(stats.snapshot().empty());
+        } else {
+            assert(snapshot.empty());
+        }
+    }
+
+    inline void test_object_pool() {
+        using Pool = simple_reflection::ObjectPool<Pooled>;
+        assert(Pool::enabled());
+        assert(frozen_refl.pool_stats().allocations == 0);
+
+        const auto before = pooled_refl.pool_stats();
+        for (int i = 0; i < 100; ++i) {
+            auto instance = pooled_refl.invoke_function("ctor");
+            assert(instance.get<Pooled>().label == "pooled");
+        }
+        auto stats = pooled_refl.pool_stats();
+        assert(stats.allocations - before.allocations == 100);
+        assert(stats.hits - before.hits >= 99);
+        assert(stats.live == 0 && stats.high_water >= 1);
+
+        {
+            std::vector<simple_reflection::ReturnValueProxy> held;
+            for (int i = 0; i < 3; ++i) {
+                held.push_back(pooled_refl.invoke_function("ctor"));
+            }
+            assert(pooled_refl.pool_stats().live == 3 && pooled_refl.pool_stats().high_water >= 3);
+        }
+        assert(pooled_refl.pool_stats().live == 0);
+
+        // a block allocated on a thread and returned on another.
+        auto moved = std::make_unique<simple_reflection::ReturnValueProxy>(Pooled());
+        std::thread([&moved]() {
+            moved.reset();
+        }).join();
+        assert(pooled_refl.pool_stats().live == 0);
+
+        Pool::disable();
+        stats = pooled_refl.pool_stats();
+        std::ignore = pooled_refl.invoke_function("ctor");
+        assert(pooled_refl.pool_stats().allocations == stats.allocations);
+        Pool::enable();
+        assert(pooled_refl.pool_stats().hit_rate() > 0.9);
+    }
+
+    inline void run_tests() {
+        begin_test("registry") {
+            test(test_freeze);
+            test(test_concurrent_lookup);
+            test(test_publish_after_freeze);
+            test(test_type_names);
+            test(test_fresh_registry);
+            test(test_stats);
+            test(test_object_pool);
+        } end_test()
+    }
+}
+
+#endif //REGISTRY_TESTS_H